@@ -37,6 +37,7 @@
 #include "fileproperty_p.h"
 #include <qqmlcontext.h>
 #include <qqmlfile.h>
+#include <QtCore/qset.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -144,35 +145,123 @@ void QQuickFolderListModelPrivate::_q_directoryChanged(const QString &directory,
 }
 
 
+static inline QString fileKey(const FileProperty &property)
+{
+    // A file and a directory may briefly share a name while one replaces the other.
+    return property.isDir() ? property.fileName() + QLatin1Char('/') : property.fileName();
+}
+
 void QQuickFolderListModelPrivate::_q_directoryUpdated(const QString &directory, const QList<FileProperty> &list, int fromIndex, int toIndex)
 {
     Q_Q(QQuickFolderListModel);
     Q_UNUSED(directory);
+    Q_UNUSED(fromIndex);
+    Q_UNUSED(toIndex);
 
     QModelIndex parent;
-    if (data.size() == list.size()) {
-        QModelIndex modelIndexFrom = q->createIndex(fromIndex, 0);
-        QModelIndex modelIndexTo = q->createIndex(toIndex, 0);
-        data = list;
-        emit q->dataChanged(modelIndexFrom, modelIndexTo);
-    } else {
-        // File(s) inserted or removed. Since I do not know how many
-        // or where, I need to update the whole list from the first item.
-        // This is a little pessimistic, but optimizing it would require
-        // more information in the signal from FileInfoThread.
-        if (data.size() > 0) {
-            q->beginRemoveRows(parent, 0, data.size() - 1);
-            q->endRemoveRows();
+    const int oldCount = data.size();
+    const int newCount = list.size();
+
+    // Skip the entries that are unchanged at either end of the list, so that
+    // a single file appearing or disappearing only touches the rows around it.
+    int start = 0;
+    const int commonCount = qMin(oldCount, newCount);
+    while (start < commonCount && data.at(start) == list.at(start))
+        ++start;
+    int oldEnd = oldCount;
+    int newEnd = newCount;
+    while (oldEnd > start && newEnd > start && data.at(oldEnd - 1) == list.at(newEnd - 1)) {
+        --oldEnd;
+        --newEnd;
+    }
+
+    if (start < oldEnd || start < newEnd) {
+        QSet<QString> oldKeys;
+        QSet<QString> newKeys;
+        oldKeys.reserve(oldEnd - start);
+        newKeys.reserve(newEnd - start);
+        for (int i = start; i < oldEnd; ++i)
+            oldKeys.insert(fileKey(data.at(i)));
+        for (int i = start; i < newEnd; ++i)
+            newKeys.insert(fileKey(list.at(i)));
+
+        // The entries present in both lists must keep their relative order for
+        // the change to be expressed as removals followed by insertions. This
+        // is not the case if e.g. a modified file moves when sorting by time.
+        bool ordered = true;
+        for (int i = start, j = start; ordered; ++i, ++j) {
+            while (i < oldEnd && !newKeys.contains(fileKey(data.at(i))))
+                ++i;
+            while (j < newEnd && !oldKeys.contains(fileKey(list.at(j))))
+                ++j;
+            if (i == oldEnd || j == newEnd)
+                ordered = i == oldEnd && j == newEnd;
+            else
+                ordered = data.at(i) == list.at(j);
+            if (i == oldEnd)
+                break;
         }
-        data = list;
-        if (list.size() > 0) {
-            if (toIndex > list.size() - 1)
-                toIndex = list.size() - 1;
-            q->beginInsertRows(parent, 0, data.size() - 1);
-            q->endInsertRows();
+
+        if (ordered) {
+            // Remove from the back so the indexes of the pending runs stay valid.
+            for (int i = oldEnd - 1; i >= start; --i) {
+                if (newKeys.contains(fileKey(data.at(i))))
+                    continue;
+                const int last = i;
+                while (i > start && !newKeys.contains(fileKey(data.at(i - 1))))
+                    --i;
+                q->beginRemoveRows(parent, i, last);
+                data.erase(data.begin() + i, data.begin() + last + 1);
+                q->endRemoveRows();
+            }
+            // The remaining entries are now in their final positions relative
+            // to each other, so new entries go in at their index in the list.
+            for (int j = start; j < newEnd; ++j) {
+                if (oldKeys.contains(fileKey(list.at(j))))
+                    continue;
+                const int first = j;
+                while (j + 1 < newEnd && !oldKeys.contains(fileKey(list.at(j + 1))))
+                    ++j;
+                q->beginInsertRows(parent, first, j);
+                for (int k = first; k <= j; ++k)
+                    data.insert(k, list.at(k));
+                q->endInsertRows();
+            }
+        } else {
+            if (oldEnd > start) {
+                q->beginRemoveRows(parent, start, oldEnd - 1);
+                data.erase(data.begin() + start, data.begin() + oldEnd);
+                q->endRemoveRows();
+            }
+            if (newEnd > start) {
+                q->beginInsertRows(parent, start, newEnd - 1);
+                for (int k = start; k < newEnd; ++k)
+                    data.insert(k, list.at(k));
+                q->endInsertRows();
+            }
+        }
+    }
+    Q_ASSERT(data.size() == newCount);
+
+    // Entries that stayed in place may still have been modified.
+    int firstChanged = -1;
+    int lastChanged = -1;
+    for (int i = 0; i < newCount; ++i) {
+        const FileProperty &oldProperty = data.at(i);
+        const FileProperty &newProperty = list.at(i);
+        if (oldProperty.size() != newProperty.size()
+                || oldProperty.lastModified() != newProperty.lastModified()) {
+            if (firstChanged < 0)
+                firstChanged = i;
+            lastChanged = i;
         }
-        emit q->rowCountChanged();
     }
+    data = list;
+    if (firstChanged >= 0)
+        emit q->dataChanged(q->createIndex(firstChanged, 0), q->createIndex(lastChanged, 0));
+
+    if (oldCount != newCount)
+        emit q->rowCountChanged();
 }
 
 void QQuickFolderListModelPrivate::_q_sortFinished(const QList<FileProperty> &list)
@@ -43,6 +43,7 @@
 #include <QtSql/qsqlfield.h>
 #include <QtCore/qstandardpaths.h>
 #include <QtCore/qstack.h>
+#include <QtCore/qcache.h>
 #include <QtCore/qcryptographichash.h>
 #include <QtCore/qsettings.h>
 #include <QtCore/qdir.h>
@@ -88,6 +89,16 @@ public:
     QV4::PersistentValue databaseProto;
     QV4::PersistentValue queryProto;
     QV4::PersistentValue rowsProto;
+
+    // Prepared statements that do not produce a result set are kept around,
+    // so that executing the same statement again does not re-parse the SQL.
+    enum { StatementCacheSize = 32 };
+    struct CachedStatement {
+        QSqlQuery query;
+        QString bindings; // see qmlsqldatabase_bindValues()
+    };
+    typedef QPair<QString, QString> StatementKey; // connection name, statement
+    QCache<StatementKey, CachedStatement> statementCache;
 };
 
 V4_DEFINE_EXTENSION(QQmlSqlDatabaseData, databaseData)
@@ -266,15 +277,126 @@ static QVariant toSqlVariant(QV4::ExecutionEngine *engine, const QV4::ScopedValu
     return engine->toVariant(value, /*typehint*/-1);
 }
 
-static ReturnedValue qmlsqldatabase_executeSql(CallContext *ctx)
+// Binds values to query and returns how they were bound: the number of
+// positional values, or the names and positions of the values of an object.
+static QString qmlsqldatabase_bindValues(Scope &scope, QSqlQuery &query, const Value &value)
+{
+    ScopedValue values(scope, value);
+    QString bindings;
+    if (values->as<ArrayObject>()) {
+        ScopedArrayObject array(scope, values);
+        quint32 size = array->getLength();
+        QV4::ScopedValue v(scope);
+        for (quint32 ii = 0; ii < size; ++ii)
+            query.bindValue(ii, toSqlVariant(scope.engine, (v = array->getIndexed(ii))));
+        bindings = QString::number(size);
+    } else if (values->as<Object>()) {
+        ScopedObject object(scope, values);
+        ObjectIterator it(scope, object, ObjectIterator::WithProtoChain|ObjectIterator::EnumerableOnly);
+        ScopedValue key(scope);
+        QV4::ScopedValue val(scope);
+        while (1) {
+            key = it.nextPropertyName(val);
+            if (key->isNull())
+                break;
+            QVariant v = toSqlVariant(scope.engine, val);
+            if (key->isString()) {
+                const QString name = key->stringValue()->toQString();
+                query.bindValue(name, v);
+                bindings += name;
+            } else {
+                Q_ASSERT(key->isInteger());
+                query.bindValue(key->integerValue(), v);
+                bindings += QString::number(key->integerValue());
+            }
+            bindings += QLatin1Char(',');
+        }
+    } else {
+        query.bindValue(0, toSqlVariant(scope.engine, values));
+        bindings = QString::number(1);
+    }
+    return bindings;
+}
+
+// Binds values (if any) to query, after preparing it from sql unless
+// *prepared is set. A prepared statement is only reused when its values are
+// bound the same way as in its last execution, *bindings. Otherwise values
+// bound by that execution under other names or positions would silently be
+// reused.
+static bool qmlsqldatabase_bind(Scope &scope, const QSqlDatabase &db, const QString &sql,
+                                const Value *values, QSqlQuery &query, bool *prepared, QString *bindings)
+{
+    if (*prepared) {
+        const QString b = values ? qmlsqldatabase_bindValues(scope, query, *values) : QString();
+        if (b == *bindings)
+            return true;
+        // Prepare the statement again to get the usual error for missing values.
+    }
+    query = QSqlQuery(db);
+    *prepared = query.prepare(sql);
+    if (!*prepared)
+        return false;
+    *bindings = values ? qmlsqldatabase_bindValues(scope, query, *values) : QString();
+    return true;
+}
+
+static QSqlQuery qmlsqldatabase_takeStatement(ExecutionEngine *engine, const QSqlDatabase &db, const QString &sql,
+                                              bool *prepared, QString *bindings)
+{
+    QSqlQuery query;
+    *prepared = false;
+    QQmlSqlDatabaseData::CachedStatement *cached
+            = databaseData(engine)->statementCache.take(QQmlSqlDatabaseData::StatementKey(db.connectionName(), sql));
+    if (cached) {
+        query = cached->query;
+        *prepared = true;
+        *bindings = cached->bindings;
+        delete cached;
+    }
+    return query;
+}
+
+static void qmlsqldatabase_cacheStatement(ExecutionEngine *engine, const QSqlDatabase &db, const QString &sql,
+                                          QSqlQuery &query, const QString &bindings)
+{
+    // Release the statement (and any locks it holds) while keeping it prepared.
+    query.finish();
+    QQmlSqlDatabaseData::CachedStatement *cached = new QQmlSqlDatabaseData::CachedStatement;
+    cached->query = query;
+    cached->bindings = bindings;
+    databaseData(engine)->statementCache.insert(QQmlSqlDatabaseData::StatementKey(db.connectionName(), sql), cached);
+}
+
+static ReturnedValue qmlsqldatabase_result(Scope &scope, const QSqlDatabase &db, const QSqlQuery &query, int rowsAffected, const QVariant &insertId)
+{
+    QV4::Scoped<QQmlSqlDatabaseWrapper> rows(scope, QQmlSqlDatabaseWrapper::create(scope.engine));
+    QV4::ScopedObject p(scope, databaseData(scope.engine)->rowsProto.value());
+    rows->setPrototype(p.getPointer());
+    rows->d()->type = Heap::QQmlSqlDatabaseWrapper::Rows;
+    rows->d()->database = db;
+    rows->d()->sqlQuery = query;
+
+    ScopedObject resultObject(scope, scope.engine->newObject());
+    // XXX optimize
+    ScopedString s(scope);
+    ScopedValue v(scope);
+    resultObject->put((s = scope.engine->newIdentifier("rowsAffected")).getPointer(), (v = Primitive::fromInt32(rowsAffected)));
+    resultObject->put((s = scope.engine->newIdentifier("insertId")).getPointer(), (v = scope.engine->newString(insertId.toString())));
+    resultObject->put((s = scope.engine->newIdentifier("rows")).getPointer(), rows);
+    return resultObject.asReturnedValue();
+}
+
+static ReturnedValue qmlsqldatabase_executeSql_shared(CallContext *ctx, bool batch)
 {
     QV4::Scope scope(ctx);
     QV4::Scoped<QQmlSqlDatabaseWrapper> r(scope, ctx->thisObject().as<QQmlSqlDatabaseWrapper>());
     if (!r || r->d()->type != Heap::QQmlSqlDatabaseWrapper::Query)
         V4THROW_REFERENCE("Not a SQLDatabase::Query object");
 
-    if (!r->d()->inTransaction)
-        V4THROW_SQL(SQLEXCEPTION_DATABASE_ERR,QQmlEngine::tr("executeSql called outside transaction()"));
+    if (!r->d()->inTransaction) {
+        V4THROW_SQL(SQLEXCEPTION_DATABASE_ERR, batch ? QQmlEngine::tr("executeSqlBatch called outside transaction()")
+                                                     : QQmlEngine::tr("executeSql called outside transaction()"));
+    }
 
     QSqlDatabase db = r->d()->database;
 
@@ -284,70 +406,56 @@ static ReturnedValue qmlsqldatabase_executeSql(CallContext *ctx)
         V4THROW_SQL(SQLEXCEPTION_SYNTAX_ERR, QQmlEngine::tr("Read-only Transaction"));
     }
 
-    QSqlQuery query(db);
-    bool err = false;
+    ScopedArrayObject array(scope, ctx->argument(1));
+    if (batch && !array)
+        V4THROW_SQL(SQLEXCEPTION_UNKNOWN_ERR, QQmlEngine::tr("executeSqlBatch: values must be an array"));
 
-    ScopedValue result(scope, Primitive::undefinedValue());
+    bool prepared;
+    QString bindings;
+    QSqlQuery query = qmlsqldatabase_takeStatement(scope.engine, db, sql, &prepared, &bindings);
 
-    if (query.prepare(sql)) {
-        if (ctx->argc() > 1) {
-            ScopedValue values(scope, ctx->args()[1]);
-            if (values->as<ArrayObject>()) {
-                ScopedArrayObject array(scope, values);
-                quint32 size = array->getLength();
-                QV4::ScopedValue v(scope);
-                for (quint32 ii = 0; ii < size; ++ii) {
-                    query.bindValue(ii, toSqlVariant(scope.engine, (v = array->getIndexed(ii))));
-                }
-            } else if (values->as<Object>()) {
-                ScopedObject object(scope, values);
-                ObjectIterator it(scope, object, ObjectIterator::WithProtoChain|ObjectIterator::EnumerableOnly);
-                ScopedValue key(scope);
-                QV4::ScopedValue val(scope);
-                while (1) {
-                    key = it.nextPropertyName(val);
-                    if (key->isNull())
-                        break;
-                    QVariant v = toSqlVariant(scope.engine, val);
-                    if (key->isString()) {
-                        query.bindValue(key->stringValue()->toQString(), v);
-                    } else {
-                        Q_ASSERT(key->isInteger());
-                        query.bindValue(key->integerValue(), v);
-                    }
-                }
-            } else {
-                query.bindValue(0, toSqlVariant(scope.engine, values));
-            }
-        }
-        if (query.exec()) {
-            QV4::Scoped<QQmlSqlDatabaseWrapper> rows(scope, QQmlSqlDatabaseWrapper::create(scope.engine));
-            QV4::ScopedObject p(scope, databaseData(scope.engine)->rowsProto.value());
-            rows->setPrototype(p.getPointer());
-            rows->d()->type = Heap::QQmlSqlDatabaseWrapper::Rows;
-            rows->d()->database = db;
-            rows->d()->sqlQuery = query;
-
-            ScopedObject resultObject(scope, scope.engine->newObject());
-            result = resultObject.asReturnedValue();
-            // XXX optimize
-            ScopedString s(scope);
-            ScopedValue v(scope);
-            resultObject->put((s = scope.engine->newIdentifier("rowsAffected")).getPointer(), (v = Primitive::fromInt32(query.numRowsAffected())));
-            resultObject->put((s = scope.engine->newIdentifier("insertId")).getPointer(), (v = scope.engine->newString(query.lastInsertId().toString())));
-            resultObject->put((s = scope.engine->newIdentifier("rows")).getPointer(), rows);
-        } else {
-            err = true;
-        }
-    } else {
-        err = true;
+    if (!batch) {
+        const Value *values = ctx->argc() > 1 ? &ctx->args()[1] : 0;
+        if (!qmlsqldatabase_bind(scope, db, sql, values, query, &prepared, &bindings) || !query.exec())
+            V4THROW_SQL(SQLEXCEPTION_DATABASE_ERR,query.lastError().text());
+
+        if (query.isSelect())
+            return qmlsqldatabase_result(scope, db, query, query.numRowsAffected(), query.lastInsertId());
+
+        ScopedValue result(scope, qmlsqldatabase_result(scope, db, QSqlQuery(), query.numRowsAffected(), query.lastInsertId()));
+        qmlsqldatabase_cacheStatement(scope.engine, db, sql, query, bindings);
+        return result->asReturnedValue();
+    }
+
+    int rowsAffected = 0;
+    QVariant insertId;
+    const quint32 size = array->getLength();
+    ScopedValue values(scope);
+    for (quint32 ii = 0; ii < size; ++ii) {
+        values = array->getIndexed(ii);
+        if (!qmlsqldatabase_bind(scope, db, sql, values, query, &prepared, &bindings) || !query.exec())
+            V4THROW_SQL(SQLEXCEPTION_DATABASE_ERR,query.lastError().text());
+        if (query.numRowsAffected() > 0)
+            rowsAffected += query.numRowsAffected();
+        insertId = query.lastInsertId();
     }
-    if (err)
-        V4THROW_SQL(SQLEXCEPTION_DATABASE_ERR,query.lastError().text());
 
+    ScopedValue result(scope, qmlsqldatabase_result(scope, db, QSqlQuery(), rowsAffected, insertId));
+    if (prepared)
+        qmlsqldatabase_cacheStatement(scope.engine, db, sql, query, bindings);
     return result->asReturnedValue();
 }
 
+static ReturnedValue qmlsqldatabase_executeSql(CallContext *ctx)
+{
+    return qmlsqldatabase_executeSql_shared(ctx, false);
+}
+
+static ReturnedValue qmlsqldatabase_executeSqlBatch(CallContext *ctx)
+{
+    return qmlsqldatabase_executeSql_shared(ctx, true);
+}
+
 struct TransactionRollback {
     QSqlDatabase *db;
     bool *inTransactionFlag;
@@ -482,6 +590,7 @@ static ReturnedValue qmlsqldatabase_read_transaction(CallContext *ctx)
 }
 
 QQmlSqlDatabaseData::QQmlSqlDatabaseData(ExecutionEngine *v4)
+    : statementCache(StatementCacheSize)
 {
     Scope scope(v4);
     {
@@ -496,6 +605,7 @@ QQmlSqlDatabaseData::QQmlSqlDatabaseData(ExecutionEngine *v4)
     {
         ScopedObject proto(scope, v4->newObject());
         proto->defineDefaultProperty(QStringLiteral("executeSql"), qmlsqldatabase_executeSql);
+        proto->defineDefaultProperty(QStringLiteral("executeSqlBatch"), qmlsqldatabase_executeSqlBatch);
         queryProto = proto;
     }
     {
@@ -630,6 +740,26 @@ It returns a results object, with the following properties:
 
 May throw exception with code property SQLException.DATABASE_ERR, SQLException.SYNTAX_ERR, or SQLException.UNKNOWN_ERR.
 
+\section3 results = tx.executeSqlBatch(statement, values)
+
+This method executes a SQL \e statement once for each element of the array \e values,
+binding the element to the SQL parameters as \e executeSql does. The statement is only
+prepared once, which makes this the fastest way to insert many rows:
+
+\code
+tx.executeSqlBatch('INSERT INTO Greeting VALUES(?, ?)', [ [ 'hello', 'world' ], [ 'hi', 'there' ] ]);
+\endcode
+
+It returns a results object like \e executeSql, where \c rowsAffected is the total number of
+rows affected by all executions, \c insertId is the id of the last row inserted, and \c rows
+is always empty.
+
+If one of the executions fails an exception is thrown, so the enclosing transaction is rolled back.
+
+May throw exception with code property SQLException.DATABASE_ERR, SQLException.SYNTAX_ERR, or SQLException.UNKNOWN_ERR.
+
+This method was introduced in Qt 5.6.
+
 
 \section1 Method Documentation
 
@@ -47,6 +47,8 @@
 #include <QXmlQuery>
 #include <QXmlResultItems>
 #include <QXmlNodeModelIndex>
+#include <QXmlStreamReader>
+#include <qnumeric.h>
 #include <QBuffer>
 #include <QNetworkRequest>
 #include <QNetworkReply>
@@ -157,6 +159,7 @@ struct XmlQueryJob
     QStringList roleQueries;
     QList<void*> roleQueryErrorId; // the ptr to send back if there is an error
     QStringList keyRoleQueries;
+    QList<int> keyRoleIndexes;
     QStringList keyRoleResultsCache;
     QString prefix;
 };
@@ -200,9 +203,11 @@ protected:
 
 private:
     void processQuery(XmlQueryJob *job);
+    bool doStreamQueryJob(XmlQueryJob *job, QQuickXmlQueryResult *currentResult);
     void doQueryJob(XmlQueryJob *job, QQuickXmlQueryResult *currentResult);
     void doSubQueryJob(XmlQueryJob *job, QQuickXmlQueryResult *currentResult);
     void getValuesOfKeyRoles(const XmlQueryJob& currentJob, QStringList *values, QXmlQuery *query) const;
+    void diffKeyRoleResults(const XmlQueryJob &currentJob, const QStringList &keyRoleResults, QQuickXmlQueryResult *currentResult) const;
     void addIndexToRangeList(QList<QQuickXmlListRange> *ranges, int index) const;
 
     QMutex m_mutex;
@@ -275,7 +280,7 @@ int QQuickXmlQueryEngine::doQuery(QString query, QString namespaces, QByteArray
     XmlQueryJob job;
     job.queryId = m_queryIds.load();
     job.data = data;
-    job.query = QLatin1String("doc($src)") + query;
+    job.query = query;
     job.namespaces = namespaces;
     job.keyRoleResultsCache = keyRoleResultsCache;
 
@@ -286,8 +291,10 @@ int QQuickXmlQueryEngine::doQuery(QString query, QString namespaces, QByteArray
         }
         job.roleQueries << roleObjects->at(i)->query();
         job.roleQueryErrorId << static_cast<void*>(roleObjects->at(i));
-        if (roleObjects->at(i)->isKey())
+        if (roleObjects->at(i)->isKey()) {
             job.keyRoleQueries << job.roleQueries.last();
+            job.keyRoleIndexes << i;
+        }
     }
 
     {
@@ -358,8 +365,10 @@ void QQuickXmlQueryEngine::processQuery(XmlQueryJob *job)
 {
     QQuickXmlQueryResult result;
     result.queryId = job->queryId;
-    doQueryJob(job, &result);
-    doSubQueryJob(job, &result);
+    if (!doStreamQueryJob(job, &result)) {
+        doQueryJob(job, &result);
+        doSubQueryJob(job, &result);
+    }
 
     {
         QMutexLocker ml(&m_mutex);
@@ -371,6 +380,293 @@ void QQuickXmlQueryEngine::processQuery(XmlQueryJob *job)
     }
 }
 
+namespace {
+
+/*
+    The subset of XPath evaluated by streaming the document: paths of element names without
+    a namespace, optionally with a positional predicate, e.g. "/rss/channel/item" or "/a/b[2]"
+    for the query, and the same relative to an item followed by an optional attribute and
+    string() or number() for roles, e.g. "title/string()", "@id/string()" or
+    "a/b[1]/@x/number()".
+*/
+
+struct XmlStreamStep
+{
+    XmlStreamStep() : position(0) {}
+
+    QString name;
+    int position;   // 1 based position among the siblings with the same name, 0 for any
+
+    bool matches(const QStringRef &elementName, int elementPosition) const
+    {
+        return elementName == name && (position == 0 || position == elementPosition);
+    }
+};
+
+struct XmlStreamRole
+{
+    XmlStreamRole() : isValid(false), isNumber(false), matchedDepth(0), collectDepth(-1), found(false) {}
+
+    QList<XmlStreamStep> steps;
+    QString attribute;
+    bool isValid;
+    bool isNumber;
+
+    // The evaluation state for the current item.
+    int matchedDepth;
+    int collectDepth;
+    bool found;
+    QString value;
+
+    QVariant result() const
+    {
+        // As with QXmlQuery the value of an unmatched role is an empty string.
+        if (!isValid)
+            return QVariant();
+        if (!found || (!isNumber && value.isEmpty()))
+            return QString(QLatin1String(""));
+        if (!isNumber)
+            return value;
+        bool ok = false;
+        const double number = value.toDouble(&ok);
+        return ok ? number : qQNaN();
+    }
+};
+
+struct XmlStreamElement
+{
+    QHash<QString, int> childCounts;
+};
+
+static bool isXmlStreamName(const QString &name)
+{
+    if (name.isEmpty() || name.at(0).isDigit() || name.at(0) == QLatin1Char('-') || name.at(0) == QLatin1Char('.'))
+        return false;
+    for (int i = 0; i < name.length(); ++i) {
+        const QChar c = name.at(i);
+        if (!c.isLetterOrNumber() && c != QLatin1Char('_') && c != QLatin1Char('-') && c != QLatin1Char('.'))
+            return false;
+    }
+    return true;
+}
+
+static bool parseXmlStreamStep(const QString &text, XmlStreamStep *step)
+{
+    QString name = text;
+    const int bracket = text.indexOf(QLatin1Char('['));
+    if (bracket != -1) {
+        if (!text.endsWith(QLatin1Char(']')))
+            return false;
+        bool ok = false;
+        step->position = text.mid(bracket + 1, text.length() - bracket - 2).toInt(&ok);
+        if (!ok || step->position < 1)
+            return false;
+        name = text.left(bracket);
+    }
+    step->name = name;
+    return isXmlStreamName(name);
+}
+
+static bool parseXmlStreamQuery(const QString &query, QList<XmlStreamStep> *steps)
+{
+    const QString path = query.trimmed();
+    if (!path.startsWith(QLatin1Char('/')))
+        return false;
+    const QStringList parts = path.mid(1).split(QLatin1Char('/'));
+    for (int i = 0; i < parts.count(); ++i) {
+        XmlStreamStep step;
+        if (!parseXmlStreamStep(parts.at(i), &step))
+            return false;
+        steps->append(step);
+    }
+    return true;
+}
+
+static bool parseXmlStreamRole(const QString &query, XmlStreamRole *role)
+{
+    QStringList parts = query.trimmed().split(QLatin1Char('/'));
+    const QString function = parts.takeLast();
+    if (function == QLatin1String("number()"))
+        role->isNumber = true;
+    else if (function != QLatin1String("string()"))
+        return false;
+
+    if (!parts.isEmpty() && parts.last().startsWith(QLatin1Char('@'))) {
+        role->attribute = parts.takeLast().mid(1);
+        if (!isXmlStreamName(role->attribute))
+            return false;
+    }
+    for (int i = 0; i < parts.count(); ++i) {
+        XmlStreamStep step;
+        if (!parseXmlStreamStep(parts.at(i), &step))
+            return false;
+        role->steps.append(step);
+    }
+    role->isValid = true;
+    return true;
+}
+
+// Returns false if the role matches more than once within an item.
+static bool matchXmlStreamRole(XmlStreamRole *role, const QXmlStreamReader &reader, int depth)
+{
+    if (role->attribute.isEmpty()) {
+        if (role->found)
+            return false;
+        role->found = true;
+        role->collectDepth = depth;
+    } else if (reader.attributes().hasAttribute(QString(), role->attribute)) {
+        if (role->found)
+            return false;
+        role->found = true;
+        role->value = reader.attributes().value(QString(), role->attribute).toString();
+    }
+    return true;
+}
+
+}
+
+/*
+    Evaluates a job with a single pass over the document using QXmlStreamReader, which is
+    much faster and uses much less memory than building the document with QXmlQuery for the
+    query and then again for each role.
+
+    Returns false without producing a result if the query, the roles or the document use
+    anything beyond the supported subset, in which case the job is evaluated with QXmlQuery.
+*/
+
+bool QQuickXmlQueryEngine::doStreamQueryJob(XmlQueryJob *currentJob, QQuickXmlQueryResult *currentResult)
+{
+    Q_ASSERT(currentJob->queryId != -1);
+
+    if (!currentJob->namespaces.trimmed().isEmpty())
+        return false;
+
+    QList<XmlStreamStep> itemPath;
+    if (!parseXmlStreamQuery(currentJob->query, &itemPath))
+        return false;
+
+    const int roleCount = currentJob->roleQueries.count();
+    QVector<XmlStreamRole> roles(roleCount);
+    for (int i = 0; i < roleCount; ++i) {
+        if (!currentJob->roleQueries.at(i).isEmpty() && !parseXmlStreamRole(currentJob->roleQueries.at(i), &roles[i]))
+            return false;
+    }
+
+    QList<QList<QVariant> > data;
+    for (int i = 0; i < roleCount; ++i)
+        data.append(QList<QVariant>());
+    QStringList keyRoleResults;
+    int size = 0;
+
+    QVector<XmlStreamElement> elements;
+    elements.append(XmlStreamElement());
+    int itemMatchedDepth = 0;
+    int itemDepth = -1;
+
+    QXmlStreamReader reader(currentJob->data);
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement: {
+            const int depth = elements.count();
+            if (!reader.namespaceUri().isEmpty()) {
+                elements.append(XmlStreamElement());
+                break;
+            }
+            const QStringRef name = reader.name();
+            const int position = ++elements.last().childCounts[name.toString()];
+            elements.append(XmlStreamElement());
+
+            if (itemDepth == -1) {
+                if (itemMatchedDepth == depth - 1
+                        && depth <= itemPath.count()
+                        && itemPath.at(depth - 1).matches(name, position)) {
+                    itemMatchedDepth = depth;
+                    if (depth == itemPath.count()) {
+                        itemDepth = depth;
+                        for (int i = 0; i < roleCount; ++i) {
+                            XmlStreamRole &role = roles[i];
+                            role.matchedDepth = 0;
+                            role.collectDepth = -1;
+                            role.found = false;
+                            role.value.clear();
+                            if (role.isValid && role.steps.isEmpty())
+                                matchXmlStreamRole(&role, reader, depth);
+                        }
+                    }
+                }
+            } else {
+                const int relativeDepth = depth - itemDepth;
+                for (int i = 0; i < roleCount; ++i) {
+                    XmlStreamRole &role = roles[i];
+                    if (role.isValid
+                            && role.matchedDepth == relativeDepth - 1
+                            && relativeDepth <= role.steps.count()
+                            && role.steps.at(relativeDepth - 1).matches(name, position)) {
+                        role.matchedDepth = relativeDepth;
+                        if (relativeDepth == role.steps.count() && !matchXmlStreamRole(&role, reader, depth))
+                            return false;
+                    }
+                }
+            }
+            break;
+        }
+        case QXmlStreamReader::EndElement: {
+            const int depth = elements.count() - 1;
+            elements.removeLast();
+            if (itemDepth == -1) {
+                if (itemMatchedDepth == depth)
+                    itemMatchedDepth = depth - 1;
+                break;
+            }
+
+            const int relativeDepth = depth - itemDepth;
+            for (int i = 0; i < roleCount; ++i) {
+                XmlStreamRole &role = roles[i];
+                if (role.collectDepth == depth)
+                    role.collectDepth = -1;
+                if (role.matchedDepth == relativeDepth && relativeDepth > 0)
+                    role.matchedDepth = relativeDepth - 1;
+            }
+
+            if (depth == itemDepth) {
+                QString key;
+                for (int i = 0; i < roleCount; ++i)
+                    data[i].append(roles.at(i).result());
+                for (int i = 0; i < currentJob->keyRoleIndexes.count(); ++i)
+                    key += data.at(currentJob->keyRoleIndexes.at(i)).last().toString();
+                if (!currentJob->keyRoleIndexes.isEmpty())
+                    keyRoleResults.append(key);
+                ++size;
+                itemDepth = -1;
+                itemMatchedDepth = depth - 1;
+            }
+            break;
+        }
+        case QXmlStreamReader::Characters:
+            if (itemDepth != -1) {
+                for (int i = 0; i < roleCount; ++i) {
+                    if (roles.at(i).collectDepth != -1)
+                        roles[i].value += reader.text();
+                }
+            }
+            break;
+        case QXmlStreamReader::EntityReference:
+            // Undeclared entities can't be resolved without the DTD.
+            return false;
+        default:
+            break;
+        }
+    }
+
+    if (reader.hasError())
+        return false;
+
+    currentResult->size = size;
+    currentResult->data = data;
+    diffKeyRoleResults(*currentJob, keyRoleResults, currentResult);
+    return true;
+}
+
 void QQuickXmlQueryEngine::doQueryJob(XmlQueryJob *currentJob, QQuickXmlQueryResult *currentResult)
 {
     Q_ASSERT(currentJob->queryId != -1);
@@ -380,7 +676,7 @@ void QQuickXmlQueryEngine::doQueryJob(XmlQueryJob *currentJob, QQuickXmlQueryRes
     QBuffer buffer(&currentJob->data);
     buffer.open(QIODevice::ReadOnly);
     query.bindVariable(QLatin1String("src"), &buffer);
-    query.setQuery(currentJob->namespaces + currentJob->query);
+    query.setQuery(currentJob->namespaces + QLatin1String("doc($src)") + currentJob->query);
     query.evaluateTo(&r);
 
     //always need a single root element
@@ -439,31 +735,21 @@ void QQuickXmlQueryEngine::addIndexToRangeList(QList<QQuickXmlListRange> *ranges
         ranges->append(qMakePair(index, 1));
 }
 
-void QQuickXmlQueryEngine::doSubQueryJob(XmlQueryJob *currentJob, QQuickXmlQueryResult *currentResult)
+void QQuickXmlQueryEngine::diffKeyRoleResults(const XmlQueryJob &currentJob, const QStringList &keyRoleResults, QQuickXmlQueryResult *currentResult) const
 {
-    Q_ASSERT(currentJob->queryId != -1);
-
-    QBuffer b(&currentJob->data);
-    b.open(QIODevice::ReadOnly);
-
-    QXmlQuery subquery;
-    subquery.bindVariable(QLatin1String("inputDocument"), &b);
-
-    QStringList keyRoleResults;
-    getValuesOfKeyRoles(*currentJob, &keyRoleResults, &subquery);
-
     // See if any values of key roles have been inserted or removed.
 
-    if (currentJob->keyRoleResultsCache.isEmpty()) {
+    if (currentJob.keyRoleResultsCache.isEmpty()) {
         currentResult->inserted << qMakePair(0, currentResult->size);
     } else {
-        if (keyRoleResults != currentJob->keyRoleResultsCache) {
+        if (keyRoleResults != currentJob.keyRoleResultsCache) {
+            const QSet<QString> keyRoleResultSet = keyRoleResults.toSet();
             QStringList temp;
-            for (int i=0; i<currentJob->keyRoleResultsCache.count(); i++) {
-                if (!keyRoleResults.contains(currentJob->keyRoleResultsCache[i]))
+            for (int i=0; i<currentJob.keyRoleResultsCache.count(); i++) {
+                if (!keyRoleResultSet.contains(currentJob.keyRoleResultsCache[i]))
                     addIndexToRangeList(&currentResult->removed, i);
                 else
-                    temp << currentJob->keyRoleResultsCache[i];
+                    temp << currentJob.keyRoleResultsCache[i];
             }
             for (int i=0; i<keyRoleResults.count(); i++) {
                 if (temp.count() == i || keyRoleResults[i] != temp[i]) {
@@ -474,6 +760,21 @@ void QQuickXmlQueryEngine::doSubQueryJob(XmlQueryJob *currentJob, QQuickXmlQuery
         }
     }
     currentResult->keyRoleResultsCache = keyRoleResults;
+}
+
+void QQuickXmlQueryEngine::doSubQueryJob(XmlQueryJob *currentJob, QQuickXmlQueryResult *currentResult)
+{
+    Q_ASSERT(currentJob->queryId != -1);
+
+    QBuffer b(&currentJob->data);
+    b.open(QIODevice::ReadOnly);
+
+    QXmlQuery subquery;
+    subquery.bindVariable(QLatin1String("inputDocument"), &b);
+
+    QStringList keyRoleResults;
+    getValuesOfKeyRoles(*currentJob, &keyRoleResults, &subquery);
+    diffKeyRoleResults(*currentJob, keyRoleResults, currentResult);
 
     // Get the new values for each role.
     //### we might be able to condense even further (query for everything in one go)
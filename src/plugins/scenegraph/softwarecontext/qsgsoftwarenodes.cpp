@@ -0,0 +1,493 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgsoftwarenodes.h"
+
+#include <QtGui/qpainter.h>
+#include <QtCore/qmath.h>
+
+QT_BEGIN_NAMESPACE
+
+QSGSoftwareRectangleNode::QSGSoftwareRectangleNode()
+    : m_penWidth(0)
+    , m_radius(0)
+    , m_antialiasing(false)
+    , m_aligned(true)
+{
+}
+
+void QSGSoftwareRectangleNode::setRect(const QRectF &rect)
+{
+    m_rect = rect;
+}
+
+void QSGSoftwareRectangleNode::setColor(const QColor &color)
+{
+    m_color = color;
+}
+
+void QSGSoftwareRectangleNode::setPenColor(const QColor &color)
+{
+    m_penColor = color;
+}
+
+void QSGSoftwareRectangleNode::setPenWidth(qreal width)
+{
+    m_penWidth = width;
+}
+
+void QSGSoftwareRectangleNode::setGradientStops(const QGradientStops &stops)
+{
+    m_stops = stops;
+}
+
+void QSGSoftwareRectangleNode::setRadius(qreal radius)
+{
+    m_radius = radius;
+}
+
+void QSGSoftwareRectangleNode::setAntialiasing(bool antialiasing)
+{
+    m_antialiasing = antialiasing;
+}
+
+void QSGSoftwareRectangleNode::setAligned(bool aligned)
+{
+    m_aligned = aligned;
+}
+
+void QSGSoftwareRectangleNode::update()
+{
+    markDirty(DirtyMaterial);
+}
+
+void QSGSoftwareRectangleNode::paint(QPainter *painter)
+{
+    if (m_rect.isEmpty())
+        return;
+
+    // The border is drawn inside the rectangle, as in QSGDefaultRectangleNode,
+    // so the stroke is centered half a pen width inside the edge.
+    const qreal penWidth = qMin(m_penWidth, qMin(m_rect.width(), m_rect.height()) / 2);
+    const bool hasPen = penWidth > 0 && m_penColor.alpha() > 0;
+    const qreal inset = hasPen ? penWidth / 2 : 0;
+    QRectF r = m_rect.adjusted(inset, inset, -inset, -inset);
+    if (m_aligned && !m_antialiasing)
+        r = QRectF(qRound(r.x()), qRound(r.y()), qRound(r.width()), qRound(r.height()));
+
+    QBrush brush(m_color);
+    if (!m_stops.isEmpty()) {
+        QLinearGradient gradient(m_rect.topLeft(), m_rect.bottomLeft());
+        gradient.setStops(m_stops);
+        brush = QBrush(gradient);
+    } else if (m_color.alpha() == 0) {
+        brush = Qt::NoBrush;
+    }
+
+    if (brush.style() == Qt::NoBrush && !hasPen)
+        return;
+
+    painter->setRenderHint(QPainter::Antialiasing, m_antialiasing || m_radius > 0);
+    painter->setPen(hasPen ? QPen(m_penColor, penWidth, Qt::SolidLine, Qt::SquareCap, Qt::MiterJoin)
+                           : QPen(Qt::NoPen));
+    painter->setBrush(brush);
+
+    const qreal radius = qMin(m_radius, qMin(m_rect.width(), m_rect.height()) / 2) - inset;
+    if (radius > 0)
+        painter->drawRoundedRect(r, radius, radius);
+    else
+        painter->drawRect(r);
+}
+
+QSGSoftwareImageNode::QSGSoftwareImageNode()
+    : m_subSourceRect(0, 0, 1, 1)
+    , m_texture(0)
+    , m_mirror(false)
+    , m_smooth(false)
+{
+}
+
+void QSGSoftwareImageNode::setTargetRect(const QRectF &rect)
+{
+    m_targetRect = rect;
+}
+
+void QSGSoftwareImageNode::setInnerTargetRect(const QRectF &rect)
+{
+    m_innerTargetRect = rect;
+}
+
+void QSGSoftwareImageNode::setInnerSourceRect(const QRectF &rect)
+{
+    m_innerSourceRect = rect;
+}
+
+void QSGSoftwareImageNode::setSubSourceRect(const QRectF &rect)
+{
+    m_subSourceRect = rect;
+}
+
+void QSGSoftwareImageNode::setTexture(QSGTexture *texture)
+{
+    m_texture = texture;
+    markDirty(DirtyMaterial);
+}
+
+void QSGSoftwareImageNode::setMirror(bool mirror)
+{
+    m_mirror = mirror;
+}
+
+void QSGSoftwareImageNode::setMipmapFiltering(QSGTexture::Filtering)
+{
+}
+
+void QSGSoftwareImageNode::setFiltering(QSGTexture::Filtering filtering)
+{
+    m_smooth = filtering == QSGTexture::Linear;
+}
+
+void QSGSoftwareImageNode::setHorizontalWrapMode(QSGTexture::WrapMode)
+{
+}
+
+void QSGSoftwareImageNode::setVerticalWrapMode(QSGTexture::WrapMode)
+{
+}
+
+void QSGSoftwareImageNode::update()
+{
+    markDirty(DirtyMaterial);
+}
+
+/*
+    Draws \a source from \a image into \a target. The sub-source rect tells
+    how many times the source is repeated across the target and where the
+    first repetition starts, mirroring what the texture coordinates and the
+    repeat wrap mode do in QSGDefaultImageNode.
+ */
+static void qsg_drawImageRect(QPainter *painter, const QRectF &target, const QImage &image,
+                              const QRectF &source, const QRectF &subSourceRect)
+{
+    if (target.isEmpty() || source.isEmpty())
+        return;
+
+    if (subSourceRect == QRectF(0, 0, 1, 1)) {
+        painter->drawImage(target, image, source);
+        return;
+    }
+
+    const qreal tileWidth = target.width() / subSourceRect.width();
+    const qreal tileHeight = target.height() / subSourceRect.height();
+    const qreal startX = target.x() - (subSourceRect.x() - qFloor(subSourceRect.x())) * tileWidth;
+    const qreal startY = target.y() - (subSourceRect.y() - qFloor(subSourceRect.y())) * tileHeight;
+
+    painter->save();
+    painter->setClipRect(target, Qt::IntersectClip);
+    for (qreal y = startY; y < target.bottom(); y += tileHeight) {
+        for (qreal x = startX; x < target.right(); x += tileWidth)
+            painter->drawImage(QRectF(x, y, tileWidth, tileHeight), image, source);
+    }
+    painter->restore();
+}
+
+void QSGSoftwareImageNode::paint(QPainter *painter)
+{
+    QSGPlainTexture *texture = qobject_cast<QSGPlainTexture *>(m_texture);
+    if (!texture || texture->image().isNull() || m_targetRect.isEmpty())
+        return;
+
+    const QImage &image = texture->image();
+    const QRectF sourceRect(QPointF(0, 0), image.size());
+    const QRectF innerSourceRect(m_innerSourceRect.x() * image.width(),
+                                 m_innerSourceRect.y() * image.height(),
+                                 m_innerSourceRect.width() * image.width(),
+                                 m_innerSourceRect.height() * image.height());
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, m_smooth);
+    if (m_mirror) {
+        painter->translate(m_targetRect.left() + m_targetRect.right(), 0);
+        painter->scale(-1, 1);
+    }
+
+    if (m_innerTargetRect == m_targetRect && innerSourceRect == sourceRect) {
+        qsg_drawImageRect(painter, m_targetRect, image, sourceRect, m_subSourceRect);
+    } else {
+        // Nine-patch: the corners are drawn as is, the edges and the center
+        // are stretched or repeated according to the sub-source rect.
+        const qreal tx[4] = { m_targetRect.left(), m_innerTargetRect.left(),
+                              m_innerTargetRect.right(), m_targetRect.right() };
+        const qreal ty[4] = { m_targetRect.top(), m_innerTargetRect.top(),
+                              m_innerTargetRect.bottom(), m_targetRect.bottom() };
+        const qreal sx[4] = { 0, innerSourceRect.left(), innerSourceRect.right(), qreal(image.width()) };
+        const qreal sy[4] = { 0, innerSourceRect.top(), innerSourceRect.bottom(), qreal(image.height()) };
+
+        for (int row = 0; row < 3; ++row) {
+            for (int column = 0; column < 3; ++column) {
+                QRectF sub(0, 0, 1, 1);
+                if (column == 1) {
+                    sub.setX(m_subSourceRect.x());
+                    sub.setWidth(m_subSourceRect.width());
+                }
+                if (row == 1) {
+                    sub.setY(m_subSourceRect.y());
+                    sub.setHeight(m_subSourceRect.height());
+                }
+                qsg_drawImageRect(painter,
+                                  QRectF(QPointF(tx[column], ty[row]), QPointF(tx[column + 1], ty[row + 1])),
+                                  image,
+                                  QRectF(QPointF(sx[column], sy[row]), QPointF(sx[column + 1], sy[row + 1])),
+                                  sub);
+            }
+        }
+    }
+    painter->restore();
+}
+
+QSGSoftwarePainterNode::QSGSoftwarePainterNode(QQuickPaintedItem *item)
+    : m_item(item)
+    , m_texture(new QSGPlainTexture)
+    , m_fillColor(Qt::transparent)
+    , m_contentsScale(1)
+    , m_dirtyContents(false)
+    , m_dirtyGeometry(false)
+    , m_opaquePainting(false)
+    , m_linearFiltering(false)
+    , m_smoothPainting(false)
+{
+    m_texture->setOwnsTexture(true);
+}
+
+QSGSoftwarePainterNode::~QSGSoftwarePainterNode()
+{
+    delete m_texture;
+}
+
+void QSGSoftwarePainterNode::setPreferredRenderTarget(QQuickPaintedItem::RenderTarget)
+{
+    // There is no framebuffer object to render into; everything is an image.
+}
+
+void QSGSoftwarePainterNode::setSize(const QSize &size)
+{
+    if (size == m_size)
+        return;
+    m_size = size;
+    m_dirtyGeometry = true;
+}
+
+void QSGSoftwarePainterNode::setDirty(const QRect &dirtyRect)
+{
+    m_dirtyContents = true;
+    m_dirtyRect = dirtyRect;
+    markDirty(DirtyMaterial);
+}
+
+void QSGSoftwarePainterNode::setOpaquePainting(bool opaque)
+{
+    if (opaque == m_opaquePainting)
+        return;
+    m_opaquePainting = opaque;
+    m_dirtyGeometry = true;
+}
+
+void QSGSoftwarePainterNode::setLinearFiltering(bool linearFiltering)
+{
+    m_linearFiltering = linearFiltering;
+}
+
+void QSGSoftwarePainterNode::setMipmapping(bool)
+{
+}
+
+void QSGSoftwarePainterNode::setSmoothPainting(bool s)
+{
+    if (s == m_smoothPainting)
+        return;
+    m_smoothPainting = s;
+    m_dirtyContents = true;
+}
+
+void QSGSoftwarePainterNode::setFillColor(const QColor &c)
+{
+    if (c == m_fillColor)
+        return;
+    m_fillColor = c;
+    m_dirtyContents = true;
+}
+
+void QSGSoftwarePainterNode::setContentsScale(qreal s)
+{
+    if (s == m_contentsScale)
+        return;
+    m_contentsScale = s;
+    m_dirtyContents = true;
+}
+
+void QSGSoftwarePainterNode::setFastFBOResizing(bool)
+{
+}
+
+void QSGSoftwarePainterNode::setTextureSize(const QSize &size)
+{
+    if (size == m_textureSize)
+        return;
+    m_textureSize = size;
+    m_dirtyGeometry = true;
+}
+
+void QSGSoftwarePainterNode::update()
+{
+    if (m_dirtyGeometry) {
+        const QSize imageSize = m_textureSize.isEmpty() ? m_size : m_textureSize;
+        if (imageSize.isEmpty()) {
+            m_image = QImage();
+        } else {
+            m_image = QImage(imageSize, m_opaquePainting ? QImage::Format_RGB32
+                                                         : QImage::Format_ARGB32_Premultiplied);
+        }
+        m_dirtyRect = QRect();
+        m_dirtyContents = true;
+    }
+
+    if (m_dirtyContents)
+        paintItem();
+
+    m_dirtyGeometry = false;
+    m_dirtyContents = false;
+    m_dirtyRect = QRect();
+}
+
+void QSGSoftwarePainterNode::paintItem()
+{
+    if (m_image.isNull() || m_size.isEmpty())
+        return;
+
+    const QRect dirtyRect = m_dirtyRect.isNull() ? QRect(QPoint(0, 0), m_size) : m_dirtyRect;
+
+    QPainter painter(&m_image);
+    if (m_smoothPainting)
+        painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
+
+    if (m_contentsScale == 1)
+        painter.scale(m_image.width() / qreal(m_size.width()), m_image.height() / qreal(m_size.height()));
+    else
+        painter.scale(m_contentsScale, m_contentsScale);
+
+    if (!m_dirtyRect.isNull())
+        painter.setClipRect(dirtyRect);
+
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(dirtyRect, m_fillColor);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    m_item->paint(&painter);
+    painter.end();
+
+    m_texture->setImage(m_image);
+    markDirty(DirtyMaterial);
+}
+
+void QSGSoftwarePainterNode::paint(QPainter *painter)
+{
+    if (m_image.isNull())
+        return;
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, m_linearFiltering);
+    painter->drawImage(rect(), m_image);
+}
+
+QSGSoftwareGlyphNode::QSGSoftwareGlyphNode()
+    : m_style(QQuickText::Normal)
+{
+}
+
+void QSGSoftwareGlyphNode::setGlyphs(const QPointF &position, const QGlyphRun &glyphs)
+{
+    m_position = position;
+    m_glyphRun = glyphs;
+    // Outline, raised and sunken styles draw one pixel outside the glyphs.
+    setBoundingRect(glyphs.boundingRect().translated(position).adjusted(-1, -1, 1, 1));
+}
+
+void QSGSoftwareGlyphNode::setColor(const QColor &color)
+{
+    m_color = color;
+}
+
+void QSGSoftwareGlyphNode::setStyle(QQuickText::TextStyle style)
+{
+    m_style = style;
+}
+
+void QSGSoftwareGlyphNode::setStyleColor(const QColor &color)
+{
+    m_styleColor = color;
+}
+
+void QSGSoftwareGlyphNode::update()
+{
+    markDirty(DirtyMaterial);
+}
+
+void QSGSoftwareGlyphNode::paint(QPainter *painter)
+{
+    if (m_glyphRun.glyphIndexes().isEmpty())
+        return;
+
+    painter->setBrush(QBrush());
+    switch (m_style) {
+    case QQuickText::Outline:
+        painter->setPen(m_styleColor);
+        painter->drawGlyphRun(m_position + QPointF(0, 1), m_glyphRun);
+        painter->drawGlyphRun(m_position + QPointF(0, -1), m_glyphRun);
+        painter->drawGlyphRun(m_position + QPointF(1, 0), m_glyphRun);
+        painter->drawGlyphRun(m_position + QPointF(-1, 0), m_glyphRun);
+        break;
+    case QQuickText::Raised:
+        painter->setPen(m_styleColor);
+        painter->drawGlyphRun(m_position + QPointF(0, 1), m_glyphRun);
+        break;
+    case QQuickText::Sunken:
+        painter->setPen(m_styleColor);
+        painter->drawGlyphRun(m_position + QPointF(0, -1), m_glyphRun);
+        break;
+    default:
+        break;
+    }
+
+    painter->setPen(m_color);
+    painter->drawGlyphRun(m_position, m_glyphRun);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,191 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSGSOFTWARENODES_H
+#define QSGSOFTWARENODES_H
+
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#include <private/qsgadaptationlayer_p.h>
+#include <private/qsgtexture_p.h>
+
+#include <QtGui/qglyphrun.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qpen.h>
+#include <QtGui/qbrush.h>
+
+QT_BEGIN_NAMESPACE
+
+class QPainter;
+
+class QSGSoftwareRectangleNode : public QSGRectangleNode
+{
+public:
+    QSGSoftwareRectangleNode();
+
+    void setRect(const QRectF &rect);
+    void setColor(const QColor &color);
+    void setPenColor(const QColor &color);
+    void setPenWidth(qreal width);
+    void setGradientStops(const QGradientStops &stops);
+    void setRadius(qreal radius);
+    void setAntialiasing(bool antialiasing);
+    void setAligned(bool aligned);
+
+    void update();
+
+    void paint(QPainter *painter);
+    QRectF rect() const { return m_rect; }
+
+private:
+    QRectF m_rect;
+    QColor m_color;
+    QColor m_penColor;
+    qreal m_penWidth;
+    QGradientStops m_stops;
+    qreal m_radius;
+    bool m_antialiasing;
+    bool m_aligned;
+};
+
+class QSGSoftwareImageNode : public QSGImageNode
+{
+public:
+    QSGSoftwareImageNode();
+
+    void setTargetRect(const QRectF &rect);
+    void setInnerTargetRect(const QRectF &rect);
+    void setInnerSourceRect(const QRectF &rect);
+    void setSubSourceRect(const QRectF &rect);
+    void setTexture(QSGTexture *texture);
+    void setMirror(bool mirror);
+    void setMipmapFiltering(QSGTexture::Filtering filtering);
+    void setFiltering(QSGTexture::Filtering filtering);
+    void setHorizontalWrapMode(QSGTexture::WrapMode wrapMode);
+    void setVerticalWrapMode(QSGTexture::WrapMode wrapMode);
+
+    void update();
+
+    void paint(QPainter *painter);
+    QRectF rect() const { return m_targetRect; }
+
+private:
+    QRectF m_targetRect;
+    QRectF m_innerTargetRect;
+    QRectF m_innerSourceRect;
+    QRectF m_subSourceRect;
+    QSGTexture *m_texture;
+    bool m_mirror;
+    bool m_smooth;
+};
+
+class QSGSoftwarePainterNode : public QSGPainterNode
+{
+public:
+    QSGSoftwarePainterNode(QQuickPaintedItem *item);
+    ~QSGSoftwarePainterNode();
+
+    void setPreferredRenderTarget(QQuickPaintedItem::RenderTarget target);
+    void setSize(const QSize &size);
+    void setDirty(const QRect &dirtyRect = QRect());
+    void setOpaquePainting(bool opaque);
+    void setLinearFiltering(bool linearFiltering);
+    void setMipmapping(bool mipmapping);
+    void setSmoothPainting(bool s);
+    void setFillColor(const QColor &c);
+    void setContentsScale(qreal s);
+    void setFastFBOResizing(bool dynamic);
+    void setTextureSize(const QSize &size);
+
+    QImage toImage() const { return m_image; }
+    void update();
+    QSGTexture *texture() const { return m_texture; }
+
+    void paint(QPainter *painter);
+    QRectF rect() const { return QRectF(QPointF(0, 0), m_size); }
+
+private:
+    void paintItem();
+
+    QQuickPaintedItem *m_item;
+    QImage m_image;
+    QSGPlainTexture *m_texture;
+    QSize m_size;
+    QSize m_textureSize;
+    QRect m_dirtyRect;
+    QColor m_fillColor;
+    qreal m_contentsScale;
+    bool m_dirtyContents : 1;
+    bool m_dirtyGeometry : 1;
+    bool m_opaquePainting : 1;
+    bool m_linearFiltering : 1;
+    bool m_smoothPainting : 1;
+};
+
+class QSGSoftwareGlyphNode : public QSGGlyphNode
+{
+public:
+    QSGSoftwareGlyphNode();
+
+    void setGlyphs(const QPointF &position, const QGlyphRun &glyphs);
+    void setColor(const QColor &color);
+    void setStyle(QQuickText::TextStyle style);
+    void setStyleColor(const QColor &color);
+    QPointF baseLine() const { return m_position; }
+
+    void setPreferredAntialiasingMode(AntialiasingMode) { }
+
+    void update();
+
+    void paint(QPainter *painter);
+
+private:
+    QPointF m_position;
+    QGlyphRun m_glyphRun;
+    QColor m_color;
+    QColor m_styleColor;
+    QQuickText::TextStyle m_style;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSGSOFTWARENODES_H
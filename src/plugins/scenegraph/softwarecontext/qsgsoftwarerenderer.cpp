@@ -0,0 +1,493 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgsoftwarerenderer.h"
+#include "qsgsoftwarenodes.h"
+
+#include <QtQuick/qsgflatcolormaterial.h>
+
+#include <QtGui/qbackingstore.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qpaintdevice.h>
+#include <QtCore/qvarlengtharray.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Returns the triangles of \a geometry as a path. Only the first two floats
+    of each vertex are read, which is where every position attribute in the
+    scene graph lives.
+ */
+static QPainterPath qsg_geometryPath(const QSGGeometry *geometry)
+{
+    QPainterPath path;
+    if (!geometry || geometry->vertexCount() < 3)
+        return path;
+
+    const int stride = geometry->sizeOfVertex();
+    const char *vertices = static_cast<const char *>(geometry->vertexData());
+    const int count = geometry->indexCount() > 0 ? geometry->indexCount() : geometry->vertexCount();
+    const bool uintIndices = geometry->indexType() == GL_UNSIGNED_INT;
+
+    QVarLengthArray<QPointF, 64> points(count);
+    for (int i = 0; i < count; ++i) {
+        int v = i;
+        if (geometry->indexCount() > 0)
+            v = uintIndices ? geometry->indexDataAsUInt()[i] : geometry->indexDataAsUShort()[i];
+        const float *p = reinterpret_cast<const float *>(vertices + v * stride);
+        points[i] = QPointF(p[0], p[1]);
+    }
+
+    path.setFillRule(Qt::WindingFill);
+    for (int i = 2; i < count; ++i) {
+        QPointF a, b, c;
+        switch (geometry->drawingMode()) {
+        case GL_TRIANGLES:
+            if (i % 3 != 2)
+                continue;
+            a = points[i - 2]; b = points[i - 1]; c = points[i];
+            break;
+        case GL_TRIANGLE_STRIP:
+            a = points[i - 2]; b = points[i - 1]; c = points[i];
+            break;
+        case GL_TRIANGLE_FAN:
+            a = points[0]; b = points[i - 1]; c = points[i];
+            break;
+        default:
+            return QPainterPath();
+        }
+        // Give every triangle the same winding so that overlapping ones unite
+        // instead of cancelling each other out.
+        if ((b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x()) < 0)
+            qSwap(b, c);
+        path.moveTo(a);
+        path.lineTo(b);
+        path.lineTo(c);
+        path.closeSubpath();
+    }
+    return path;
+}
+
+static QRectF qsg_geometryBounds(const QSGGeometry *geometry)
+{
+    if (!geometry || geometry->vertexCount() == 0)
+        return QRectF();
+
+    const int stride = geometry->sizeOfVertex();
+    const char *vertices = static_cast<const char *>(geometry->vertexData());
+    const float *p = reinterpret_cast<const float *>(vertices);
+    float x1 = p[0], x2 = p[0], y1 = p[1], y2 = p[1];
+    for (int i = 1; i < geometry->vertexCount(); ++i) {
+        p = reinterpret_cast<const float *>(vertices + i * stride);
+        x1 = qMin(x1, p[0]);
+        x2 = qMax(x2, p[0]);
+        y1 = qMin(y1, p[1]);
+        y2 = qMax(y2, p[1]);
+    }
+    return QRectF(x1, y1, x2 - x1, y2 - y1);
+}
+
+static inline QSGFlatColorMaterial *qsg_flatColorMaterial(QSGGeometryNode *node)
+{
+    static QSGMaterialType *flatColorType = QSGFlatColorMaterial().type();
+    QSGMaterial *material = node->activeMaterial();
+    if (!material || material->type() != flatColorType)
+        return 0;
+    return static_cast<QSGFlatColorMaterial *>(material);
+}
+
+/*
+    Walks the tree keeping track of the accumulated transform, opacity and
+    clip bounds and hands every node that paints something to drawNode().
+    Geometry nodes that are not software nodes are only drawn when they use
+    QSGFlatColorMaterial; custom materials need OpenGL and are skipped.
+ */
+class QSGSoftwareNodeWalker : public QSGNodeVisitorEx
+{
+public:
+    enum NodeKind {
+        RectangleKind,
+        ImageKind,
+        PainterKind,
+        GlyphKind,
+        FlatColorKind
+    };
+
+    struct State {
+        QTransform transform;
+        QRectF clipRect;
+        qreal opacity;
+        bool clipped;
+        bool dirty;
+    };
+
+    QSGSoftwareNodeWalker(const QSet<QSGNode *> *dirtyNodes)
+        : m_dirtyNodes(dirtyNodes)
+    {
+        State root;
+        root.opacity = 1;
+        root.clipped = false;
+        root.dirty = false;
+        m_states.append(root);
+    }
+
+    bool visit(QSGTransformNode *node)
+    {
+        State s = push(node);
+        s.transform = node->matrix().toTransform() * s.transform;
+        m_states.last() = s;
+        return true;
+    }
+    void endVisit(QSGTransformNode *) { m_states.removeLast(); }
+
+    bool visit(QSGClipNode *node)
+    {
+        State s = push(node);
+        const QRectF clip = s.transform.mapRect(node->clipRect());
+        s.clipRect = s.clipped ? s.clipRect & clip : clip;
+        s.clipped = true;
+        m_states.last() = s;
+        return !s.clipRect.isEmpty();
+    }
+    void endVisit(QSGClipNode *) { m_states.removeLast(); }
+
+    bool visit(QSGOpacityNode *node)
+    {
+        State s = push(node);
+        s.opacity *= node->opacity();
+        m_states.last() = s;
+        return s.opacity > 0;
+    }
+    void endVisit(QSGOpacityNode *) { m_states.removeLast(); }
+
+    bool visit(QSGGeometryNode *node)
+    {
+        if (qsg_flatColorMaterial(node))
+            drawNode(node, qsg_geometryBounds(node->geometry()), FlatColorKind);
+        return true;
+    }
+    void endVisit(QSGGeometryNode *) { }
+
+    bool visit(QSGImageNode *node)
+    {
+        drawNode(node, static_cast<QSGSoftwareImageNode *>(node)->rect(), ImageKind);
+        return true;
+    }
+    void endVisit(QSGImageNode *) { }
+
+    bool visit(QSGPainterNode *node)
+    {
+        drawNode(node, static_cast<QSGSoftwarePainterNode *>(node)->rect(), PainterKind);
+        return true;
+    }
+    void endVisit(QSGPainterNode *) { }
+
+    bool visit(QSGRectangleNode *node)
+    {
+        drawNode(node, static_cast<QSGSoftwareRectangleNode *>(node)->rect(), RectangleKind);
+        return true;
+    }
+    void endVisit(QSGRectangleNode *) { }
+
+    bool visit(QSGGlyphNode *node)
+    {
+        drawNode(node, node->boundingRect(), GlyphKind);
+        return true;
+    }
+    void endVisit(QSGGlyphNode *) { }
+
+    bool visit(QSGNinePatchNode *) { return true; }
+    void endVisit(QSGNinePatchNode *) { }
+
+    bool visit(QSGRootNode *) { return true; }
+    void endVisit(QSGRootNode *) { }
+
+protected:
+    virtual void drawNode(QSGNode *node, const QRectF &bounds, NodeKind kind) = 0;
+
+    const State &state() const { return m_states.last(); }
+
+    bool isDirty(QSGNode *node) const
+    {
+        return state().dirty || (m_dirtyNodes && m_dirtyNodes->contains(node));
+    }
+
+    // Returns the device rect \a bounds covers once transformed and clipped,
+    // grown by a pixel on each side to include antialiased edges.
+    QRect deviceRect(const QRectF &bounds) const
+    {
+        const State &s = state();
+        QRectF r = s.transform.mapRect(bounds);
+        if (s.clipped)
+            r &= s.clipRect;
+        if (r.isEmpty())
+            return QRect();
+        return r.toAlignedRect().adjusted(-1, -1, 1, 1);
+    }
+
+private:
+    State push(QSGNode *node)
+    {
+        State s = m_states.last();
+        s.dirty = isDirty(node);
+        m_states.append(s);
+        return s;
+    }
+
+    const QSet<QSGNode *> *m_dirtyNodes;
+    QVector<State> m_states;
+};
+
+/*
+    First pass: records where every node paints this frame and collects the
+    damage, which is the old and new rect of every node that changed, moved
+    or disappeared since the previous frame.
+ */
+class QSGSoftwareDamageVisitor : public QSGSoftwareNodeWalker
+{
+public:
+    QSGSoftwareDamageVisitor(const QSet<QSGNode *> *dirtyNodes, QHash<QSGNode *, QRect> *oldBounds)
+        : QSGSoftwareNodeWalker(dirtyNodes)
+        , m_oldBounds(oldBounds)
+    {
+    }
+
+    QHash<QSGNode *, QRect> bounds;
+    QRegion damage;
+
+protected:
+    void drawNode(QSGNode *node, const QRectF &localBounds, NodeKind)
+    {
+        const QRect rect = deviceRect(localBounds);
+        const QRect oldRect = m_oldBounds->take(node);
+        if (rect != oldRect || isDirty(node)) {
+            damage += oldRect;
+            damage += rect;
+        }
+        if (!rect.isEmpty())
+            bounds.insert(node, rect);
+    }
+
+private:
+    QHash<QSGNode *, QRect> *m_oldBounds;
+};
+
+/*
+    Second pass: paints every node whose rect intersects the damage. The
+    painter is already clipped to the damaged region.
+ */
+class QSGSoftwarePaintVisitor : public QSGSoftwareNodeWalker
+{
+public:
+    QSGSoftwarePaintVisitor(QPainter *painter, const QHash<QSGNode *, QRect> *bounds, const QRegion &damage)
+        : QSGSoftwareNodeWalker(0)
+        , m_painter(painter)
+        , m_bounds(bounds)
+        , m_damage(damage)
+    {
+    }
+
+    bool visit(QSGClipNode *node)
+    {
+        if (!QSGSoftwareNodeWalker::visit(node))
+            return false;
+        m_painter->save();
+        m_painter->setTransform(state().transform);
+        if (node->isRectangular())
+            m_painter->setClipRect(node->clipRect(), Qt::IntersectClip);
+        else
+            m_painter->setClipPath(qsg_geometryPath(node->geometry()), Qt::IntersectClip);
+        return true;
+    }
+
+    void endVisit(QSGClipNode *node)
+    {
+        // visit() did not save when the clip was empty.
+        if (!state().clipRect.isEmpty())
+            m_painter->restore();
+        QSGSoftwareNodeWalker::endVisit(node);
+    }
+
+protected:
+    void drawNode(QSGNode *node, const QRectF &, NodeKind kind)
+    {
+        QHash<QSGNode *, QRect>::const_iterator it = m_bounds->constFind(node);
+        if (it == m_bounds->constEnd() || !m_damage.intersects(it.value()))
+            return;
+
+        m_painter->setTransform(state().transform);
+        m_painter->setOpacity(state().opacity);
+
+        switch (kind) {
+        case RectangleKind:
+            static_cast<QSGSoftwareRectangleNode *>(node)->paint(m_painter);
+            break;
+        case ImageKind:
+            static_cast<QSGSoftwareImageNode *>(node)->paint(m_painter);
+            break;
+        case PainterKind:
+            static_cast<QSGSoftwarePainterNode *>(node)->paint(m_painter);
+            break;
+        case GlyphKind:
+            static_cast<QSGSoftwareGlyphNode *>(node)->paint(m_painter);
+            break;
+        case FlatColorKind: {
+            QSGGeometryNode *g = static_cast<QSGGeometryNode *>(node);
+            m_painter->setRenderHint(QPainter::Antialiasing, false);
+            m_painter->fillPath(qsg_geometryPath(g->geometry()), qsg_flatColorMaterial(g)->color());
+            break;
+        }
+        }
+    }
+
+private:
+    QPainter *m_painter;
+    const QHash<QSGNode *, QRect> *m_bounds;
+    QRegion m_damage;
+};
+
+/*
+    Renders the scene graph with QPainter, either into the backing store of a
+    window or into an image when grabbing.
+
+    Only the parts of the target that changed since the previous frame are
+    repainted: nodeChanged() records which nodes were touched, and the damage
+    pass compares where every node painted last frame with where it paints
+    now. When nothing changed, render() paints nothing and flushRegion() is
+    empty, so the render loop can skip flushing altogether.
+ */
+QSGSoftwareRenderer::QSGSoftwareRenderer(QSGRenderContext *context)
+    : QSGRenderer(context)
+    , m_backingStore(0)
+    , m_targetImage(0)
+    , m_fullRepaint(true)
+{
+}
+
+void QSGSoftwareRenderer::setBackingStore(QBackingStore *backingStore)
+{
+    if (m_backingStore != backingStore || m_targetImage)
+        m_fullRepaint = true;
+    m_backingStore = backingStore;
+    m_targetImage = 0;
+}
+
+void QSGSoftwareRenderer::setTargetImage(QImage *image)
+{
+    m_targetImage = image;
+    m_fullRepaint = true;
+}
+
+void QSGSoftwareRenderer::renderScene(GLuint fboId)
+{
+    Q_UNUSED(fboId);
+
+    class B : public QSGBindable
+    {
+    public:
+        void bind() const { }
+    } bindable;
+    QSGRenderer::renderScene(bindable);
+}
+
+void QSGSoftwareRenderer::nodeChanged(QSGNode *node, QSGNode::DirtyState state)
+{
+    if (state & QSGNode::DirtyNodeRemoved)
+        m_dirtyNodes.remove(node);
+    else
+        m_dirtyNodes.insert(node);
+
+    QSGRenderer::nodeChanged(node, state);
+}
+
+QRegion QSGSoftwareRenderer::updateDirtyRegion()
+{
+    QSGSoftwareDamageVisitor visitor(&m_dirtyNodes, &m_nodeBounds);
+    visitor.visitChildren(rootNode());
+
+    // Whatever is left painted last frame but is gone now.
+    for (QHash<QSGNode *, QRect>::const_iterator it = m_nodeBounds.constBegin();
+         it != m_nodeBounds.constEnd(); ++it) {
+        visitor.damage += it.value();
+    }
+
+    m_nodeBounds.swap(visitor.bounds);
+    m_dirtyNodes.clear();
+    return visitor.damage;
+}
+
+void QSGSoftwareRenderer::render()
+{
+    QRect targetRect;
+    if (m_targetImage)
+        targetRect = QRect(QPoint(0, 0), m_targetImage->size() / m_targetImage->devicePixelRatio());
+    else if (m_backingStore)
+        targetRect = QRect(QPoint(0, 0), m_backingStore->size());
+
+    QRegion damage = updateDirtyRegion();
+    if (m_fullRepaint || clearColor() != m_lastClearColor)
+        damage = targetRect;
+    damage &= targetRect;
+
+    m_fullRepaint = false;
+    m_lastClearColor = clearColor();
+    m_flushRegion = damage;
+    if (damage.isEmpty())
+        return;
+
+    QPaintDevice *device = m_targetImage;
+    if (!device) {
+        m_backingStore->beginPaint(damage);
+        device = m_backingStore->paintDevice();
+    }
+
+    QPainter painter(device);
+    painter.setClipRegion(damage);
+
+    if (clearMode() & ClearColorBuffer) {
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        foreach (const QRect &r, damage.rects())
+            painter.fillRect(r, clearColor());
+        painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    }
+
+    QSGSoftwarePaintVisitor visitor(&painter, &m_nodeBounds, damage);
+    visitor.visitChildren(rootNode());
+    painter.end();
+
+    if (!m_targetImage)
+        m_backingStore->endPaint();
+}
+
+QT_END_NAMESPACE
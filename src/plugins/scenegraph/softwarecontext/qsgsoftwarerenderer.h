@@ -0,0 +1,94 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSGSOFTWARERENDERER_H
+#define QSGSOFTWARERENDERER_H
+
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#include <private/qsgrenderer_p.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
+#include <QtGui/qregion.h>
+
+QT_BEGIN_NAMESPACE
+
+class QBackingStore;
+class QImage;
+
+class QSGSoftwareRenderer : public QSGRenderer
+{
+public:
+    QSGSoftwareRenderer(QSGRenderContext *context);
+
+    void setBackingStore(QBackingStore *backingStore);
+    void setTargetImage(QImage *image);
+
+    void markFullRepaint() { m_fullRepaint = true; }
+    QRegion flushRegion() const { return m_flushRegion; }
+
+    void renderScene(GLuint fboId = 0) Q_DECL_OVERRIDE;
+    void nodeChanged(QSGNode *node, QSGNode::DirtyState state) Q_DECL_OVERRIDE;
+
+protected:
+    void render() Q_DECL_OVERRIDE;
+
+private:
+    QRegion updateDirtyRegion();
+
+    QBackingStore *m_backingStore;
+    QImage *m_targetImage;
+
+    // Device rects of everything painted in the previous frame, keyed on the
+    // node that painted it. Nodes missing from the next frame are repainted
+    // over, nodes that moved are repainted at both places.
+    QHash<QSGNode *, QRect> m_nodeBounds;
+    QSet<QSGNode *> m_dirtyNodes;
+    QRegion m_flushRegion;
+    QColor m_lastClearColor;
+    bool m_fullRepaint;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSGSOFTWARERENDERER_H
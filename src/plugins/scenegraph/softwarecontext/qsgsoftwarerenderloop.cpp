@@ -0,0 +1,257 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the plugins of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgsoftwarerenderloop.h"
+#include "qsgsoftwarerenderer.h"
+
+#include <private/qquickwindow_p.h>
+#include <private/qquickanimatorcontroller_p.h>
+
+#include <QtGui/qbackingstore.h>
+#include <QtCore/qcoreevent.h>
+#include <QtCore/qrunnable.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    A non-threaded render loop that paints every window into a QBackingStore
+    with QSGSoftwareRenderer. It follows the basic render loop, except that
+    there is no OpenGL context to create or make current, and only the region
+    the renderer repainted is flushed to the window.
+ */
+QSGSoftwareRenderLoop::QSGSoftwareRenderLoop()
+    : m_update_timer(0)
+    , eventPending(false)
+{
+    sg = QSGContext::createDefaultContext();
+    rc = sg->createRenderContext();
+}
+
+QSGSoftwareRenderLoop::~QSGSoftwareRenderLoop()
+{
+    delete rc;
+    delete sg;
+}
+
+void QSGSoftwareRenderLoop::show(QQuickWindow *window)
+{
+    WindowData data;
+    data.backingStore = new QBackingStore(window);
+    data.updatePending = false;
+    data.grabOnly = false;
+    data.fullRepaint = true;
+    m_windows[window] = data;
+
+    maybeUpdate(window);
+}
+
+void QSGSoftwareRenderLoop::hide(QQuickWindow *window)
+{
+    QQuickWindowPrivate *cd = QQuickWindowPrivate::get(window);
+    cd->fireAboutToStop();
+}
+
+void QSGSoftwareRenderLoop::windowDestroyed(QQuickWindow *window)
+{
+    WindowData data = m_windows.take(window);
+    hide(window);
+    QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
+
+    d->cleanupNodesOnShutdown();
+    if (m_windows.size() == 0)
+        rc->invalidate();
+
+    delete data.backingStore;
+    delete d->animationController;
+}
+
+void QSGSoftwareRenderLoop::renderWindow(QQuickWindow *window)
+{
+    QQuickWindowPrivate *cd = QQuickWindowPrivate::get(window);
+    if (!cd->isRenderable() || !m_windows.contains(window))
+        return;
+
+    if (!rc->isValid())
+        rc->initialize(0);
+
+    const bool grabOnly = m_windows.value(window).grabOnly;
+    if (!grabOnly) {
+        cd->flushDelayedTouchEvent();
+        // Event delivery/processing triggered the window to be deleted or stop rendering.
+        if (!m_windows.contains(window))
+            return;
+    }
+
+    WindowData &data = m_windows[window];
+
+    // A grab only renders into an image, so an update that is pending for the
+    // backing store stays pending.
+    bool alsoFlush = false;
+    if (!grabOnly) {
+        alsoFlush = data.updatePending;
+        data.updatePending = false;
+    }
+
+    cd->polishItems();
+
+    emit window->afterAnimating();
+
+    cd->syncSceneGraph();
+
+    QSGSoftwareRenderer *renderer = static_cast<QSGSoftwareRenderer *>(cd->renderer);
+    if (!renderer)
+        return;
+
+    const QSize size = window->size();
+    QImage grabbed;
+    if (grabOnly) {
+        const qreal dpr = window->effectiveDevicePixelRatio();
+        grabbed = QImage(size * dpr, QImage::Format_ARGB32_Premultiplied);
+        grabbed.setDevicePixelRatio(dpr);
+        grabbed.fill(Qt::transparent);
+        renderer->setTargetImage(&grabbed);
+    } else {
+        if (data.backingStore->size() != size) {
+            data.backingStore->resize(size);
+            data.fullRepaint = true;
+        }
+        renderer->setBackingStore(data.backingStore);
+        if (data.fullRepaint)
+            renderer->markFullRepaint();
+        data.fullRepaint = false;
+    }
+
+    cd->renderSceneGraph(size);
+
+    if (grabOnly) {
+        renderer->setTargetImage(0);
+        grabContent = grabbed;
+        // The changes synchronized for the grab never reached the backing store.
+        data.fullRepaint = true;
+    }
+
+    if (alsoFlush && window->isVisible()) {
+        // Nothing is flushed when the scene did not change, but the frame still
+        // counts as presented for anything that animates on frameSwapped().
+        const QRegion region = renderer->flushRegion();
+        if (!region.isEmpty())
+            data.backingStore->flush(region);
+        cd->fireFrameSwapped();
+    }
+
+    // Might have been set during syncSceneGraph()
+    if (data.updatePending || (grabOnly && window->isVisible()))
+        maybeUpdate(window);
+}
+
+void QSGSoftwareRenderLoop::exposureChanged(QQuickWindow *window)
+{
+    if (window->isExposed() && m_windows.contains(window)) {
+        WindowData &data = m_windows[window];
+        data.updatePending = true;
+        data.fullRepaint = true;
+        renderWindow(window);
+    }
+}
+
+QImage QSGSoftwareRenderLoop::grab(QQuickWindow *window)
+{
+    if (!m_windows.contains(window))
+        return QImage();
+
+    m_windows[window].grabOnly = true;
+
+    renderWindow(window);
+
+    // Also when the window could not be rendered.
+    if (m_windows.contains(window))
+        m_windows[window].grabOnly = false;
+
+    QImage grabbed = grabContent;
+    grabContent = QImage();
+    return grabbed;
+}
+
+void QSGSoftwareRenderLoop::maybeUpdate(QQuickWindow *window)
+{
+    if (!m_windows.contains(window))
+        return;
+
+    m_windows[window].updatePending = true;
+
+    if (!eventPending) {
+        const int exhaust_delay = 5;
+        m_update_timer = startTimer(exhaust_delay, Qt::PreciseTimer);
+        eventPending = true;
+    }
+}
+
+/*
+    There is no context to make current, so jobs can always run right away.
+ */
+void QSGSoftwareRenderLoop::postJob(QQuickWindow *window, QRunnable *job)
+{
+    Q_UNUSED(window);
+    Q_ASSERT(job);
+    job->run();
+    delete job;
+}
+
+QSGContext *QSGSoftwareRenderLoop::sceneGraphContext() const
+{
+    return sg;
+}
+
+QSurface::SurfaceType QSGSoftwareRenderLoop::windowSurfaceType() const
+{
+    return QSurface::RasterSurface;
+}
+
+bool QSGSoftwareRenderLoop::event(QEvent *e)
+{
+    if (e->type() == QEvent::Timer) {
+        eventPending = false;
+        killTimer(m_update_timer);
+        m_update_timer = 0;
+        for (QHash<QQuickWindow *, WindowData>::const_iterator it = m_windows.constBegin();
+             it != m_windows.constEnd(); ++it) {
+            const WindowData &data = it.value();
+            if (data.updatePending)
+                renderWindow(it.key());
+        }
+        return true;
+    }
+    return QObject::event(e);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,23 @@
+TARGET = qsgsoftwarecontext
+QT    += quick-private qml-private gui-private core-private
+
+SOURCES += \
+    $$PWD/qsgsoftwarecontext.cpp \
+    $$PWD/qsgsoftwarenodes.cpp \
+    $$PWD/qsgsoftwareplugin.cpp \
+    $$PWD/qsgsoftwarerenderer.cpp \
+    $$PWD/qsgsoftwarerenderloop.cpp
+
+HEADERS += \
+    $$PWD/qsgsoftwarecontext.h \
+    $$PWD/qsgsoftwarenodes.h \
+    $$PWD/qsgsoftwareplugin.h \
+    $$PWD/qsgsoftwarerenderer.h \
+    $$PWD/qsgsoftwarerenderloop.h
+
+OTHER_FILES += \
+    softwarecontext.json
+
+PLUGIN_TYPE = scenegraph
+PLUGIN_CLASS_NAME = QSGSoftwareContextPlugin
+load(qt_plugin)
@@ -583,6 +583,8 @@ bool QQmlPropertyCacheCreator::createMetaObject(int objectIndex, const QmlIR::Ob
     QQmlPropertyCache *cache = baseTypeCache->copyAndReserve(obj->propertyCount(),
                                                              obj->functionCount() + obj->propertyCount() + obj->signalCount(),
                                                              obj->signalCount() + obj->propertyCount());
+    // The base type cache may be shared between engines, the QML type's cache is not.
+    cache->engine = enginePrivate->v4engine();
     propertyCaches[objectIndex] = cache;
 
     struct TypeData {
@@ -43,6 +43,7 @@
 #include "private/qv4script_p.h"
 #include "private/qv4runtime_p.h"
 #include <private/qqmlbuiltinfunctions_p.h>
+#include <private/qqmlmetatype_p.h>
 
 #include <QtCore/qdatetime.h>
 #include <QtCore/qmetaobject.h>
@@ -671,8 +672,71 @@ QJSEnginePrivate::~QJSEnginePrivate()
         (*iter)->release();
 }
 
+namespace {
+struct QQmlSharedPropertyCaches
+{
+    QQmlSharedPropertyCaches() : mutex(QMutex::Recursive) {}
+    ~QQmlSharedPropertyCaches()
+    {
+        typedef QHash<const QMetaObject *, QQmlPropertyCache *>::ConstIterator PropertyCacheIt;
+
+        for (PropertyCacheIt iter = caches.cbegin(), end = caches.cend(); iter != end; ++iter)
+            (*iter)->release();
+    }
+
+    QMutex mutex;
+    QHash<const QMetaObject *, QQmlPropertyCache *> caches;
+};
+}
+
+Q_GLOBAL_STATIC(QQmlSharedPropertyCaches, sharedPropertyCaches)
+
+/*
+Returns the process wide property cache of \a mo, or 0 if \a mo cannot be shared.
+
+The caches of C++ types registered with QML do not depend on any engine, so they are
+built once and kept for the lifetime of the process instead of once per engine.  A
+cache is only shared if the caches of all its super classes are shared as well.
+*/
+static QQmlPropertyCache *sharedPropertyCache(const QMetaObject *mo)
+{
+    QQmlSharedPropertyCaches *shared = sharedPropertyCaches();
+    if (!shared)
+        return 0;
+
+    QMutexLocker locker(&shared->mutex);
+    if (QQmlPropertyCache *rv = shared->caches.value(mo))
+        return rv;
+
+    if (!QQmlMetaType::qmlType(mo))
+        return 0;
+
+    QQmlPropertyCache *rv = 0;
+    if (!mo->superClass()) {
+        rv = new QQmlPropertyCache(0, mo);
+    } else if (QQmlPropertyCache *super = sharedPropertyCache(mo->superClass())) {
+        rv = super->copyAndAppend(mo);
+    } else {
+        return 0;
+    }
+
+    shared->caches.insert(mo, rv);
+    return rv;
+}
+
 QQmlPropertyCache *QJSEnginePrivate::createCache(const QMetaObject *mo)
 {
+    // Property data is resolved lazily on the engine's thread, so only engines living in
+    // the main thread can share caches with each other.
+    QCoreApplication *app = QCoreApplication::instance();
+    if (app && q_func()->thread() == app->thread()) {
+        if (QQmlPropertyCache *rv = sharedPropertyCache(mo)) {
+            rv->addref();
+            propertyCache.insert(mo, rv);
+            return rv;
+        }
+    }
+
     if (!mo->superClass()) {
         QQmlPropertyCache *rv = new QQmlPropertyCache(QV8Engine::getV4(q_func()), mo);
         propertyCache.insert(mo, rv);
@@ -680,6 +744,7 @@ QQmlPropertyCache *QJSEnginePrivate::createCache(const QMetaObject *mo)
     } else {
         QQmlPropertyCache *super = cache(mo->superClass());
         QQmlPropertyCache *rv = super->copyAndAppend(mo);
+        rv->engine = QV8Engine::getV4(q_func());
         propertyCache.insert(mo, rv);
         return rv;
     }
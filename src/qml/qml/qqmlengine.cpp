@@ -1717,6 +1717,8 @@ void QQmlData::destroyed(QObject *object)
 
     if (ownMemory)
         delete this;
+    else
+        this->~QQmlData();
 }
 
 DEFINE_BOOL_CONFIG_OPTION(parentTest, QML_PARENT_TEST);
@@ -63,6 +63,42 @@ namespace {
         qintptr *disconnectWatch;
         QQmlNotifierEndpoint *endpoint;
     };
+
+    // Holds the traversal data of one notify.  Entries never move once they have been
+    // appended, as the endpoints being notified point into them, which allows the endpoint
+    // list to be walked and marked in a single pass.  Notifiers with many endpoints are
+    // cache miss bound, so every pass over the endpoints counts.
+    class NotifyListTraversalStack
+    {
+    public:
+        enum { ChunkSize = 64 };
+
+        NotifyListTraversalStack() : m_size(0) { m_chunks.append(m_first); }
+        ~NotifyListTraversalStack()
+        {
+            for (int i = 1; i < m_chunks.size(); ++i)
+                delete [] m_chunks.at(i);
+        }
+
+        NotifyListTraversalData &append(QQmlNotifierEndpoint *endpoint)
+        {
+            if (m_size == m_chunks.size() * ChunkSize)
+                m_chunks.append(new NotifyListTraversalData[ChunkSize]);
+            NotifyListTraversalData &data = at(m_size++);
+            data.endpoint = endpoint;
+            return data;
+        }
+
+        int size() const { return m_size; }
+        NotifyListTraversalData &at(int i) { return m_chunks[i / ChunkSize][i % ChunkSize]; }
+
+    private:
+        Q_DISABLE_COPY(NotifyListTraversalStack)
+
+        NotifyListTraversalData m_first[ChunkSize];
+        QVarLengthArray<NotifyListTraversalData *, 16> m_chunks;
+        int m_size;
+    };
 }
 
 void QQmlNotifier::notify(QQmlData *ddata, int notifierIndex)
@@ -73,26 +109,20 @@ void QQmlNotifier::notify(QQmlData *ddata, int notifierIndex)
 
 void QQmlNotifier::emitNotify(QQmlNotifierEndpoint *endpoint, void **a)
 {
-    QVarLengthArray<NotifyListTraversalData> stack;
-    while (endpoint) {
-        stack.append(NotifyListTraversalData(endpoint));
-        endpoint = endpoint->next;
-    }
-
-    int i = 0;
-    for (; i < stack.size(); ++i) {
-        NotifyListTraversalData &data = stack[i];
+    NotifyListTraversalStack stack;
+    for (; endpoint; endpoint = endpoint->next) {
+        NotifyListTraversalData &data = stack.append(endpoint);
 
-        if (!data.endpoint->isNotifying()) {
-            data.originalSenderPtr = data.endpoint->senderPtr;
+        if (!endpoint->isNotifying()) {
+            data.originalSenderPtr = endpoint->senderPtr;
             data.disconnectWatch = &data.originalSenderPtr;
-            data.endpoint->senderPtr = qintptr(data.disconnectWatch) | 0x1;
+            endpoint->senderPtr = qintptr(data.disconnectWatch) | 0x1;
         } else {
-            data.disconnectWatch = (qintptr *)(data.endpoint->senderPtr & ~0x1);
+            data.disconnectWatch = (qintptr *)(endpoint->senderPtr & ~0x1);
         }
     }
 
-    while (--i >= 0) {
+    for (int i = stack.size() - 1; i >= 0; --i) {
         const NotifyListTraversalData &data = stack.at(i);
         if (*data.disconnectWatch) {
 
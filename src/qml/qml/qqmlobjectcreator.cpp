@@ -1069,12 +1069,22 @@ QObject *QQmlObjectCreator::createInstance(int index, QObject *parent, bool isCo
         if (type) {
             Q_QML_OC_PROFILE(sharedState->profiler, profiler.update(type->qmlTypeName(),
                     context->url(), obj->location.line, obj->location.column));
-            instance = type->create();
+            // Allocate the QQmlData together with the object itself, to save one
+            // allocation per created object and keep the two close in memory.
+            void *ddataMemory = 0;
+            type->create(&instance, &ddataMemory, sizeof(QQmlData));
             if (!instance) {
                 recordError(obj->location, tr("Unable to create object of type %1").arg(stringAt(obj->inheritedTypeNameIndex)));
                 return 0;
             }
 
+            QObjectPrivate *instancePrivate = QObjectPrivate::get(instance);
+            if (!instancePrivate->declarativeData) {
+                QQmlData *ddata = new (ddataMemory) QQmlData;
+                ddata->ownMemory = false;
+                instancePrivate->declarativeData = ddata;
+            }
+
             const int parserStatusCast = type->parserStatusCast();
             if (parserStatusCast != -1)
                 parserStatus = reinterpret_cast<QQmlParserStatus*>(reinterpret_cast<char *>(instance) + parserStatusCast);
@@ -1237,17 +1247,18 @@ QQmlContextData *QQmlObjectCreator::finalize(QQmlInstantiationInterrupt &interru
         }
     }
 
-    for (int ii = 0; ii < sharedState->finalizeCallbacks.count(); ++ii) {
-        QQmlEnginePrivate::FinalizeCallback callback = sharedState->finalizeCallbacks.at(ii);
+    // Callbacks are consumed one by one, so that finalization can be interrupted in between
+    // and resumed without invoking any of them twice.
+    while (!sharedState->finalizeCallbacks.isEmpty()) {
+        QQmlEnginePrivate::FinalizeCallback callback = sharedState->finalizeCallbacks.takeFirst();
         QObject *obj = callback.first;
         if (obj) {
             void *args[] = { 0 };
             QMetaObject::metacall(obj, QMetaObject::InvokeMetaMethod, callback.second, args);
         }
-        if (watcher.hasRecursed())
+        if (watcher.hasRecursed() || interrupt.shouldInterrupt())
             return 0;
     }
-    sharedState->finalizeCallbacks.clear();
 
     while (sharedState->componentAttached) {
         QQmlComponentAttached *a = sharedState->componentAttached;
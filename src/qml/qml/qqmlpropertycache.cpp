@@ -236,18 +236,18 @@ QQmlPropertyCache::QQmlPropertyCache(QV4::ExecutionEngine *e)
       signalHandlerIndexCacheStart(0), _hasPropertyOverrides(false), _ownMetaObject(false),
       _metaObject(0), argumentsCache(0), _jsFactoryMethodIndex(-1)
 {
-    Q_ASSERT(engine);
 }
 
 /*!
 Creates a new QQmlPropertyCache of \a metaObject.
+
+\a e is null for the caches of C++ types that are shared between engines.
 */
 QQmlPropertyCache::QQmlPropertyCache(QV4::ExecutionEngine *e, const QMetaObject *metaObject)
     : engine(e), _parent(0), propertyIndexCacheStart(0), methodIndexCacheStart(0),
       signalHandlerIndexCacheStart(0), _hasPropertyOverrides(false), _ownMetaObject(false),
       _metaObject(0), argumentsCache(0), _jsFactoryMethodIndex(-1)
 {
-    Q_ASSERT(engine);
     Q_ASSERT(metaObject);
 
     update(metaObject);
@@ -746,7 +746,7 @@ void QQmlPropertyCache::resolve(QQmlPropertyData *data) const
                 data->propType = registerResult == -1 ? QMetaType::UnknownType : registerResult;
             }
         }
-        data->flags |= flagsForPropertyType(data->propType, engine->qmlEngine());
+        data->flags |= flagsForPropertyType(data->propType, engine ? engine->qmlEngine() : 0);
     }
 
     data->flags &= ~QQmlPropertyData::NotFullyResolved;
@@ -34,6 +34,8 @@
 #include "qqmldelegatemodel_p_p.h"
 
 #include <QtQml/qqmlinfo.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qnumeric.h>
 
 #include <private/qquickpackage_p.h>
 #include <private/qmetaobjectbuilder_p.h>
@@ -48,8 +50,17 @@
 #include <private/qv4functionobject_p.h>
 #include <qv4objectiterator_p.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
+namespace {
+    // Pooled delegates that are not reused for between one and two intervals are destroyed.
+    const int QQmlDelegateModel_ReusePoolInterval = 1000;
+    // The pool holds at most as many delegates as are in use, but always this many.
+    const int QQmlDelegateModel_MinimumReusePoolSize = 16;
+}
+
 class QQmlDelegateModelItem;
 
 namespace QV4 {
@@ -197,12 +208,16 @@ QQmlDelegateModelPrivate::QQmlDelegateModelPrivate(QQmlContext *ctxt)
     , m_filterGroup(QStringLiteral("items"))
     , m_count(0)
     , m_groupCount(Compositor::MinimumGroupCount)
+    , m_reusePoolStaleCount(0)
+    , m_fetchMoreThreshold(0)
     , m_compositorGroup(Compositor::Cache)
     , m_complete(false)
     , m_delegateValidated(false)
     , m_reset(false)
     , m_transaction(false)
     , m_incubatorCleanupScheduled(false)
+    , m_reuseItems(false)
+    , m_fetchMoreRequested(false)
     , m_cacheItems(0)
     , m_items(0)
     , m_persistedItems(0)
@@ -246,6 +261,19 @@ QQmlDelegateModel::~QQmlDelegateModel()
 {
     Q_D(QQmlDelegateModel);
 
+    foreach (QQmlDelegateModelItem *cacheItem, d->m_reusePool) {
+        delete cacheItem->object;
+
+        cacheItem->object = 0;
+        cacheItem->contextData->destroy();
+        cacheItem->contextData = 0;
+        cacheItem->scriptRef -= 1;
+        if (!cacheItem->isReferenced())
+            delete cacheItem;
+    }
+    d->m_reusePool.clear();
+    d->m_reusePoolStaleCount = 0;
+
     foreach (QQmlDelegateModelItem *cacheItem, d->m_cache) {
         if (cacheItem->object) {
             delete cacheItem->object;
@@ -327,8 +355,7 @@ void QQmlDelegateModel::componentComplete()
     d->itemsInserted(inserts);
     d->emitChanges();
 
-    if (d->m_adaptorModel.canFetchMore())
-        QCoreApplication::postEvent(this, new QEvent(QEvent::UpdateRequest));
+    d->requestFetchMore();
 }
 
 /*!
@@ -357,6 +384,7 @@ void QQmlDelegateModel::setModel(const QVariant &model)
 
     if (d->m_complete)
         _q_itemsRemoved(0, d->m_count);
+    d->drainReusePool();
 
     d->m_adaptorModel.setModel(model, this, d->m_context->engine());
     d->m_adaptorModel.replaceWatchedRoles(QList<QByteArray>(), d->m_watchedRoles);
@@ -367,8 +395,7 @@ void QQmlDelegateModel::setModel(const QVariant &model)
 
     if (d->m_complete) {
         _q_itemsInserted(0, d->m_adaptorModel.count());
-        if (d->m_adaptorModel.canFetchMore())
-            QCoreApplication::postEvent(this, new QEvent(QEvent::UpdateRequest));
+        d->requestFetchMore();
     }
 }
 
@@ -395,6 +422,7 @@ void QQmlDelegateModel::setDelegate(QQmlComponent *delegate)
     bool wasValid = d->m_delegate != 0;
     d->m_delegate = delegate;
     d->m_delegateValidated = false;
+    d->drainReusePool();
     if (wasValid && d->m_complete) {
         for (int i = 1; i < d->m_groupCount; ++i) {
             QQmlDelegateModelGroupPrivate::get(d->m_groups[i])->changeSet.remove(
@@ -470,6 +498,87 @@ void QQmlDelegateModel::setRootIndex(const QVariant &root)
     }
 }
 
+/*!
+    \qmlproperty bool QtQml.Models::DelegateModel::reuseItems
+    \since 5.6
+
+    This property holds whether delegate instances released by a view are kept in a pool
+    and reused for other model items, instead of being destroyed and created again.
+
+    Reusing a delegate instance rebinds it to the new model item and re-evaluates its
+    bindings, which is considerably cheaper than creating a new instance.  Pooled instances
+    that are not reused within a second or two are destroyed.  The pool never holds more
+    instances than are in use, or 16 if fewer are in use; when a view shrinks, the instances
+    pooled longest are destroyed right away.
+    Delegates can react to being pooled and reused with the DelegateModel::pooled() and
+    DelegateModel::reused() attached signals.
+
+    Delegates that are \l Package objects, and models that expose QObject items through a
+    proxy, are never pooled.
+
+    The default value is \c false.
+*/
+bool QQmlDelegateModel::reuseItems() const
+{
+    Q_D(const QQmlDelegateModel);
+    return d->m_reuseItems;
+}
+
+void QQmlDelegateModel::setReuseItems(bool reuse)
+{
+    Q_D(QQmlDelegateModel);
+    if (d->m_reuseItems == reuse)
+        return;
+    d->m_reuseItems = reuse;
+    if (!reuse)
+        d->drainReusePool();
+    emit reuseItemsChanged();
+}
+
+/*!
+    \qmlproperty int QtQml.Models::DelegateModel::fetchMoreThreshold
+    \since 5.6
+
+    This property holds how many items from the end of the model an item must be
+    created at for more data to be requested from a model that supports
+    incremental loading with QAbstractItemModel::fetchMore().
+
+    By default more data is only requested once the last item is created, so a view
+    reaching the end of the available data has to wait for the next batch to be
+    loaded.  With a threshold covering a screen or so of items, and a model that
+    loads data in the background and inserts the rows once they are available,
+    the next batch is usually loaded before the view gets to it.
+
+    Requests are coalesced, so fetchMore() is called at most once per event loop
+    iteration however many items near the end are created.
+
+    The default value is \c 0.
+*/
+int QQmlDelegateModel::fetchMoreThreshold() const
+{
+    Q_D(const QQmlDelegateModel);
+    return d->m_fetchMoreThreshold;
+}
+
+void QQmlDelegateModel::setFetchMoreThreshold(int threshold)
+{
+    Q_D(QQmlDelegateModel);
+    threshold = qMax(0, threshold);
+    if (d->m_fetchMoreThreshold == threshold)
+        return;
+    d->m_fetchMoreThreshold = threshold;
+    emit fetchMoreThresholdChanged();
+}
+
+void QQmlDelegateModelPrivate::requestFetchMore()
+{
+    Q_Q(QQmlDelegateModel);
+    if (!m_fetchMoreRequested && m_adaptorModel.canFetchMore()) {
+        m_fetchMoreRequested = true;
+        QCoreApplication::postEvent(q, new QEvent(QEvent::UpdateRequest));
+    }
+}
+
 /*!
     \qmlmethod QModelIndex QtQml.Models::DelegateModel::modelIndex(int index)
 
@@ -525,7 +634,12 @@ QQmlDelegateModel::ReleaseFlags QQmlDelegateModelPrivate::release(QObject *objec
         return stat;
 
     if (QQmlDelegateModelItem *cacheItem = QQmlDelegateModelItem::dataForObject(object)) {
-        if (cacheItem->releaseObject()) {
+        if (!cacheItem->releaseObject()) {
+            stat |= QQmlDelegateModel::Referenced;
+        } else if (canPoolItem(cacheItem)) {
+            poolItem(cacheItem);
+            stat |= QQmlInstanceModel::Pooled;
+        } else {
             cacheItem->destroyObject();
             emitDestroyingItem(object);
             if (cacheItem->incubationTask) {
@@ -534,13 +648,112 @@ QQmlDelegateModel::ReleaseFlags QQmlDelegateModelPrivate::release(QObject *objec
             }
             cacheItem->Dispose();
             stat |= QQmlInstanceModel::Destroyed;
-        } else {
-            stat |= QQmlDelegateModel::Referenced;
         }
     }
     return stat;
 }
 
+/*
+  A released item can be pooled for reuse if nothing but its delegate object references it,
+  and the object is a plain delegate instance whose context can be rebound to another item.
+*/
+bool QQmlDelegateModelPrivate::canPoolItem(QQmlDelegateModelItem *cacheItem) const
+{
+    return m_reuseItems
+            && m_delegate
+            && cacheItem->object
+            && cacheItem->contextData
+            && !cacheItem->incubationTask
+            && cacheItem->scriptRef == 1
+            && !(cacheItem->groups & Compositor::UnresolvedFlag)
+            && !m_adaptorModel.hasProxyObject()
+            && !qmlobject_cast<QQuickPackage *>(cacheItem->object);
+}
+
+void QQmlDelegateModelPrivate::poolItem(QQmlDelegateModelItem *cacheItem)
+{
+    Q_Q(QQmlDelegateModel);
+
+    // The item keeps its object and model data alive while pooled, so that bindings which
+    // happen to be re-evaluated in the meantime still see consistent values, but it no
+    // longer takes part in the compositor and so no longer belongs to any group.
+    removeCacheItem(cacheItem);
+    cacheItem->groups = 0;
+    m_reusePool.append(cacheItem);
+
+    if (cacheItem->attached) {
+        cacheItem->attached->emitChanges();
+        emit cacheItem->attached->pooled();
+    }
+
+    if (!m_reusePoolTimer.isActive())
+        m_reusePoolTimer.start(QQmlDelegateModel_ReusePoolInterval, q);
+
+    // A view which shrinks or jumps would otherwise keep every delegate it released alive
+    // until the timer fires.
+    const int maximumSize = qMax(QQmlDelegateModel_MinimumReusePoolSize, m_cache.count());
+    if (m_reusePool.count() > maximumSize)
+        drainReusePool(m_reusePool.count() - maximumSize);
+}
+
+/*
+  Transfers the object of a pooled item to \a cacheItem, which must be in the cache and
+  have no object of its own.  The context of the object is rebound to \a cacheItem and every
+  binding in it and its child contexts is re-evaluated, so nothing keeps reading the model
+  data of the row the object was previously created for.  Returns false if there is no
+  pooled object available.
+*/
+bool QQmlDelegateModelPrivate::reuseItem(QQmlDelegateModelItem *cacheItem, int index)
+{
+    Q_Q(QQmlDelegateModel);
+    if (m_reusePool.isEmpty())
+        return false;
+
+    QQmlDelegateModelItem *pooledItem = m_reusePool.takeLast();
+    m_reusePoolStaleCount = qMin(m_reusePoolStaleCount, m_reusePool.count());
+    cacheItem->object = pooledItem->object;
+    cacheItem->contextData = pooledItem->contextData;
+    cacheItem->attached = pooledItem->attached;
+    cacheItem->scriptRef += 1;
+    pooledItem->object = 0;
+    pooledItem->contextData = 0;
+    pooledItem->attached = 0;
+    // Disposing of the pooled item before the refresh drops the guards bindings hold on its
+    // model data, so changes to the old row can no longer reach the reused object.
+    pooledItem->Dispose();
+
+    cacheItem->contextData->contextObject = cacheItem;
+    if (cacheItem->attached)
+        cacheItem->attached->setCacheItem(cacheItem);
+    cacheItem->contextData->refreshExpressions();
+
+    QObject *object = cacheItem->object;
+    emit q->initItem(index, object);
+    emit q->createdItem(index, object);
+    if (cacheItem->attached)
+        emit cacheItem->attached->reused();
+    return true;
+}
+
+/*
+  Destroys the \a count least recently pooled items, or all of them if \a count is -1.
+*/
+void QQmlDelegateModelPrivate::drainReusePool(int count)
+{
+    const QList<QQmlDelegateModelItem *> stale = m_reusePool.mid(0, count);
+    m_reusePool.erase(m_reusePool.begin(), m_reusePool.begin() + stale.count());
+    m_reusePoolStaleCount = qMax(0, m_reusePoolStaleCount - stale.count());
+    if (m_reusePool.isEmpty())
+        m_reusePoolTimer.stop();
+
+    foreach (QQmlDelegateModelItem *cacheItem, stale) {
+        QObject *object = cacheItem->object;
+        cacheItem->destroyObject();
+        emitDestroyingItem(object);
+        cacheItem->Dispose();
+    }
+}
+
 /*
   Returns ReleaseStatus flags.
 */
@@ -918,7 +1131,6 @@ void QQmlDelegateModelPrivate::setInitialState(QQDMIncubationTask *incubationTas
 
 QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, bool asynchronous)
 {
-    Q_Q(QQmlDelegateModel);
     if (!m_delegate || index < 0 || index >= m_compositor.count(group)) {
         qWarning() << "DelegateModel::item: index out range" << index << m_compositor.count(group);
         return 0;
@@ -952,7 +1164,7 @@ QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, bo
             // previously requested async - now needed immediately
             cacheItem->incubationTask->forceCompletion();
         }
-    } else if (!cacheItem->object) {
+    } else if (!cacheItem->object && !reuseItem(cacheItem, it.index[m_compositorGroup])) {
         QQmlContext *creationContext = m_delegate->creationContext();
 
         cacheItem->scriptRef += 1;
@@ -985,8 +1197,8 @@ QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, bo
                     QQmlContextData::get(m_context));
     }
 
-    if (index == m_compositor.count(group) - 1 && m_adaptorModel.canFetchMore())
-        QCoreApplication::postEvent(q, new QEvent(QEvent::UpdateRequest));
+    if (index >= m_compositor.count(group) - 1 - m_fetchMoreThreshold)
+        requestFetchMore();
 
     // Remove the temporary reference count.
     cacheItem->scriptRef -= 1;
@@ -1027,7 +1239,11 @@ QObject *QQmlDelegateModel::object(int index, bool asynchronous)
 
 QString QQmlDelegateModelPrivate::stringValue(Compositor::Group group, int index, const QString &name)
 {
-    Compositor::iterator it = m_compositor.find(group, index);
+    return variantValue(m_compositor.find(group, index), name).toString();
+}
+
+QVariant QQmlDelegateModelPrivate::variantValue(const Compositor::iterator &it, const QString &name)
+{
     if (QQmlAdaptorModel *model = it.list<QQmlAdaptorModel>()) {
         QString role = name;
         int dot = name.indexOf(QLatin1Char('.'));
@@ -1037,14 +1253,14 @@ QString QQmlDelegateModelPrivate::stringValue(Compositor::Group group, int index
         while (dot > 0) {
             QObject *obj = qvariant_cast<QObject*>(value);
             if (!obj)
-                return QString();
+                return QVariant();
             int from = dot+1;
             dot = name.indexOf(QLatin1Char('.'), from);
             value = obj->property(name.mid(from, dot-from).toUtf8());
         }
-        return value.toString();
+        return value;
     }
-    return QString();
+    return QVariant();
 }
 
 QString QQmlDelegateModel::stringValue(int index, const QString &name)
@@ -1106,11 +1322,18 @@ bool QQmlDelegateModel::event(QEvent *e)
 {
     Q_D(QQmlDelegateModel);
     if (e->type() == QEvent::UpdateRequest) {
+        d->m_fetchMoreRequested = false;
         d->m_adaptorModel.fetchMore();
     } else if (e->type() == QEvent::User) {
         d->m_incubatorCleanupScheduled = false;
         qDeleteAll(d->m_finishedIncubating);
         d->m_finishedIncubating.clear();
+    } else if (e->type() == QEvent::Timer
+            && static_cast<QTimerEvent *>(e)->timerId() == d->m_reusePoolTimer.timerId()) {
+        // Destroy the items which were already pooled at the previous interval.
+        d->drainReusePool(d->m_reusePoolStaleCount);
+        d->m_reusePoolStaleCount = d->m_reusePool.count();
+        return true;
     }
     return QQmlInstanceModel::event(e);
 }
@@ -1628,10 +1851,27 @@ void QQmlDelegateModel::_q_layoutChanged(const QList<QPersistentModelIndex> &par
     }
 }
 
+/*
+    Returns true if \a obj is the root object of the delegate currently being incubated for
+    \a cacheItem.  Attached objects are created for signal handlers such as
+    DelegateModel.onReused before the incubator hands the object over to the cache item.
+*/
+static bool isDelegateInCreation(QQmlDelegateModelItem *cacheItem, QObject *obj)
+{
+    if (cacheItem->object || !cacheItem->incubationTask)
+        return false;
+    QQmlData *ddata = QQmlData::get(obj);
+    if (!ddata || !ddata->rootObjectInCreation || !ddata->outerContext)
+        return false;
+    QQmlContextData *context = ddata->outerContext->parent;
+    return context && (context == cacheItem->contextData || context->parent == cacheItem->contextData);
+}
+
 QQmlDelegateModelAttached *QQmlDelegateModel::qmlAttachedProperties(QObject *obj)
 {
     if (QQmlDelegateModelItem *cacheItem = QQmlDelegateModelItem::dataForObject(obj)) {
-        if (cacheItem->object == obj) { // Don't create attached item for child objects.
+        // Don't create attached item for child objects.
+        if (cacheItem->object == obj || isDelegateInCreation(cacheItem, obj)) {
             cacheItem->attached = new QQmlDelegateModelAttached(cacheItem, obj);
             return cacheItem->attached;
         }
@@ -2120,6 +2360,26 @@ QQmlDelegateModelAttached::QQmlDelegateModelAttached(
     cacheItem->metaType->metaObject->addref();
 }
 
+/*
+    Rebinds the attached object of a reused delegate to \a item.  The indexes are always
+    notified, even if they happen to equal those of the item it was previously bound to,
+    as they now refer to another row.
+*/
+void QQmlDelegateModelAttached::setCacheItem(QQmlDelegateModelItem *item)
+{
+    m_cacheItem = item;
+
+    QQmlDelegateModelPrivate * const model = QQmlDelegateModelPrivate::get(m_cacheItem->metaType->model);
+    Compositor::iterator it = model->m_compositor.find(
+            Compositor::Cache, model->m_cache.indexOf(m_cacheItem));
+    for (int i = 1; i < m_cacheItem->metaType->groupCount; ++i) {
+        m_currentIndex[i] = it.index[i];
+        m_previousIndex[i] = -1;
+    }
+
+    emitChanges();
+}
+
 /*!
     \qmlattachedproperty int QtQml.Models::DelegateModel::model
 
@@ -2187,6 +2447,32 @@ bool QQmlDelegateModelAttached::isUnresolved() const
     return m_cacheItem->groups & Compositor::UnresolvedFlag;
 }
 
+/*!
+    \qmlattachedsignal QtQml.Models::DelegateModel::pooled()
+    \since 5.6
+
+    This signal is emitted when a delegate instance is released by a view and put in the
+    reuse pool instead of being destroyed.
+
+    It is attached to each instance of the delegate.
+
+    \sa reuseItems
+*/
+
+/*!
+    \qmlattachedsignal QtQml.Models::DelegateModel::reused()
+    \since 5.6
+
+    This signal is emitted when a pooled delegate instance is taken from the reuse pool to
+    represent another model item.  The bindings of the delegate have been re-evaluated
+    against the new model data by the time this signal is emitted, but properties that were
+    assigned imperatively keep their values, and should be reset in the handler if needed.
+
+    It is attached to each instance of the delegate.
+
+    \sa reuseItems
+*/
+
 /*!
     \qmlattachedproperty int QtQml.Models::DelegateModel::inItems
 
@@ -3014,6 +3300,291 @@ void QQmlDelegateModelGroup::move(QQmlV4Function *args)
 
 }
 
+namespace {
+/*
+    Values are ordered by their kind first: invalid values, booleans, numbers,
+    strings, date-times and then anything else by its string representation.
+    Comparing variants of different types directly is not a strict weak
+    ordering, which std::stable_sort() relies on.
+*/
+enum SortValueKind {
+    SortInvalid,
+    SortBool,
+    SortNumber,
+    SortString,
+    SortDateTime,
+    SortOther
+};
+
+SortValueKind qqmldelegatemodel_sortValueKind(const QVariant &value)
+{
+    switch (value.userType()) {
+    case QMetaType::UnknownType:
+    case QMetaType::Nullptr:
+    case QMetaType::VoidStar:
+        return SortInvalid;
+    case QMetaType::Bool:
+        return SortBool;
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+    case QMetaType::Float:
+    case QMetaType::Short:
+    case QMetaType::UShort:
+    case QMetaType::Long:
+    case QMetaType::ULong:
+    case QMetaType::SChar:
+    case QMetaType::UChar:
+        return SortNumber;
+    case QMetaType::QString:
+    case QMetaType::QChar:
+    case QMetaType::QByteArray:
+        return SortString;
+    case QMetaType::QDateTime:
+        return SortDateTime;
+    default:
+        return SortOther;
+    }
+}
+
+bool qqmldelegatemodel_sortLessThan(const QVariant &left, const QVariant &right)
+{
+    const SortValueKind leftKind = qqmldelegatemodel_sortValueKind(left);
+    const SortValueKind rightKind = qqmldelegatemodel_sortValueKind(right);
+    if (leftKind != rightKind)
+        return leftKind < rightKind;
+
+    switch (leftKind) {
+    case SortInvalid:
+        return false;
+    case SortBool:
+        return !left.toBool() && right.toBool();
+    case SortNumber: {
+        const double l = left.toDouble();
+        const double r = right.toDouble();
+        // NaN is placed before all other numbers.
+        if (qIsNaN(l) || qIsNaN(r))
+            return qIsNaN(l) && !qIsNaN(r);
+        return l < r; }
+    case SortDateTime:
+        return left.toDateTime() < right.toDateTime();
+    case SortString:
+    case SortOther:
+        break;
+    }
+    return left.toString() < right.toString();
+}
+
+class QQmlDelegateModelGroupLessThan
+{
+public:
+    QQmlDelegateModelGroupLessThan(const QVector<QVariant> &values, bool descending)
+        : m_values(values), m_descending(descending) {}
+
+    bool operator()(int left, int right) const
+    {
+        return m_descending
+                ? qqmldelegatemodel_sortLessThan(m_values.at(right), m_values.at(left))
+                : qqmldelegatemodel_sortLessThan(m_values.at(left), m_values.at(right));
+    }
+
+private:
+    const QVector<QVariant> &m_values;
+    const bool m_descending;
+};
+}
+
+/*!
+    \qmlmethod QtQml.Models::DelegateModelGroup::sort(string role, enumeration order)
+    \since 5.6
+
+    Sorts the items in the group by the value of their \a role, in ascending
+    order unless \a order is \c Qt.DescendingOrder. Items with equal values
+    keep their relative order. As with the section property of views, the
+    \a role may refer to a property of an object role, for example
+    \c "person.name".
+
+    The items are moved into place as a single change, which is considerably
+    faster than sorting the group with move() from JavaScript.
+
+    Values of different types are ordered by type: items without a value
+    come first, followed by booleans, numbers, strings, dates and any other
+    values, which are compared by their string representation.
+
+    Sorting is not maintained when the values of items change or when items
+    are added to the group.
+*/
+
+void QQmlDelegateModelGroup::sort(QQmlV4Function *args)
+{
+    Q_D(QQmlDelegateModelGroup);
+
+    if (!d->model)
+        return;
+
+    QV4::Scope scope(args->v4engine());
+    QV4::ScopedValue v(scope, args->length() > 0 ? (*args)[0] : QV4::Primitive::undefinedValue());
+    if (!v->isString()) {
+        qmlInfo(this) << tr("sort: invalid role");
+        return;
+    }
+    const QString role = v->toQString();
+
+    bool descending = false;
+    if (args->length() > 1) {
+        v = (*args)[1];
+        descending = v->toInt32() == Qt::DescendingOrder;
+    }
+
+    QQmlDelegateModelPrivate *model = QQmlDelegateModelPrivate::get(d->model);
+    const int count = model->m_compositor.count(d->group);
+    if (count < 2)
+        return;
+
+    QVector<QVariant> values;
+    values.reserve(count);
+    Compositor::iterator it = model->m_compositor.find(d->group, 0);
+    for (int i = 0; i < count; ++i) {
+        if (i > 0)
+            it += 1;
+        values.append(model->variantValue(it, role));
+    }
+
+    QVector<int> order(count);
+    for (int i = 0; i < count; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), QQmlDelegateModelGroupLessThan(values, descending));
+
+    // Move the items into place from front to back.  The items which have not been placed
+    // yet keep their original relative order behind the placed ones, so the current index of
+    // an item is the number of placed items plus the number of unplaced items originally
+    // preceding it, which is counted with a binary indexed tree.
+    QVector<int> unplaced(count + 1, 0);
+    for (int i = 1; i <= count; ++i) {
+        unplaced[i] += 1;
+        const int parent = i + (i & -i);
+        if (parent <= count)
+            unplaced[parent] += unplaced[i];
+    }
+
+    bool moved = false;
+    for (int i = 0; i < count;) {
+        int from = i;
+        for (int j = order.at(i); j > 0; j -= j & -j)
+            from += unplaced.at(j);
+
+        // Items which follow each other in the original order are still adjacent.
+        int n = 1;
+        while (i + n < count && order.at(i + n) == order.at(i + n - 1) + 1)
+            ++n;
+
+        if (from != i) {
+            QVector<Compositor::Remove> removes;
+            QVector<Compositor::Insert> inserts;
+            model->m_compositor.move(d->group, from, d->group, i, n, d->group, &removes, &inserts);
+            model->itemsMoved(removes, inserts);
+            moved = true;
+        }
+
+        for (int k = 0; k < n; ++k) {
+            for (int j = order.at(i + k) + 1; j <= count; j += j & -j)
+                unplaced[j] -= 1;
+        }
+        i += n;
+    }
+
+    if (moved)
+        model->emitChanges();
+}
+
+/*!
+    \qmlmethod QtQml.Models::DelegateModelGroup::filter(string role)
+    \since 5.6
+
+    Adds the items of the DelegateModel's \l {DelegateModel::items}{items}
+    group for which the value of \a role is \c true to this group, and
+    removes the ones for which it is \c false.
+
+    Together with \l {DelegateModel::filterOnGroup}{filterOnGroup} this
+    filters the items shown by a view without iterating over the items from
+    JavaScript:
+
+    \code
+    DelegateModel {
+        id: visualModel
+        filterOnGroup: "visible"
+        groups: DelegateModelGroup { id: visibleItems; name: "visible" }
+        Component.onCompleted: visibleItems.filter("enabled")
+    }
+    \endcode
+
+    Membership is not updated when the values of items change.
+*/
+
+void QQmlDelegateModelGroup::filter(QQmlV4Function *args)
+{
+    Q_D(QQmlDelegateModelGroup);
+
+    if (!d->model)
+        return;
+
+    QV4::Scope scope(args->v4engine());
+    QV4::ScopedValue v(scope, args->length() > 0 ? (*args)[0] : QV4::Primitive::undefinedValue());
+    if (!v->isString()) {
+        qmlInfo(this) << tr("filter: invalid role");
+        return;
+    }
+    if (d->group == Compositor::Default) {
+        qmlInfo(this) << tr("filter: the items group cannot be filtered");
+        return;
+    }
+    const QString role = v->toQString();
+
+    QQmlDelegateModelPrivate *model = QQmlDelegateModelPrivate::get(d->model);
+    const int count = model->m_compositor.count(Compositor::Default);
+    if (count == 0)
+        return;
+
+    // Collect consecutive runs of items whose membership changes, indexes in the items group
+    // are not affected by changing the membership of other groups.
+    QVector<QPair<int, int> > additions;
+    QVector<QPair<int, int> > removals;
+    Compositor::iterator it = model->m_compositor.find(Compositor::Default, 0);
+    for (int i = 0; i < count; ++i) {
+        if (i > 0)
+            it += 1;
+        const bool include = model->variantValue(it, role).toBool();
+        if (include == it->inGroup(d->group))
+            continue;
+
+        QVector<QPair<int, int> > &runs = include ? additions : removals;
+        if (!runs.isEmpty() && runs.last().first + runs.last().second == i)
+            runs.last().second += 1;
+        else
+            runs.append(qMakePair(i, 1));
+    }
+
+    if (additions.isEmpty() && removals.isEmpty())
+        return;
+
+    const int groupFlag = 1 << d->group;
+    for (int i = 0; i < additions.count(); ++i) {
+        QVector<Compositor::Insert> inserts;
+        model->m_compositor.setFlags(
+                Compositor::Default, additions.at(i).first, additions.at(i).second, groupFlag, &inserts);
+        model->itemsInserted(inserts);
+    }
+    for (int i = 0; i < removals.count(); ++i) {
+        QVector<Compositor::Remove> removes;
+        model->m_compositor.clearFlags(
+                Compositor::Default, removals.at(i).first, removals.at(i).second, groupFlag, &removes);
+        model->itemsRemoved(removes);
+    }
+    model->emitChanges();
+}
+
 /*!
     \qmlsignal QtQml.Models::DelegateModelGroup::changed(array removed, array inserted)
 
@@ -79,6 +79,8 @@ class Q_QML_PRIVATE_EXPORT QQmlDelegateModel : public QQmlInstanceModel, public
     Q_PROPERTY(QQmlListProperty<QQmlDelegateModelGroup> groups READ groups CONSTANT)
     Q_PROPERTY(QObject *parts READ parts CONSTANT)
     Q_PROPERTY(QVariant rootIndex READ rootIndex WRITE setRootIndex NOTIFY rootIndexChanged)
+    Q_PROPERTY(bool reuseItems READ reuseItems WRITE setReuseItems NOTIFY reuseItemsChanged REVISION 3)
+    Q_PROPERTY(int fetchMoreThreshold READ fetchMoreThreshold WRITE setFetchMoreThreshold NOTIFY fetchMoreThresholdChanged REVISION 3)
     Q_CLASSINFO("DefaultProperty", "delegate")
     Q_INTERFACES(QQmlParserStatus)
 public:
@@ -98,6 +100,12 @@ public:
     QVariant rootIndex() const;
     void setRootIndex(const QVariant &root);
 
+    bool reuseItems() const;
+    void setReuseItems(bool reuse);
+
+    int fetchMoreThreshold() const;
+    void setFetchMoreThreshold(int threshold);
+
     Q_INVOKABLE QVariant modelIndex(int idx) const;
     Q_INVOKABLE QVariant parentModelIndex() const;
 
@@ -128,6 +136,8 @@ Q_SIGNALS:
     void filterGroupChanged();
     void defaultGroupsChanged();
     void rootIndexChanged();
+    Q_REVISION(3) void reuseItemsChanged();
+    Q_REVISION(3) void fetchMoreThresholdChanged();
 
 private Q_SLOTS:
     void _q_itemsChanged(int index, int count, const QVector<int> &roles);
@@ -180,6 +190,8 @@ public Q_SLOTS:
     void removeGroups(QQmlV4Function *);
     void setGroups(QQmlV4Function *);
     void move(QQmlV4Function *);
+    Q_REVISION(3) void sort(QQmlV4Function *);
+    Q_REVISION(3) void filter(QQmlV4Function *);
 
 Q_SIGNALS:
     void countChanged();
@@ -219,6 +231,8 @@ public:
 Q_SIGNALS:
     void groupsChanged();
     void unresolvedChanged();
+    void pooled();
+    void reused();
 
 public:
     QQmlDelegateModelItem *m_cacheItem;
@@ -40,6 +40,8 @@
 #include <QtQml/qqmlcontext.h>
 #include <QtQml/qqmlincubator.h>
 
+#include <QtCore/qbasictimer.h>
+
 #include <private/qqmladaptormodel_p.h>
 #include <private/qqmlopenmetaobject_p.h>
 
@@ -257,6 +259,7 @@ public:
     QObject *object(Compositor::Group group, int index, bool asynchronous);
     QQmlDelegateModel::ReleaseFlags release(QObject *object);
     QString stringValue(Compositor::Group group, int index, const QString &name);
+    QVariant variantValue(const Compositor::iterator &it, const QString &name);
     void emitCreatedPackage(QQDMIncubationTask *incubationTask, QQuickPackage *package);
     void emitInitPackage(QQDMIncubationTask *incubationTask, QQuickPackage *package);
     void emitCreatedItem(QQDMIncubationTask *incubationTask, QObject *item) {
@@ -296,6 +299,11 @@ public:
     static QQmlDelegateModelGroup *group_at(QQmlListProperty<QQmlDelegateModelGroup> *property, int index);
 
     void releaseIncubator(QQDMIncubationTask *incubationTask);
+    bool canPoolItem(QQmlDelegateModelItem *cacheItem) const;
+    void poolItem(QQmlDelegateModelItem *cacheItem);
+    bool reuseItem(QQmlDelegateModelItem *cacheItem, int index);
+    void drainReusePool(int count = -1);
+    void requestFetchMore();
     void incubatorStatusChanged(QQDMIncubationTask *incubationTask, QQmlIncubator::Status status);
     void setInitialState(QQDMIncubationTask *incubationTask, QObject *o);
 
@@ -309,12 +317,16 @@ public:
 
     QList<QQmlDelegateModelItem *> m_cache;
     QList<QQDMIncubationTask *> m_finishedIncubating;
+    QList<QQmlDelegateModelItem *> m_reusePool;
+    QBasicTimer m_reusePoolTimer;
     QList<QByteArray> m_watchedRoles;
 
     QString m_filterGroup;
 
     int m_count;
     int m_groupCount;
+    int m_reusePoolStaleCount;
+    int m_fetchMoreThreshold;
 
     QQmlListCompositor::Group m_compositorGroup;
     bool m_complete : 1;
@@ -322,6 +334,8 @@ public:
     bool m_reset : 1;
     bool m_transaction : 1;
     bool m_incubatorCleanupScheduled : 1;
+    bool m_reuseItems : 1;
+    bool m_fetchMoreRequested : 1;
 
     union {
         struct {
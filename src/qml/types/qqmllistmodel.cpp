@@ -56,6 +56,8 @@
 #include <QtCore/qdatetime.h>
 #include <QScopedValueRollback>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 // Set to 1024 as a debugging aid - easier to distinguish uids from indices of elements/models.
@@ -251,6 +253,7 @@ QObject *ListModel::getOrCreateModelObject(QQmlListModel *model, int elementInde
     if (e->m_objectCache == 0) {
         e->m_objectCache = new QObject;
         (void)new ModelNodeMetaObject(e->m_objectCache, model, elementIndex);
+        ++m_objectCacheCount;
     }
     return e->m_objectCache;
 }
@@ -316,17 +319,33 @@ void ListModel::sync(ListModel *src, ListModel *target, QHash<int, ListModel *>
         target->elements.append(targetElement);
     }
 
-    target->updateCacheIndices();
-
-    // Update values stored in target meta objects
+    // Update indices and values stored in target meta objects
+    target->m_objectCacheCount = 0;
     for (int i=0 ; i < target->elements.count() ; ++i) {
         ListElement *e = target->elements[i];
-        if (ModelNodeMetaObject *mo = e->objectCache())
+        if (ModelNodeMetaObject *mo = e->objectCache()) {
+            mo->m_elementIndex = i;
             mo->updateValues();
+            ++target->m_objectCacheCount;
+        }
     }
 }
 
-ListModel::ListModel(ListLayout *layout, QQmlListModel *modelCache, int uid) : m_layout(layout), m_modelCache(modelCache)
+// Copies the element at \a elementIndex of \a src to the element at the same index,
+// which takes over the identity of the source element. The layouts must be in sync.
+void ListModel::syncElement(ListModel *src, int elementIndex)
+{
+    ListElement *srcElement = src->elements[elementIndex];
+    ListElement *targetElement = elements[elementIndex];
+
+    targetElement->uid = srcElement->uid;
+    ListElement::sync(srcElement, src->m_layout, targetElement, m_layout, 0);
+
+    if (ModelNodeMetaObject *mo = targetElement->objectCache())
+        mo->updateValues();
+}
+
+ListModel::ListModel(ListLayout *layout, QQmlListModel *modelCache, int uid) : m_layout(layout), m_modelCache(modelCache), m_objectCacheCount(0)
 {
     if (uid == -1)
         uid = uidCounter.fetchAndAddOrdered(1);
@@ -353,7 +372,7 @@ int ListModel::appendElement()
 void ListModel::insertElement(int index)
 {
     newElement(index);
-    updateCacheIndices();
+    updateCacheIndices(index);
 }
 
 void ListModel::move(int from, int to, int n)
@@ -375,7 +394,7 @@ void ListModel::move(int from, int to, int n)
     for (int i=0 ; i < store.count() ; ++i)
         elements[from+i] = store[i];
 
-    updateCacheIndices();
+    updateCacheIndices(from, to + n);
 }
 
 void ListModel::newElement(int index)
@@ -384,9 +403,16 @@ void ListModel::newElement(int index)
     elements.insert(index, e);
 }
 
-void ListModel::updateCacheIndices()
+void ListModel::updateCacheIndices(int start, int end)
 {
-    for (int i=0 ; i < elements.count() ; ++i) {
+    // Only elements that have been accessed through get() store their index. Avoid touching
+    // every element of large models if there are none.
+    if (!m_objectCacheCount)
+        return;
+
+    if (end < 0 || end > elements.count())
+        end = elements.count();
+    for (int i=start ; i < end ; ++i) {
         ListElement *e = elements.at(i);
         if (ModelNodeMetaObject *mo = e->objectCache())
             mo->m_elementIndex = i;
@@ -559,16 +585,19 @@ void ListModel::clear()
         delete elements[i];
     }
     elements.clear();
+    m_objectCacheCount = 0;
 }
 
 void ListModel::remove(int index, int count)
 {
     for (int i=0 ; i < count ; ++i) {
+        if (elements[index+i]->m_objectCache)
+            --m_objectCacheCount;
         elements[index+i]->destroy(m_layout);
         delete elements[index+i];
     }
     elements.remove(index, count);
-    updateCacheIndices();
+    updateCacheIndices(index);
 }
 
 void ListModel::insert(int elementIndex, QV4::Object *object)
@@ -1660,6 +1689,9 @@ QQmlListModel::QQmlListModel(QObject *parent)
     m_agent = 0;
     m_uid = uidCounter.fetchAndAddOrdered(1);
     m_dynamicRoles = false;
+    m_batchDepth = 0;
+    m_batchChangedStart = m_batchChangedEnd = 0;
+    m_batchChangedAllRoles = false;
 
     m_layout = new ListLayout;
     m_listModel = new ListModel(m_layout, this, -1);
@@ -1676,6 +1708,9 @@ QQmlListModel::QQmlListModel(const QQmlListModel *owner, ListModel *data, QV4::E
 
     Q_ASSERT(owner->m_dynamicRoles == false);
     m_dynamicRoles = false;
+    m_batchDepth = 0;
+    m_batchChangedStart = m_batchChangedEnd = 0;
+    m_batchChangedAllRoles = false;
     m_layout = 0;
     m_listModel = data;
 
@@ -1689,6 +1724,9 @@ QQmlListModel::QQmlListModel(QQmlListModel *orig, QQmlListModelWorkerAgent *agen
     m_primary = true;
     m_agent = agent;
     m_dynamicRoles = orig->m_dynamicRoles;
+    m_batchDepth = 0;
+    m_batchChangedStart = m_batchChangedEnd = 0;
+    m_batchChangedAllRoles = false;
 
     m_layout = new ListLayout(orig->m_layout);
     m_listModel = new ListModel(m_layout, this, orig->m_listModel->getUid());
@@ -1814,6 +1852,51 @@ void QQmlListModel::emitItemsChanged(int index, int count, const QVector<int> &r
     if (count <= 0)
         return;
 
+    if (m_batchDepth) {
+        if (m_batchChangedStart == m_batchChangedEnd) {
+            m_batchChangedStart = index;
+            m_batchChangedEnd = index + count;
+        } else {
+            m_batchChangedStart = qMin(m_batchChangedStart, index);
+            m_batchChangedEnd = qMax(m_batchChangedEnd, index + count);
+        }
+        // No roles means that all of them may have changed, which no union
+        // of specific roles can express.
+        if (roles.isEmpty()) {
+            m_batchChangedAllRoles = true;
+        } else if (!m_batchChangedAllRoles) {
+            for (int i = 0; i < roles.count(); ++i) {
+                if (!m_batchChangedRoles.contains(roles.at(i)))
+                    m_batchChangedRoles.append(roles.at(i));
+            }
+        }
+        return;
+    }
+
+    sendItemsChanged(index, count, roles);
+}
+
+// Reports the item changes collected since the batch began, or since the last structural
+// change within the batch, as the indexes they refer to are only valid until then.
+void QQmlListModel::emitBatchedItemsChanged()
+{
+    if (m_batchChangedStart == m_batchChangedEnd)
+        return;
+
+    const int index = m_batchChangedStart;
+    const int count = m_batchChangedEnd - m_batchChangedStart;
+    QVector<int> roles;
+    roles.swap(m_batchChangedRoles);
+    if (m_batchChangedAllRoles)
+        roles.clear();
+    m_batchChangedStart = m_batchChangedEnd = 0;
+    m_batchChangedAllRoles = false;
+
+    sendItemsChanged(index, count, roles);
+}
+
+void QQmlListModel::sendItemsChanged(int index, int count, const QVector<int> &roles)
+{
     if (m_mainThread) {
         emit dataChanged(createIndex(index, 0), createIndex(index + count - 1, 0), roles);;
     } else {
@@ -1824,6 +1907,8 @@ void QQmlListModel::emitItemsChanged(int index, int count, const QVector<int> &r
 
 void QQmlListModel::emitItemsAboutToBeRemoved(int index, int count)
 {
+    emitBatchedItemsChanged();
+
     if (count <= 0 || !m_mainThread)
         return;
 
@@ -1848,6 +1933,8 @@ void QQmlListModel::emitItemsRemoved(int index, int count)
 
 void QQmlListModel::emitItemsAboutToBeInserted(int index, int count)
 {
+    emitBatchedItemsChanged();
+
     if (count <= 0 || !m_mainThread)
         return;
 
@@ -1870,6 +1957,8 @@ void QQmlListModel::emitItemsInserted(int index, int count)
 
 void QQmlListModel::emitItemsAboutToBeMoved(int from, int to, int n)
 {
+    emitBatchedItemsChanged();
+
     if (n <= 0 || !m_mainThread)
         return;
 
@@ -2425,6 +2514,137 @@ void QQmlListModel::setProperty(int index, const QString& property, const QVaria
     }
 }
 
+/*!
+    \qmlmethod ListModel::setRows(int index, array rows)
+    \since QtQml.Models 2.3
+
+    Changes the items starting at \a index in the list model with the
+    values in the objects of the \a rows array, as if set() was called
+    for each of them. Rows that lie beyond the end of the list are
+    appended.
+
+    Attached views are notified of all changed items and of all
+    appended items at once, which is considerably cheaper than calling
+    set() for every row.
+
+    \code
+        fruitModel.setRows(0, [{"cost": 5.95}, {"cost": 2.45}, {"cost": 1.95}])
+    \endcode
+
+    \sa set(), append(), beginBatch()
+*/
+void QQmlListModel::setRows(QQmlV4Function *args)
+{
+    if (args->length() != 2) {
+        qmlInfo(this) << tr("setRows: incorrect number of arguments");
+        return;
+    }
+
+    QV4::Scope scope(args->v4engine());
+    int index = QV4::ScopedValue(scope, (*args)[0])->toInt32();
+    QV4::ScopedArrayObject objectArray(scope, (*args)[1]);
+
+    if (!objectArray) {
+        qmlInfo(this) << tr("setRows: value is not an array");
+        return;
+    }
+    if (index > count() || index < 0) {
+        qmlInfo(this) << tr("setRows: index %1 out of range").arg(index);
+        return;
+    }
+
+    const int objectArrayLength = objectArray->getLength();
+    const int changedCount = qMin(objectArrayLength, count() - index);
+    QV4::ScopedObject argObject(scope);
+
+    QVector<int> roles;
+    for (int i = 0; i < changedCount; ++i) {
+        argObject = objectArray->getIndexed(i);
+        if (!argObject)
+            continue;
+
+        if (m_dynamicRoles)
+            m_modelObjects[index + i]->updateValues(scope.engine->variantMapFromJS(argObject), roles);
+        else
+            m_listModel->set(index + i, argObject, &roles);
+    }
+
+    // Rows set to the values they already had add no roles, so if none of
+    // the rows changed there is nothing to report. An empty vector must not
+    // be passed on, as it would tell views that all roles changed.
+    if (!roles.isEmpty()) {
+        std::sort(roles.begin(), roles.end());
+        roles.erase(std::unique(roles.begin(), roles.end()), roles.end());
+        emitItemsChanged(index, changedCount, roles);
+    }
+
+    const int insertIndex = index + changedCount;
+    const int insertCount = objectArrayLength - changedCount;
+    if (insertCount <= 0)
+        return;
+
+    emitItemsAboutToBeInserted(insertIndex, insertCount);
+    for (int i = changedCount; i < objectArrayLength; ++i) {
+        argObject = objectArray->getIndexed(i);
+
+        if (m_dynamicRoles)
+            m_modelObjects.append(DynamicRoleModelNode::create(scope.engine->variantMapFromJS(argObject), this));
+        else
+            m_listModel->append(argObject);
+    }
+    emitItemsInserted(insertIndex, insertCount);
+}
+
+/*!
+    \qmlmethod ListModel::beginBatch()
+    \since QtQml.Models 2.3
+
+    Starts collecting changes to the values of existing items, so that
+    attached views are notified of them once when endBatch() is called,
+    rather than once for every call to set(), setProperty() or every
+    assignment through the object returned by get().
+
+    Items that are inserted, removed or moved while a batch is in
+    progress are still reported immediately, after the changes
+    collected up to that point.
+
+    Batches may be nested; the changes are reported when the outermost
+    batch ends.
+
+    \code
+        fruitModel.beginBatch()
+        for (var i = 0; i < fruitModel.count; ++i)
+            fruitModel.setProperty(i, "cost", fruitModel.get(i).cost * 1.1)
+        fruitModel.endBatch()
+    \endcode
+
+    \sa endBatch()
+*/
+void QQmlListModel::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+/*!
+    \qmlmethod ListModel::endBatch()
+    \since QtQml.Models 2.3
+
+    Ends a batch started with beginBatch() and notifies attached views
+    of the item changes made during it.
+
+    \sa beginBatch()
+*/
+void QQmlListModel::endBatch()
+{
+    if (m_batchDepth == 0) {
+        qmlInfo(this) << tr("endBatch: no batch in progress");
+        return;
+    }
+
+    if (--m_batchDepth == 0)
+        emitBatchedItemsChanged();
+}
+
 /*!
     \qmlmethod ListModel::sync()
 
@@ -95,8 +95,11 @@ public:
     Q_INVOKABLE QQmlV4Handle get(int index) const;
     Q_INVOKABLE void set(int index, const QQmlV4Handle &);
     Q_INVOKABLE void setProperty(int index, const QString& property, const QVariant& value);
+    Q_REVISION(3) Q_INVOKABLE void setRows(QQmlV4Function *args);
     Q_INVOKABLE void move(int from, int to, int count);
     Q_INVOKABLE void sync();
+    Q_REVISION(3) Q_INVOKABLE void beginBatch();
+    Q_REVISION(3) Q_INVOKABLE void endBatch();
 
     QQmlListModelWorkerAgent *agent();
 
@@ -139,6 +142,13 @@ private:
     QVector<QString> m_roles;
     int m_uid;
 
+    // Item changes made between beginBatch() and endBatch() are reported together
+    int m_batchDepth;
+    int m_batchChangedStart;
+    int m_batchChangedEnd;
+    QVector<int> m_batchChangedRoles;
+    bool m_batchChangedAllRoles;
+
     struct ElementSync
     {
         ElementSync() : src(0), target(0) {}
@@ -153,6 +163,8 @@ private:
     static QQmlListModel *createWithOwner(QQmlListModel *newOwner);
 
     void emitItemsChanged(int index, int count, const QVector<int> &roles);
+    void emitBatchedItemsChanged();
+    void sendItemsChanged(int index, int count, const QVector<int> &roles);
     void emitItemsAboutToBeRemoved(int index, int count);
     void emitItemsRemoved(int index, int count);
     void emitItemsAboutToBeInserted(int index, int count);
@@ -367,6 +367,7 @@ public:
     int getUid() const { return m_uid; }
 
     static void sync(ListModel *src, ListModel *target, QHash<int, ListModel *> *srcModelHash);
+    void syncElement(ListModel *src, int elementIndex);
 
     QObject *getOrCreateModelObject(QQmlListModel *model, int elementIndex);
 
@@ -376,6 +377,7 @@ private:
     int m_uid;
 
     QQmlListModel *m_modelCache;
+    int m_objectCacheCount;
 
     struct ElementSync
     {
@@ -387,7 +389,7 @@ private:
 
     void newElement(int index);
 
-    void updateCacheIndices();
+    void updateCacheIndices(int start = 0, int end = -1);
 
     friend class ListElement;
     friend class QQmlListModelWorkerAgent;
@@ -41,6 +41,8 @@
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qdebug.h>
 
+#include <algorithm>
+
 
 QT_BEGIN_NAMESPACE
 
@@ -75,6 +77,23 @@ void QQmlListModelWorkerAgent::Data::moveChange(int uid, int index, int count, i
 
 void QQmlListModelWorkerAgent::Data::changedChange(int uid, int index, int count, const QVector<int> &roles)
 {
+    // Workers typically update many rows between two syncs, merge changes of overlapping
+    // or adjacent rows.
+    if (!changes.isEmpty()) {
+        Change &last = changes.last();
+        if (last.modelUid == uid && last.type == Change::Changed
+                && index <= last.index + last.count && last.index <= index + count) {
+            const int end = qMax(last.index + last.count, index + count);
+            last.index = qMin(last.index, index);
+            last.count = end - last.index;
+            for (int i = 0; i < roles.count(); ++i) {
+                if (!last.roles.contains(roles.at(i)))
+                    last.roles.append(roles.at(i));
+            }
+            return;
+        }
+    }
+
     Change c = { uid, Change::Changed, index, count, 0, roles };
     changes << c;
 }
@@ -159,6 +178,81 @@ void QQmlListModelWorkerAgent::move(int from, int to, int count)
     m_copy->move(from, to, count);
 }
 
+/*
+    Replays the structural \a changes made to the worker's copy \a src of the model
+    on \a target and copies only the elements that have been changed or inserted,
+    rather than comparing the complete models. Returns false if the changes cannot be
+    replayed, e.g. because they involve nested list models, in which case the models
+    have to be compared.
+*/
+bool QQmlListModelWorkerAgent::syncChanges(ListModel *src, ListModel *target, const QList<Change> &changes)
+{
+    const int uid = src->getUid();
+    if (target->getUid() != uid)
+        return false;
+    for (int ii = 0; ii < changes.count(); ++ii) {
+        if (changes.at(ii).modelUid != uid)
+            return false;
+    }
+
+    QVector<bool> dirty(target->elementCount(), false);
+
+    for (int ii = 0; ii < changes.count(); ++ii) {
+        const Change &change = changes.at(ii);
+        const int count = dirty.count();
+        switch (change.type) {
+        case Change::Inserted:
+            if (change.index < 0 || change.index > count)
+                return false;
+            for (int i = 0; i < change.count; ++i)
+                target->insertElement(change.index + i);
+            dirty.insert(change.index, change.count, true);
+            break;
+        case Change::Removed:
+            if (change.index == 0 && change.count >= count) {
+                // Changes that preceded a clear() are dropped from the log
+                target->clear();
+                dirty.clear();
+            } else if (change.index < 0 || change.index + change.count > count) {
+                return false;
+            } else {
+                target->remove(change.index, change.count);
+                dirty.remove(change.index, change.count);
+            }
+            break;
+        case Change::Moved:
+            if (change.index < 0 || change.to < 0
+                    || change.index + change.count > count || change.to + change.count > count) {
+                return false;
+            }
+            target->move(change.index, change.to, change.count);
+            if (change.index < change.to) {
+                std::rotate(dirty.begin() + change.index, dirty.begin() + change.index + change.count,
+                            dirty.begin() + change.to + change.count);
+            } else {
+                std::rotate(dirty.begin() + change.to, dirty.begin() + change.index,
+                            dirty.begin() + change.index + change.count);
+            }
+            break;
+        case Change::Changed:
+            for (int i = qMax(0, change.index); i < qMin(count, change.index + change.count); ++i)
+                dirty[i] = true;
+            break;
+        }
+    }
+
+    if (dirty.count() != src->elementCount())
+        return false;
+
+    ListLayout::sync(src->m_layout, target->m_layout);
+    for (int i = 0; i < dirty.count(); ++i) {
+        if (dirty.at(i))
+            target->syncElement(src, i);
+    }
+
+    return true;
+}
+
 void QQmlListModelWorkerAgent::sync()
 {
     Sync *s = new Sync;
@@ -189,6 +283,8 @@ bool QQmlListModelWorkerAgent::event(QEvent *e)
             Q_ASSERT(m_orig->m_dynamicRoles == s->list->m_dynamicRoles);
             if (m_orig->m_dynamicRoles)
                 QQmlListModel::sync(s->list, m_orig, &targetModelDynamicHash);
+            else if (syncChanges(s->list->m_listModel, m_orig->m_listModel, changes))
+                targetModelStaticHash.insert(m_orig->m_listModel->getUid(), m_orig->m_listModel);
             else
                 ListModel::sync(s->list->m_listModel, m_orig->m_listModel, &targetModelStaticHash);
 
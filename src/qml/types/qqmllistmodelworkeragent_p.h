@@ -56,6 +56,7 @@ QT_BEGIN_NAMESPACE
 
 
 class QQmlListModel;
+class ListModel;
 
 class QQmlListModelWorkerAgent : public QObject
 {
@@ -129,6 +130,8 @@ private:
     };
     Data data;
 
+    static bool syncChanges(ListModel *src, ListModel *target, const QList<Change> &changes);
+
     struct Sync : public QEvent {
         Sync() : QEvent(QEvent::User) {}
         Data data;
@@ -105,6 +105,9 @@ public:
 
     VDMModelDelegateDataType *type;
     QVector<QVariant> cachedData;
+
+protected:
+    void connectNotify(const QMetaMethod &signal);
 };
 
 class VDMModelDelegateDataType
@@ -148,22 +151,19 @@ public:
             const_cast<VDMModelDelegateDataType *>(this)->watchedRoleIds = roleIds;
         }
 
-        QVector<int> signalIndexes;
-        for (int i = 0; i < roles.count(); ++i) {
-            const int role = roles.at(i);
-            if (!changed && watchedRoleIds.contains(role))
-                changed = true;
+        for (int i = 0; !changed && i < roles.count(); ++i)
+            changed = watchedRoleIds.contains(roles.at(i));
 
-            int propertyId = propertyRoles.indexOf(role);
-            if (propertyId != -1)
-                signalIndexes.append(propertyId + signalOffset);
-        }
-        if (roles.isEmpty()) {
-            const int propertyRolesCount = propertyRoles.count();
-            signalIndexes.reserve(propertyRolesCount);
-            for (int propertyId = 0; propertyId < propertyRolesCount; ++propertyId)
+        // Delegates typically only reference a few of the roles a model provides, so rather than
+        // emitting a change signal for every role only those which are connected to are notified.
+        QVector<int> signalIndexes;
+        for (int i = 0; i < connectedPropertyIds.count(); ++i) {
+            const int propertyId = connectedPropertyIds.at(i);
+            if (roles.isEmpty() || roles.contains(propertyRoles.at(propertyId)))
                 signalIndexes.append(propertyId + signalOffset);
         }
+        if (signalIndexes.isEmpty())
+            return changed;
 
         for (int i = 0, c = items.count();  i < c; ++i) {
             QQmlDelegateModelItem *item = items.at(i);
@@ -245,6 +245,7 @@ public:
 
     QV4::PersistentValue prototype;
     QList<int> propertyRoles;
+    QList<int> connectedPropertyIds;
     QList<int> watchedRoleIds;
     QList<QByteArray> watchedRoles;
     QHash<QByteArray, int> roleNames;
@@ -307,6 +308,13 @@ int QQmlDMCachedModelData::metaCall(QMetaObject::Call call, int id, void **argum
     }
 }
 
+void QQmlDMCachedModelData::connectNotify(const QMetaMethod &signal)
+{
+    const int propertyId = signal.methodIndex() - type->signalOffset;
+    if (propertyId >= 0 && !type->connectedPropertyIds.contains(propertyId))
+        type->connectedPropertyIds.append(propertyId);
+}
+
 void QQmlDMCachedModelData::setValue(const QString &role, const QVariant &value)
 {
     QHash<QByteArray, int>::iterator it = type->roleNames.find(role.toUtf8());
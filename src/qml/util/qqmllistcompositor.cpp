@@ -90,8 +90,17 @@ QT_BEGIN_NAMESPACE
     for a specific index, each time a lookup is done the range and its indexes are cached and the
     next lookup is done relative to this.   This works out to near constant time in most relevant
     use cases because successive index lookups are most frequently adjacent.  The total number of
-    ranges is often quite small, which helps as well. If there is a need for faster random access
-    then a skip list like index may be an appropriate addition.
+    ranges is often quite small, which helps as well.
+
+    When group memberships are heavily interleaved, for example after filtering out every other
+    item, the number of ranges approaches the number of items and a lookup far away from the
+    cached position would have to walk most of them.  For these lookups an index of checkpoints
+    is kept which records the iterator at the start of at least every 16th range.  A binary
+    search of the checkpoints for the group index finds a starting position at most a few ranges
+    in front of the requested index.  The checkpoints are built lazily, only as far as distant
+    lookups need them.  When items are inserted or their groups change only the checkpoints for
+    the modified ranges are recreated, those after them are shifted by the change in the group
+    counts.
 
     \sa VisualDataModel
 */
@@ -336,6 +345,7 @@ void QQmlListCompositor::setGroupCount(int count)
     m_groupCount = count;
     m_end = iterator(&m_ranges, 0, Default, m_groupCount);
     m_cacheIt = m_end;
+    m_checkpoints.resize(0);
 }
 
 /*!
@@ -347,6 +357,181 @@ int QQmlListCompositor::count(Group group) const
     return m_end.index[group];
 }
 
+/*!
+    Appends a checkpoint for the range CheckpointInterval ranges after the last checkpoint, or for
+    the first range if there are no checkpoints.
+
+    Returns false if there are too few ranges after the last checkpoint for another one.
+*/
+
+bool QQmlListCompositor::appendCheckpoint()
+{
+    iterator it;
+    if (!m_checkpoints.isEmpty()) {
+        it = m_checkpoints.last();
+        for (int i = 0; i < CheckpointInterval; ++i) {
+            if (it->next == &m_ranges)
+                return false;
+            it.incrementIndexes(it->count);
+            *it = it->next;
+        }
+    } else if (m_ranges.next != &m_ranges) {
+        it = iterator(m_ranges.next, 0, Default, m_groupCount);
+    } else {
+        return false;
+    }
+    it->checkpoint = m_checkpoints.count();
+    m_checkpoints.append(it);
+    return true;
+}
+
+/*!
+    Returns the index of the first checkpoint which may be affected by a modification starting
+    at \a range, or the number of checkpoints if the modification lies beyond them.
+
+    Modifications can merge items into the range in front of the one they start at but leave
+    the ranges before that untouched.  Every range covered by the checkpoints is less than
+    CheckpointInterval ranges after one, so if none is found within that distance the
+    modification lies beyond them.
+*/
+
+int QQmlListCompositor::findCheckpoint(Range *range) const
+{
+    const Range *previous = range->previous;
+    for (int i = 0; i < CheckpointInterval && previous != &m_ranges; ++i) {
+        if (previous->checkpoint >= 0
+                && previous->checkpoint < m_checkpoints.count()
+                && *m_checkpoints.at(previous->checkpoint) == previous) {
+            return previous->checkpoint;
+        }
+        previous = previous->previous;
+    }
+    return previous == &m_ranges ? 0 : m_checkpoints.count();
+}
+
+/*!
+    Updates the checkpoints after a modification of the ranges from the one in front of the
+    checkpoint \a first up to \a last, which changed the group counts from \a previousEnd.
+
+    The ranges after \a last are unchanged apart from being shifted by the number of items
+    inserted or removed, so the checkpoints for them are adjusted rather than rebuilt, and only
+    those in between are recreated.
+*/
+
+void QQmlListCompositor::updateCheckpoints(int first, const iterator &previousEnd, Range *last)
+{
+    if (first >= m_checkpoints.count())
+        return;
+
+    int next = m_checkpoints.count();
+    if (last != &m_ranges) {
+        Range *range = last->next;
+        for (int i = 0; i < CheckpointInterval && range != &m_ranges; ++i, range = range->next) {
+            if (range->checkpoint >= first
+                    && range->checkpoint < m_checkpoints.count()
+                    && *m_checkpoints.at(range->checkpoint) == range) {
+                next = range->checkpoint;
+                break;
+            }
+        }
+    }
+    if (next == m_checkpoints.count()) {
+        // There are no checkpoints after the modification, leave them to be extended lazily.
+        m_checkpoints.resize(first);
+        return;
+    }
+
+    for (int i = next; i < m_checkpoints.count(); ++i) {
+        iterator &checkpoint = m_checkpoints[i];
+        for (int group = 0; group < m_groupCount; ++group)
+            checkpoint.index[group] += m_end.index[group] - previousEnd.index[group];
+    }
+
+    // Recreate the checkpoints between the last one in front of the modified ranges and the
+    // first one after them.
+    const Range *nextRange = *m_checkpoints.at(next);
+    QVector<iterator> checkpoints;
+    iterator it;
+    if (first > 0) {
+        it = m_checkpoints.at(first - 1);
+    } else {
+        it = iterator(m_ranges.next, 0, Default, m_groupCount);
+        if (*it != nextRange)
+            checkpoints.append(it);
+    }
+    for (int distance = 1; *it != nextRange; ++distance) {
+        it.incrementIndexes(it->count);
+        *it = it->next;
+        if (*it != nextRange && distance % CheckpointInterval == 0)
+            checkpoints.append(it);
+    }
+
+    const int removed = next - first;
+    const int added = checkpoints.count();
+    if (added < removed)
+        m_checkpoints.remove(first + added, removed - added);
+    else if (added > removed)
+        m_checkpoints.insert(first + removed, added - removed, iterator());
+    for (int i = 0; i < added; ++i)
+        m_checkpoints[first + i] = checkpoints.at(i);
+
+    const int renumbered = added != removed ? m_checkpoints.count() : first + added;
+    for (int i = first; i < renumbered; ++i)
+        m_checkpoints[i]->checkpoint = i;
+}
+
+/*!
+    Returns an iterator for a \a group from which the item at \a index can be found by
+    iterating forwards or backwards a short distance.
+
+    This is the cached iterator of the last operation if that is close to \a index, otherwise
+    it is the last checkpoint in front of \a index.
+*/
+
+QQmlListCompositor::iterator QQmlListCompositor::findStart(Group group, int index)
+{
+    const bool cacheValid = m_cacheIt != m_end;
+    if (m_checkpoints.isEmpty() || m_checkpoints.last().index[group] < index) {
+        // The index lies beyond the checkpoints, extend them unless the cached iterator is close.
+        if (cacheValid && qAbs(index - m_cacheIt.index[group]) <= CheckpointInterval) {
+            iterator it = m_cacheIt;
+            it.setGroup(group);
+            return it;
+        }
+        while ((m_checkpoints.isEmpty() || m_checkpoints.last().index[group] < index)
+                && appendCheckpoint()) {
+        }
+    }
+
+    // Find the last checkpoint strictly in front of the index, starting from a checkpoint with
+    // the same index could walk backwards over every range which isn't a member of the group.
+    int lo = 0;
+    int hi = m_checkpoints.count();
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (m_checkpoints.at(mid).index[group] < index)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    // The cached iterator is preferable if it lies between the checkpoint and the index.
+    const int checkpointIndex = lo > 0 ? m_checkpoints.at(lo - 1).index[group] : 0;
+    if (cacheValid
+            && m_cacheIt.index[group] >= checkpointIndex
+            && m_cacheIt.index[group] <= index) {
+        iterator it = m_cacheIt;
+        it.setGroup(group);
+        return it;
+    }
+
+    iterator it = lo > 0
+            ? m_checkpoints.at(lo - 1)
+            : iterator(m_ranges.next, 0, group, m_groupCount);
+    it.setGroup(group);
+    return it;
+}
+
 /*!
     Returns an iterator representing the item at \a index in a \a group.
 
@@ -357,14 +542,8 @@ QQmlListCompositor::iterator QQmlListCompositor::find(Group group, int index)
 {
     QT_QML_TRACE_LISTCOMPOSITOR(<< group << index)
     Q_ASSERT(index >=0 && index < count(group));
-    if (m_cacheIt == m_end) {
-        m_cacheIt = iterator(m_ranges.next, 0, group, m_groupCount);
-        m_cacheIt += index;
-    } else {
-        const int offset = index - m_cacheIt.index[group];
-        m_cacheIt.setGroup(group);
-        m_cacheIt += offset;
-    }
+    m_cacheIt = findStart(group, index);
+    m_cacheIt += index - m_cacheIt.index[group];
     Q_ASSERT(m_cacheIt.index[group] == index);
     Q_ASSERT(m_cacheIt->inGroup(group));
     QT_QML_VERIFY_LISTCOMPOSITOR
@@ -398,16 +577,8 @@ QQmlListCompositor::insert_iterator QQmlListCompositor::findInsertPosition(Group
 {
     QT_QML_TRACE_LISTCOMPOSITOR(<< group << index)
     Q_ASSERT(index >=0 && index <= count(group));
-    insert_iterator it;
-    if (m_cacheIt == m_end) {
-        it = iterator(m_ranges.next, 0, group, m_groupCount);
-        it += index;
-    } else {
-        const int offset = index - m_cacheIt.index[group];
-        it = m_cacheIt;
-        it.setGroup(group);
-        it += offset;
-    }
+    insert_iterator it = findStart(group, index);
+    it += index - it.index[group];
     Q_ASSERT(it.index[group] == index);
     return it;
 }
@@ -457,6 +628,8 @@ QQmlListCompositor::iterator QQmlListCompositor::insert(
     if (inserts) {
         inserts->append(Insert(before, count, flags & GroupMask));
     }
+    const int checkpoint = findCheckpoint(*before);
+    const iterator previousEnd = m_end;
     if (before.offset > 0) {
         // Inserting into the middle of a range.  Split it two and update the iterator so it's
         // positioned at the start of the second half.
@@ -493,6 +666,7 @@ QQmlListCompositor::iterator QQmlListCompositor::insert(
 
     m_end.incrementIndexes(count, flags);
     m_cacheIt = before;
+    updateCheckpoints(checkpoint, previousEnd, before->next);
     QT_QML_VERIFY_LISTCOMPOSITOR
     return before;
 }
@@ -525,6 +699,9 @@ void QQmlListCompositor::setFlags(
     if (!flags || !count)
         return;
 
+    const int checkpoint = findCheckpoint(*from);
+    const iterator previousEnd = m_end;
+
     if (from != group) {
         // Skip to the next full range if the start one is not a member of the target group.
         from.incrementIndexes(from->count - from.offset);
@@ -604,6 +781,7 @@ void QQmlListCompositor::setFlags(
         *from = erase(*from)->previous;
     }
     m_cacheIt = from;
+    updateCheckpoints(checkpoint, previousEnd, *from);
     QT_QML_VERIFY_LISTCOMPOSITOR
 }
 
@@ -635,6 +813,9 @@ void QQmlListCompositor::clearFlags(
     if (!flags || !count)
         return;
 
+    const int checkpoint = findCheckpoint(*from);
+    const iterator previousEnd = m_end;
+
     const bool clearCache = flags & CacheFlag;
 
     if (from != group) {
@@ -719,6 +900,7 @@ void QQmlListCompositor::clearFlags(
         *from = erase(*from)->previous;
     }
     m_cacheIt = from;
+    updateCheckpoints(checkpoint, previousEnd, *from);
     QT_QML_VERIFY_LISTCOMPOSITOR
 }
 
@@ -775,6 +957,10 @@ void QQmlListCompositor::move(
     // Find the position of the first item to move.
     iterator fromIt = find(fromGroup, from);
 
+    // The destination may lie on either side of the moved items, so rather than finding the
+    // extent of the modified ranges discard the checkpoints after them.
+    m_checkpoints.resize(findCheckpoint(*fromIt));
+
     if (fromIt != moveGroup) {
         // If the range at the from index doesn't contain items from the move group; skip
         // to the next range.
@@ -872,6 +1058,7 @@ void QQmlListCompositor::move(
 
     const int difference = to - toIt.index[toGroup];
     toIt += difference;
+    m_checkpoints.resize(findCheckpoint(*toIt));
 
     // If the insert position is part way through a range; split it and move the iterator to the
     // start of the second range.
@@ -938,6 +1125,7 @@ void QQmlListCompositor::clear()
     for (Range *range = m_ranges.next; range != &m_ranges; range = erase(range)) {}
     m_end = iterator(m_ranges.next, 0, Default, m_groupCount);
     m_cacheIt = m_end;
+    m_checkpoints.resize(0);
 }
 
 void QQmlListCompositor::listItemsInserted(
@@ -1033,6 +1221,7 @@ void QQmlListCompositor::listItemsInserted(
         it.incrementIndexes(it->count);
     }
     m_cacheIt = m_end;
+    m_checkpoints.resize(0);
     QT_QML_VERIFY_LISTCOMPOSITOR
 }
 
@@ -1223,6 +1412,7 @@ void QQmlListCompositor::listItemsRemoved(
         }
     }
     m_cacheIt = m_end;
+    m_checkpoints.resize(0);
     QT_QML_VERIFY_LISTCOMPOSITOR
 }
 
@@ -81,9 +81,10 @@ public:
     class Range
     {
     public:
-        Range() : next(this), previous(this), list(0), index(0), count(0), flags(0) {}
+        Range() : next(this), previous(this), list(0), index(0), count(0), flags(0), checkpoint(-1) {}
         Range(Range *next, void *list, int index, int count, uint flags)
-            : next(next), previous(next->previous), list(list), index(index), count(count), flags(flags) {
+            : next(next), previous(next->previous), list(list), index(index), count(count), flags(flags),
+              checkpoint(-1) {
             next->previous = this; previous->next = this; }
 
         Range *next;
@@ -92,6 +93,7 @@ public:
         int index;
         int count;
         uint flags;
+        int checkpoint;
 
         inline int start() const { return index; }
         inline int end() const { return index + count; }
@@ -259,9 +261,12 @@ public:
             QVector<QQmlChangeSet::Change> *inserts);
 
 private:
+    enum { CheckpointInterval = 16 };
+
     Range m_ranges;
     iterator m_end;
     iterator m_cacheIt;
+    QVector<iterator> m_checkpoints;
     int m_groupCount;
     int m_defaultFlags;
     int m_removeFlags;
@@ -270,6 +275,11 @@ private:
     inline Range *insert(Range *before, void *list, int index, int count, uint flags);
     inline Range *erase(Range *range);
 
+    iterator findStart(Group group, int index);
+    bool appendCheckpoint();
+    int findCheckpoint(Range *range) const;
+    void updateCheckpoints(int first, const iterator &previousEnd, Range *last);
+
     struct MovedFlags
     {
         MovedFlags() {}
@@ -562,7 +562,7 @@ QSGNode *QQuickBorderImage::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeDat
 {
     Q_D(QQuickBorderImage);
 
-    QSGTexture *texture = d->sceneGraphRenderContext()->textureForFactory(d->pix.textureFactory(), window());
+    QSGTexture *texture = d->sceneGraphRenderContext()->scheduledTextureForFactory(d->pix.textureFactory(), this);
 
     if (!texture || width() <= 0 || height() <= 0) {
         delete oldNode;
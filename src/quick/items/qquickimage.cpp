@@ -593,7 +593,7 @@ QSGNode *QQuickImage::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
 {
     Q_D(QQuickImage);
 
-    QSGTexture *texture = d->sceneGraphRenderContext()->textureForFactory(d->pix.textureFactory(), window());
+    QSGTexture *texture = d->sceneGraphRenderContext()->scheduledTextureForFactory(d->pix.textureFactory(), this);
 
     // Copy over the current texture state into the texture provider...
     if (d->provider) {
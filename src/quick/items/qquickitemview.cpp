@@ -2386,6 +2386,9 @@ bool QQuickItemViewPrivate::releaseItem(FxViewItem *item)
             // item was not destroyed, and we no longer reference it.
             QQuickItemPrivate::get(item->item)->setCulled(true);
             unrequestedItems.insert(item->item, model->indexOf(item->item, q));
+        } else if (flags & QQmlInstanceModel::Pooled) {
+            // item was kept by the model for reuse, hide it until it is handed out again.
+            QQuickItemPrivate::get(item->item)->setCulled(true);
         } else if (flags & QQmlInstanceModel::Destroyed) {
             item->item->setParentItem(0);
         }
@@ -205,6 +205,11 @@ void QQuickPathViewPrivate::releaseItem(QQuickItem *item)
         // item was not destroyed, and we no longer reference it.
         if (QQuickPathViewAttached *att = attached(item))
             att->setOnPath(false);
+    } else if (flags & QQmlInstanceModel::Pooled) {
+        // item was kept by the model for reuse, hide it until it is handed out again.
+        if (QQuickPathViewAttached *att = attached(item))
+            att->setOnPath(false);
+        itemPrivate->setCulled(true);
     } else if (flags & QQmlInstanceModel::Destroyed) {
         // but we still reference it
         item->setParentItem(0);
@@ -454,14 +454,17 @@ void QQuickShaderEffectMaterial::cleanupMaterialCache()
     }
 }
 
-void QQuickShaderEffectMaterial::updateTextures() const
+// Returns true if the content of any of the dynamic textures changed.
+bool QQuickShaderEffectMaterial::updateTextures() const
 {
+    bool updated = false;
     for (int i = 0; i < textureProviders.size(); ++i) {
         if (QSGTextureProvider *provider = textureProviders.at(i)) {
             if (QSGDynamicTexture *texture = qobject_cast<QSGDynamicTexture *>(provider->texture()))
-                texture->updateTexture();
+                updated |= texture->updateTexture();
         }
     }
+    return updated;
 }
 
 void QQuickShaderEffectMaterial::invalidateTextureProvider(QSGTextureProvider *provider)
@@ -501,7 +504,10 @@ void QQuickShaderEffectNode::textureProviderDestroyed(QObject *object)
 void QQuickShaderEffectNode::preprocess()
 {
     Q_ASSERT(material());
-    static_cast<QQuickShaderEffectMaterial *>(material())->updateTextures();
+    // The renderer needs to know that what this node renders changed, even
+    // though the material itself is still the same.
+    if (static_cast<QQuickShaderEffectMaterial *>(material())->updateTextures())
+        markDirty(DirtyMaterial);
 }
 
 #include "qquickshadereffectnode.moc"
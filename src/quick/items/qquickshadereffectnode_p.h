@@ -107,7 +107,7 @@ public:
     bool geometryUsesTextureSubRect;
 
     void setProgramSource(const QQuickShaderEffectMaterialKey &source);
-    void updateTextures() const;
+    bool updateTextures() const;
     void invalidateTextureProvider(QSGTextureProvider *provider);
 
     static void cleanupMaterialCache();
@@ -58,6 +58,7 @@
 #include <QtGui/qstylehints.h>
 #include <QtCore/qvarlengtharray.h>
 #include <QtCore/qabstractanimation.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/QLibraryInfo>
 #include <QtCore/QRunnable>
 #include <QtQml/qqmlincubator.h>
@@ -65,6 +66,7 @@
 #include <QtQuick/private/qquickpixmapcache_p.h>
 
 #include <private/qqmlmemoryprofiler_p.h>
+#include <private/qqmlglobal_p.h>
 
 #include <private/qopenglvertexarrayobject_p.h>
 
@@ -98,17 +100,19 @@ class QQuickWindowIncubationController : public QObject, public QQmlIncubationCo
     Q_OBJECT
 
 public:
-    QQuickWindowIncubationController(QSGRenderLoop *loop)
+    QQuickWindowIncubationController(QSGRenderLoop *loop, QQuickWindow *window)
         : m_renderLoop(loop), m_timer(0)
     {
+        m_frame_time = qMax(1, int(1000 / QGuiApplication::primaryScreen()->refreshRate()));
         // Allow incubation for 1/3 of a frame.
-        m_incubation_time = qMax(1, int(1000 / QGuiApplication::primaryScreen()->refreshRate()) / 3);
+        m_incubation_time = qMax(1, m_frame_time / 3);
 
         QAnimationDriver *animationDriver = m_renderLoop->animationDriver();
         if (animationDriver) {
             connect(animationDriver, SIGNAL(stopped()), this, SLOT(animationStopped()));
             connect(m_renderLoop, SIGNAL(timeToIncubate()), this, SLOT(incubate()));
         }
+        connect(window, SIGNAL(afterAnimating()), this, SLOT(frameStarted()));
     }
 
 protected:
@@ -127,11 +131,25 @@ protected:
         }
     }
 
+    // When incubation is interleaved with rendering, use the time that is left until the next
+    // frame is due, keeping 1/3 of a frame in reserve for event delivery and polishing.  Outside
+    // of a frame, or when the frame has already overrun, fall back to the fixed budget.
+    int frameIncubationTime() const {
+        if (!m_frame_timer.isValid())
+            return m_incubation_time;
+        const qint64 elapsed = m_frame_timer.elapsed();
+        if (elapsed >= m_frame_time)
+            return m_incubation_time;
+        return int(qMax<qint64>(1, m_frame_time - m_incubation_time - elapsed));
+    }
+
 public slots:
+    void frameStarted() { m_frame_timer.start(); }
+
     void incubate() {
         if (incubatingObjectCount()) {
             if (m_renderLoop->interleaveIncubation()) {
-                incubateFor(m_incubation_time);
+                incubateFor(frameIncubationTime());
             } else {
                 incubateFor(m_incubation_time * 2);
                 if (incubatingObjectCount())
@@ -151,6 +169,8 @@ protected:
 
 private:
     QSGRenderLoop *m_renderLoop;
+    QElapsedTimer m_frame_timer;
+    int m_frame_time;
     int m_incubation_time;
     int m_timer;
 };
@@ -395,6 +415,16 @@ void QQuickWindowPrivate::syncSceneGraph()
 }
 
 
+static bool qquickwindow_isBeforeRenderingConnected(QQuickWindow *window)
+{
+    IS_SIGNAL_CONNECTED(window, QQuickWindow, beforeRendering, ());
+}
+
+static bool qquickwindow_isAfterRenderingConnected(QQuickWindow *window)
+{
+    IS_SIGNAL_CONNECTED(window, QQuickWindow, afterRendering, ());
+}
+
 void QQuickWindowPrivate::renderSceneGraph(const QSize &size)
 {
     QML_MEMORY_SCOPE_STRING("SceneGraph");
@@ -402,6 +432,14 @@ void QQuickWindowPrivate::renderSceneGraph(const QSize &size)
     if (!renderer)
         return;
 
+    // The renderer only knows what changed in the scene graph. Anything else
+    // drawing into the window means the whole frame has to be presented.
+    if (customRenderStage || !clearBeforeRendering
+            || !beforeRenderingJobs.isEmpty() || !afterRenderingJobs.isEmpty()
+            || qquickwindow_isBeforeRenderingConnected(q)
+            || qquickwindow_isAfterRenderingConnected(q))
+        renderer->requestFullRepaint();
+
     animationController->advance();
     emit q->beforeRendering();
     runAndClearJobs(&beforeRenderingJobs);
@@ -508,12 +546,19 @@ void QQuickWindowPrivate::init(QQuickWindow *c, QQuickRenderControl *control)
     }
 
     q->setSurfaceType(windowManager ? windowManager->windowSurfaceType() : QSurface::OpenGLSurface);
-    q->setFormat(sg->defaultSurfaceFormat());
+    if (windowManager)
+        q->setFormat(windowManager->windowFormat(q, sg->defaultSurfaceFormat()));
+    else
+        q->setFormat(sg->defaultSurfaceFormat());
 
     animationController = new QQuickAnimatorController(q);
 
-    QObject::connect(context, SIGNAL(initialized()), q, SIGNAL(sceneGraphInitialized()), Qt::DirectConnection);
-    QObject::connect(context, SIGNAL(invalidated()), q, SIGNAL(sceneGraphInvalidated()), Qt::DirectConnection);
+    // A render context shared by several windows tells nothing about this
+    // one, so the render loop emits these signals for each window instead.
+    if (!windowManager || !windowManager->sharesRenderContext()) {
+        QObject::connect(context, SIGNAL(initialized()), q, SIGNAL(sceneGraphInitialized()), Qt::DirectConnection);
+        QObject::connect(context, SIGNAL(invalidated()), q, SIGNAL(sceneGraphInvalidated()), Qt::DirectConnection);
+    }
     QObject::connect(context, SIGNAL(invalidated()), q, SLOT(cleanupSceneGraph()), Qt::DirectConnection);
 
     QObject::connect(q, SIGNAL(focusObjectChanged(QObject*)), q, SIGNAL(activeFocusItemChanged()));
@@ -3438,7 +3483,7 @@ QQmlIncubationController *QQuickWindow::incubationController() const
         return 0; // TODO: make sure that this is safe
 
     if (!d->incubationController)
-        d->incubationController = new QQuickWindowIncubationController(d->windowManager);
+        d->incubationController = new QQuickWindowIncubationController(d->windowManager, const_cast<QQuickWindow *>(this));
     return d->incubationController;
 }
 
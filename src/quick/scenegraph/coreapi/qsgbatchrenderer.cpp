@@ -49,6 +49,7 @@
 #include <QtGui/QOpenGLFunctions_3_2_Core>
 
 #include <private/qquickprofiler_p.h>
+#include <private/qsimd_p.h>
 #include "qsgmaterialshader_p.h"
 
 #include <algorithm>
@@ -123,6 +124,7 @@ struct QMatrix4x4_Accessor
 };
 
 const float OPAQUE_LIMIT                = 0.999f;
+const int ALPHA_OVERLAP_GRID_THRESHOLD  = 64;
 
 ShaderManager::Shader *ShaderManager::prepareMaterial(QSGMaterial *material)
 {
@@ -635,7 +637,6 @@ bool Batch::geometryWasChanged(QSGGeometryNode *gn)
     while (e && (e->node == gn || e->removed))
         e = e->nextInBatch;
     if (!e || e->node->geometry()->attributes() == gn->geometry()->attributes()) {
-        needsUpload = true;
         return true;
     } else {
         return false;
@@ -755,6 +756,7 @@ Renderer::Renderer(QSGRenderContext *ctx)
     , m_elementsToDelete(64)
     , m_tmpAlphaElements(16)
     , m_tmpOpaqueElements(16)
+    , m_batchChain(16)
     , m_rebuild(FullRebuild)
     , m_zRange(0)
     , m_renderOrderRebuildLower(-1)
@@ -765,6 +767,11 @@ Renderer::Renderer(QSGRenderContext *ctx)
     , m_clipMatrixId(0)
     , m_currentClip(0)
     , m_currentClipType(NoClip)
+    , m_damagedElements(64)
+    , m_damagedRects(64)
+    , m_fullDamage(true)
+    , m_scissorToDamage(false)
+    , m_lastClearMode(0)
     , m_vertexUploadPool(256)
 #ifdef QSG_SEPARATE_INDEX_BUFFER
     , m_indexUploadPool(64)
@@ -959,6 +966,9 @@ bool Renderer::changeBatchRoot(Node *node, Node *root)
 
 void Renderer::nodeChangedBatchRoot(Node *node, Node *root)
 {
+    // Bounds are relative to the root, so the previous ones are meaningless now.
+    m_fullDamage = true;
+
     if (node->type() == QSGNode::ClipNodeType || node->isBatchRoot) {
         if (!changeBatchRoot(node, root))
             return;
@@ -983,12 +993,13 @@ void Renderer::nodeWasTransformed(Node *node, int *vertexCount)
         *vertexCount += gn->geometry()->vertexCount();
         Element *e  = node->element();
         if (e) {
+            damageElement(e);
             e->boundsComputed = false;
             if (e->batch) {
                 if (!e->batch->isOpaque) {
                     invalidateBatchAndOverlappingRenderOrders(e->batch);
                 } else if (e->batch->merged) {
-                    e->batch->needsUpload = true;
+                    e->batch->elementChanged(e);
                 }
             }
         }
@@ -1015,10 +1026,12 @@ void Renderer::nodeWasAdded(QSGNode *node, Node *shadowParent)
     if (node->type() == QSGNode::GeometryNodeType) {
         snode->data = m_elementAllocator.allocate();
         snode->element()->setNode(static_cast<QSGGeometryNode *>(node));
+        damageElement(snode->element(), false);
 
     } else if (node->type() == QSGNode::ClipNodeType) {
         snode->data = new ClipBatchRootInfo;
         m_rebuild |= FullRebuild;
+        m_fullDamage = true;
 
     } else if (node->type() == QSGNode::RenderNodeType) {
         RenderNodeElement *e = new RenderNodeElement(static_cast<QSGRenderNode *>(node));
@@ -1027,6 +1040,7 @@ void Renderer::nodeWasAdded(QSGNode *node, Node *shadowParent)
         m_renderNodeElements.insert(e->renderNode, e);
         m_useDepthBuffer = false;
         m_rebuild |= FullRebuild;
+        m_fullDamage = true;
     }
 
     QSGNODE_TRAVERSE(node)
@@ -1043,6 +1057,12 @@ void Renderer::nodeWasRemoved(Node *node)
     if (node->type() == QSGNode::GeometryNodeType) {
         Element *e = node->element();
         if (e) {
+            if (!e->damaged) {
+                if (e->boundsComputed)
+                    addDamage(e->bounds, e->root);
+                else
+                    m_fullDamage = true;
+            }
             e->removed = true;
             m_elementsToDelete.add(e);
             e->node = 0;
@@ -1060,17 +1080,20 @@ void Renderer::nodeWasRemoved(Node *node)
         removeBatchRootFromParent(node);
         delete node->clipInfo();
         m_rebuild |= FullRebuild;
+        m_fullDamage = true;
         m_taggedRoots.remove(node);
 
     } else if (node->isBatchRoot) {
         removeBatchRootFromParent(node);
         delete node->rootInfo();
         m_rebuild |= FullRebuild;
+        m_fullDamage = true;
         m_taggedRoots.remove(node);
 
     } else if (node->type() == QSGNode::RenderNodeType) {
         RenderNodeElement *e = m_renderNodeElements.take(static_cast<QSGRenderNode *>(node->sgNode));
         if (e) {
+            m_fullDamage = true;
             e->removed = true;
             m_elementsToDelete.add(e);
 
@@ -1089,6 +1112,7 @@ void Renderer::turnNodeIntoBatchRoot(Node *node)
 {
     if (Q_UNLIKELY(debug_change())) qDebug() << " - new batch root";
     m_rebuild |= FullRebuild;
+    m_fullDamage = true;
     node->isBatchRoot = true;
     node->becameBatchRoot = true;
 
@@ -1174,6 +1198,17 @@ void Renderer::nodeChanged(QSGNode *node, QSGNode::DirtyState state)
 
     shadowNode->dirtyState |= state;
 
+    // Clip changes affect everything below them, and moving a batch root moves
+    // elements whose bounds are relative to it; neither is tracked per element.
+    if (node->type() == QSGNode::ClipNodeType
+            || (state & QSGNode::DirtyForceUpdate)
+            || ((state & QSGNode::DirtyMatrix) && shadowNode->isBatchRoot)) {
+        m_fullDamage = true;
+    }
+
+    if (state & QSGNode::DirtyOpacity)
+        damageSubtree(shadowNode);
+
     if (state & QSGNode::DirtyMatrix && !shadowNode->isBatchRoot) {
         Q_ASSERT(node->type() == QSGNode::TransformNodeType);
         if (node->m_subtreeRenderableCount > m_batchNodeThreshold) {
@@ -1191,13 +1226,14 @@ void Renderer::nodeChanged(QSGNode *node, QSGNode::DirtyState state)
         QSGGeometryNode *gn = static_cast<QSGGeometryNode *>(node);
         Element *e = shadowNode->element();
         if (e) {
+            damageElement(e);
             e->boundsComputed = false;
             Batch *b = e->batch;
             if (b) {
                 if (!e->batch->geometryWasChanged(gn) || !e->batch->isOpaque) {
                     invalidateBatchAndOverlappingRenderOrders(e->batch);
                 } else {
-                    b->needsUpload = true;
+                    b->elementChanged(e);
                 }
             }
         }
@@ -1206,6 +1242,7 @@ void Renderer::nodeChanged(QSGNode *node, QSGNode::DirtyState state)
     if (state & QSGNode::DirtyMaterial && node->type() == QSGNode::GeometryNodeType) {
         Element *e = shadowNode->element();
         if (e) {
+            damageElement(e);
             bool blended = hasMaterialWithBlending(static_cast<QSGGeometryNode *>(node));
             if (e->isMaterialBlended != blended) {
                 m_rebuild |= Renderer::FullRebuild;
@@ -1482,8 +1519,100 @@ void Renderer::cleanupBatches(QDataBuffer<Batch *> *batches) {
     }
 }
 
+/*
+ * Elements can only be merged into the same batch if they share clip list,
+ * drawing mode, line width, vertex attributes, opacity and material type, and
+ * if they are in the same run of elements of one batch root in the render list.
+ * Only QSGMaterial::compare() cannot be hashed, so elements with the same key
+ * are chained together and batch preparation only walks the chain of the element
+ * that starts a batch, instead of every element that follows it.
+ */
+struct BatchKey
+{
+    int segment;
+    GLenum drawingMode;
+    float lineWidth;
+    qreal opacity;
+    const QSGClipNode *clipList;
+    const QSGGeometry::Attribute *attributes;
+    QSGMaterialType *materialType;
+};
+
+inline bool operator==(const BatchKey &a, const BatchKey &b)
+{
+    return a.segment == b.segment
+            && a.drawingMode == b.drawingMode
+            && a.lineWidth == b.lineWidth
+            && a.opacity == b.opacity
+            && a.clipList == b.clipList
+            && a.attributes == b.attributes
+            && a.materialType == b.materialType;
+}
+
+inline uint qHash(const BatchKey &key, uint seed = 0)
+{
+    uint h = seed ^ uint(key.segment) ^ (uint(key.drawingMode) << 24);
+    h = 31 * h + qHash(key.clipList);
+    h = 31 * h + qHash(key.attributes);
+    h = 31 * h + qHash(key.materialType);
+    h = 31 * h + qHash(key.opacity);
+    return h;
+}
+
+int Renderer::buildBatchChains(const QDataBuffer<Element *> &list, bool backwards)
+{
+    const int count = list.size();
+    m_batchChain.resize(count);
+
+    QHash<BatchKey, int> chainEnds;
+    chainEnds.reserve(count);
+    int segment = 0;
+    Node *root = 0;
+    for (int k = 0; k < count; ++k) {
+        const int i = backwards ? count - 1 - k : k;
+        m_batchChain.at(i) = -1;
+        Element *e = list.at(i);
+        if (!e)
+            continue;
+        // Batches never extend past a render node or into another batch root.
+        if (e->isRenderNode) {
+            ++segment;
+            root = 0;
+            continue;
+        }
+        if (e->root != root) {
+            ++segment;
+            root = e->root;
+        }
+        if (e->batch || e->node->geometry()->vertexCount() == 0)
+            continue;
+
+        const QSGGeometry *g = e->node->geometry();
+        BatchKey key;
+        key.segment = segment;
+        key.drawingMode = g->drawingMode();
+        key.lineWidth = g->drawingMode() == GL_LINES ? g->lineWidth() : 0;
+        key.opacity = e->node->inheritedOpacity();
+        key.clipList = e->node->clipList();
+        key.attributes = g->attributes();
+        key.materialType = e->node->activeMaterial()->type();
+
+        QHash<BatchKey, int>::iterator it = chainEnds.find(key);
+        if (it != chainEnds.end()) {
+            m_batchChain.at(*it) = i;
+            *it = i;
+        } else {
+            chainEnds.insert(key, i);
+        }
+    }
+    return chainEnds.size();
+}
+
 void Renderer::prepareOpaqueBatches()
 {
+    const int chainCount = buildBatchChains(m_opaqueRenderList, true);
+    int batchCount = 0;
+
     for (int i=m_opaqueRenderList.size() - 1; i >= 0; --i) {
         Element *ei = m_opaqueRenderList.at(i);
         if (!ei || ei->batch || ei->node->geometry()->vertexCount() == 0)
@@ -1496,38 +1625,39 @@ void Renderer::prepareOpaqueBatches()
         batch->positionAttribute = qsg_positionAttribute(ei->node->geometry());
 
         m_opaqueBatches.add(batch);
+        ++batchCount;
 
         ei->batch = batch;
         Element *next = ei;
 
         QSGGeometryNode *gni = ei->node;
 
-        for (int j = i - 1; j >= 0; --j) {
+        int previous = i;
+        for (int j = m_batchChain.at(i); j >= 0; j = m_batchChain.at(j)) {
             Element *ej = m_opaqueRenderList.at(j);
-            if (!ej)
-                continue;
-            if (ej->root != ei->root)
-                break;
-            if (ej->batch || ej->node->geometry()->vertexCount() == 0)
-                continue;
+            Q_ASSERT(!ej->batch);
 
             QSGGeometryNode *gnj = ej->node;
 
-            if (gni->clipList() == gnj->clipList()
-                    && gni->geometry()->drawingMode() == gnj->geometry()->drawingMode()
-                    && (gni->geometry()->drawingMode() != GL_LINES || gni->geometry()->lineWidth() == gnj->geometry()->lineWidth())
-                    && gni->geometry()->attributes() == gnj->geometry()->attributes()
-                    && gni->inheritedOpacity() == gnj->inheritedOpacity()
-                    && gni->activeMaterial()->type() == gnj->activeMaterial()->type()
-                    && gni->activeMaterial()->compare(gnj->activeMaterial()) == 0) {
+            if (gni->activeMaterial()->compare(gnj->activeMaterial()) == 0) {
                 ej->batch = batch;
                 next->nextInBatch = ej;
                 next = ej;
+                // Batched elements are unlinked so later batches don't visit them.
+                m_batchChain.at(previous) = m_batchChain.at(j);
+            } else {
+                previous = j;
             }
         }
 
         batch->lastOrderInBatch = next->order;
     }
+
+    // Every chain could have been a single batch. The ones split off are
+    // elements with the same material type but different material state,
+    // typically textures that ended up outside the atlas.
+    if (Q_UNLIKELY(debug_render()))
+        qDebug(" -> opaque batches: %d new, %d split by material state", batchCount, batchCount - chainCount);
 }
 
 bool Renderer::checkOverlap(int first, int last, const Rect &bounds)
@@ -1544,14 +1674,124 @@ bool Renderer::checkOverlap(int first, int last, const Rect &bounds)
 }
 
 /*
- *
- * To avoid the O(n^2) checkOverlap check in most cases, we have the
- * overlapBounds which is the union of all bounding rects to check overlap
- * for. We know that if it does not overlap, then none of the individual
- * ones will either. For the typical list case, this results in no calls
- * to checkOverlap what-so-ever. This also ensures that when all consecutive
- * items are matching (such as a table of text), we don't build up an
- * overlap bounds and thus do not require full overlap checks.
+ * Uniform grid over the bounds of the unbatched alpha elements, so that the
+ * overlap check for a batch candidate only looks at the elements near it rather
+ * than at every element between it and the start of the batch. Each cell holds
+ * the render list indices of the elements touching it in increasing order.
+ * Elements covering many cells, or with unbounded geometry, are kept aside and
+ * always checked.
+ */
+class OverlapGrid
+{
+public:
+    enum { MaxCellsPerElement = 16, ElementsPerCell = 4, MaxDimension = 256 };
+
+    OverlapGrid(const QDataBuffer<Element *> &list)
+        : m_list(list)
+        , m_columns(0)
+        , m_rows(0)
+    {
+        Rect extents;
+        extents.set(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+        int count = 0;
+        for (int i = 0; i < list.size(); ++i) {
+            Element *e = list.at(i);
+            if (isIndexed(e) && !e->bounds.isOutsideFloatRange()) {
+                extents |= e->bounds;
+                ++count;
+            }
+        }
+
+        if (count > 0) {
+            const int dimension = qBound(1, int(qSqrt(count / ElementsPerCell)), int(MaxDimension));
+            m_columns = dimension;
+            m_rows = dimension;
+            m_origin = extents.tl;
+            m_cellWidth = qMax((extents.br.x - extents.tl.x) / m_columns, 1.0f);
+            m_cellHeight = qMax((extents.br.y - extents.tl.y) / m_rows, 1.0f);
+            m_cells.resize(m_columns * m_rows);
+        }
+
+        for (int i = 0; i < list.size(); ++i) {
+            Element *e = list.at(i);
+            if (!isIndexed(e))
+                continue;
+            int x0, y0, x1, y1;
+            if (e->bounds.isOutsideFloatRange() || !cellRange(e->bounds, &x0, &y0, &x1, &y1)
+                    || (x1 - x0 + 1) * (y1 - y0 + 1) > MaxCellsPerElement) {
+                m_large.append(i);
+                continue;
+            }
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x)
+                    m_cells[y * m_columns + x].append(i);
+            }
+        }
+    }
+
+    // Returns true if an unbatched element in [first, last] intersects bounds.
+    bool overlaps(int first, int last, const Rect &bounds) const
+    {
+        if (first > last)
+            return false;
+        if (overlaps(m_large, first, last, bounds))
+            return true;
+        int x0, y0, x1, y1;
+        if (!cellRange(bounds, &x0, &y0, &x1, &y1))
+            return false;
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                if (overlaps(m_cells.at(y * m_columns + x), first, last, bounds))
+                    return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static bool isIndexed(const Element *e)
+    {
+        return e && !e->isRenderNode && !e->batch && e->node->geometry()->vertexCount() > 0;
+    }
+
+    bool cellRange(const Rect &r, int *x0, int *y0, int *x1, int *y1) const
+    {
+        if (m_cells.isEmpty())
+            return false;
+        // Clamp in float first, the bounds may be far outside of the grid.
+        *x0 = int(qBound(0.0f, (r.tl.x - m_origin.x) / m_cellWidth, float(m_columns - 1)));
+        *y0 = int(qBound(0.0f, (r.tl.y - m_origin.y) / m_cellHeight, float(m_rows - 1)));
+        *x1 = int(qBound(0.0f, (r.br.x - m_origin.x) / m_cellWidth, float(m_columns - 1)));
+        *y1 = int(qBound(0.0f, (r.br.y - m_origin.y) / m_cellHeight, float(m_rows - 1)));
+        return *x0 <= *x1 && *y0 <= *y1;
+    }
+
+    bool overlaps(const QVector<int> &indexes, int first, int last, const Rect &bounds) const
+    {
+        QVector<int>::const_iterator it = std::lower_bound(indexes.constBegin(), indexes.constEnd(), first);
+        for (; it != indexes.constEnd() && *it <= last; ++it) {
+            Element *e = m_list.at(*it);
+            if (!e->batch && e->bounds.intersects(bounds))
+                return true;
+        }
+        return false;
+    }
+
+    const QDataBuffer<Element *> &m_list;
+    int m_columns;
+    int m_rows;
+    Pt m_origin;
+    float m_cellWidth;
+    float m_cellHeight;
+    QVector<QVector<int> > m_cells;
+    QVector<int> m_large;
+};
+
+/*
+ * A compatible element can only join a batch if none of the unbatched elements
+ * between the start of the batch and itself overlap it, since those would then
+ * be rendered before it. For short render lists these are checked directly, for
+ * longer ones the OverlapGrid keeps the check from being O(n^2).
  */
 
 void Renderer::prepareAlphaBatches()
@@ -1564,6 +1804,13 @@ void Renderer::prepareAlphaBatches()
         e->ensureBoundsValid();
     }
 
+    const int chainCount = buildBatchChains(m_alphaRenderList, false);
+    int batchCount = 0;
+
+    QScopedPointer<OverlapGrid> grid;
+    if (m_alphaRenderList.size() > ALPHA_OVERLAP_GRID_THRESHOLD)
+        grid.reset(new OverlapGrid(m_alphaRenderList));
+
     for (int i=0; i<m_alphaRenderList.size(); ++i) {
         Element *ei = m_alphaRenderList.at(i);
         if (!ei || ei->batch)
@@ -1589,57 +1836,47 @@ void Renderer::prepareAlphaBatches()
         batch->isOpaque = false;
         batch->needsUpload = true;
         m_alphaBatches.add(batch);
+        ++batchCount;
         ei->batch = batch;
 
         QSGGeometryNode *gni = ei->node;
         batch->positionAttribute = qsg_positionAttribute(gni->geometry());
 
-        Rect overlapBounds;
-        overlapBounds.set(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
-
         Element *next = ei;
 
-        for (int j = i + 1; j < m_alphaRenderList.size(); ++j) {
+        int previous = i;
+        for (int j = m_batchChain.at(i); j >= 0; j = m_batchChain.at(j)) {
             Element *ej = m_alphaRenderList.at(j);
-            if (!ej)
-                continue;
-            if (ej->root != ei->root || ej->isRenderNode)
-                break;
-            if (ej->batch)
-                continue;
+            Q_ASSERT(!ej->batch);
 
             QSGGeometryNode *gnj = ej->node;
-            if (gnj->geometry()->vertexCount() == 0)
+            if (gni->activeMaterial()->compare(gnj->activeMaterial()) != 0) {
+                previous = j;
                 continue;
+            }
 
-            if (gni->clipList() == gnj->clipList()
-                    && gni->geometry()->drawingMode() == gnj->geometry()->drawingMode()
-                    && (gni->geometry()->drawingMode() != GL_LINES || gni->geometry()->lineWidth() == gnj->geometry()->lineWidth())
-                    && gni->geometry()->attributes() == gnj->geometry()->attributes()
-                    && gni->inheritedOpacity() == gnj->inheritedOpacity()
-                    && gni->activeMaterial()->type() == gnj->activeMaterial()->type()
-                    && gni->activeMaterial()->compare(gnj->activeMaterial()) == 0) {
-                if (!overlapBounds.intersects(ej->bounds) || !checkOverlap(i+1, j - 1, ej->bounds)) {
-                    ej->batch = batch;
-                    next->nextInBatch = ej;
-                    next = ej;
-                } else {
-                    /* When we come across a compatible element which hits an overlap, we
-                     * need to stop the batch right away. We cannot add more elements
-                     * to the current batch as they will be rendered before the batch that the
-                     * current 'ej' will be added to.
-                     */
-                    break;
-                }
-            } else {
-                overlapBounds |= ej->bounds;
+            const bool overlap = grid ? grid->overlaps(i + 1, j - 1, ej->bounds)
+                                      : checkOverlap(i + 1, j - 1, ej->bounds);
+            if (overlap) {
+                /* When we come across a compatible element which hits an overlap, we
+                 * need to stop the batch right away. We cannot add more elements
+                 * to the current batch as they will be rendered before the batch that the
+                 * current 'ej' will be added to.
+                 */
+                break;
             }
+
+            ej->batch = batch;
+            next->nextInBatch = ej;
+            next = ej;
+            m_batchChain.at(previous) = m_batchChain.at(j);
         }
 
         batch->lastOrderInBatch = next->order;
     }
 
-
+    if (Q_UNLIKELY(debug_render()))
+        qDebug(" -> alpha batches: %d new, %d split by material state or overlap", batchCount, batchCount - chainCount);
 }
 
 static inline int qsg_fixIndexCount(int iCount, GLenum drawMode) {
@@ -1676,6 +1913,76 @@ static inline int qsg_fixIndexCount(int iCount, GLenum drawMode) {
  * iBase: The starting index for this element in the batch
  */
 
+/* The positions of merged elements are transformed into the coordinate system
+ * of the batch root while uploading. Only the 2D affine part of the matrix is
+ * applied, as in Pt::map(). The SSE2 paths handle two vertices per iteration,
+ * and both vector paths evaluate the same expressions as the plain code.
+ */
+static void qsg_translatePositions(char *vdata, int stride, int count, float dx, float dy)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128 d = _mm_setr_ps(dx, dy, dx, dy);
+    for (; i + 1 < count; i += 2) {
+        __m128 p = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) vdata);
+        p = _mm_loadh_pi(p, (const __m64 *) (vdata + stride));
+        p = _mm_add_ps(p, d);
+        _mm_storel_pi((__m64 *) vdata, p);
+        _mm_storeh_pi((__m64 *) (vdata + stride), p);
+        vdata += 2 * stride;
+    }
+#elif defined(__ARM_NEON__)
+    const float32x2_t d = { dx, dy };
+    for (; i < count; ++i) {
+        vst1_f32((float *) vdata, vadd_f32(vld1_f32((const float *) vdata), d));
+        vdata += stride;
+    }
+#endif
+    for (; i < count; ++i) {
+        Pt *p = (Pt *) vdata;
+        p->x += dx;
+        p->y += dy;
+        vdata += stride;
+    }
+}
+
+static void qsg_mapPositions(char *vdata, int stride, int count, const QMatrix4x4 &matrix)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    const float *m = matrix.constData();
+    const __m128 c0 = _mm_setr_ps(m[0], m[1], m[0], m[1]);
+    const __m128 c1 = _mm_setr_ps(m[4], m[5], m[4], m[5]);
+    const __m128 c3 = _mm_setr_ps(m[12], m[13], m[12], m[13]);
+    for (; i + 1 < count; i += 2) {
+        __m128 p = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) vdata);
+        p = _mm_loadh_pi(p, (const __m64 *) (vdata + stride));
+        const __m128 xs = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128 ys = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, c0), _mm_mul_ps(ys, c1)), c3);
+        _mm_storel_pi((__m64 *) vdata, p);
+        _mm_storeh_pi((__m64 *) (vdata + stride), p);
+        vdata += 2 * stride;
+    }
+#elif defined(__ARM_NEON__)
+    const float *m = matrix.constData();
+    const float32x2_t c0 = vld1_f32(m);
+    const float32x2_t c1 = vld1_f32(m + 4);
+    const float32x2_t c3 = vld1_f32(m + 12);
+    for (; i < count; ++i) {
+        const float32x2_t p = vld1_f32((const float *) vdata);
+        const float32x2_t r = vadd_f32(vmul_n_f32(c0, vget_lane_f32(p, 0)),
+                                       vmul_n_f32(c1, vget_lane_f32(p, 1)));
+        vst1_f32((float *) vdata, vadd_f32(r, c3));
+        vdata += stride;
+    }
+#endif
+    for (; i < count; ++i) {
+        ((Pt *) vdata)->map(matrix);
+        vdata += stride;
+    }
+}
+
 void Renderer::uploadMergedElement(Element *e, int vaOffset, char **vertexData, char **zData, char **indexData, quint16 *iBase, int *indexCount)
 {
     if (Q_UNLIKELY(debug_upload())) qDebug() << "  - uploading element:" << e << e->node << (void *) *vertexData << (qintptr) (*zData - *vertexData) << (qintptr) (*indexData - *vertexData);
@@ -1690,17 +1997,11 @@ void Renderer::uploadMergedElement(Element *e, int vaOffset, char **vertexData,
     // apply vertex transform..
     char *vdata = *vertexData + vaOffset;
     if (((const QMatrix4x4_Accessor &) localx).flagBits == 1) {
-        for (int i=0; i<vCount; ++i) {
-            Pt *p = (Pt *) vdata;
-            p->x += ((const QMatrix4x4_Accessor &) localx).m[3][0];
-            p->y += ((const QMatrix4x4_Accessor &) localx).m[3][1];
-            vdata += vSize;
-        }
+        qsg_translatePositions(vdata, vSize, vCount,
+                               ((const QMatrix4x4_Accessor &) localx).m[3][0],
+                               ((const QMatrix4x4_Accessor &) localx).m[3][1]);
     } else if (((const QMatrix4x4_Accessor &) localx).flagBits > 1) {
-        for (int i=0; i<vCount; ++i) {
-            ((Pt *) vdata)->map(localx);
-            vdata += vSize;
-        }
+        qsg_mapPositions(vdata, vSize, vCount, localx);
     }
 
     if (m_useDepthBuffer) {
@@ -1753,8 +2054,285 @@ static QMatrix4x4 qsg_matrixForRoot(Node *node)
     return *c->matrix();
 }
 
+/*
+ * Damage tracking
+ *
+ * While the scene graph is synchronized, every element that is about to change
+ * queues the bounds it was last rendered at and is itself queued so that its
+ * new bounds are added when the frame is rendered. Element bounds are relative
+ * to their batch root, whose matrix is only updated when the next frame is
+ * rendered, so the old bounds are mapped to the window right away, with the
+ * root matrices and projection of the previous frame. The new bounds are mapped
+ * with the matrices of the frame being rendered.
+ *
+ * Everything that is not tracked per element, like batch roots moving, clip
+ * changes, render nodes or a new viewport, damages the whole window.
+ */
+static QRect qsg_damageRectForBounds(const Rect &bounds, Node *root,
+                                     const QMatrix4x4 &projection, const QSize &target)
+{
+    const QMatrix4x4 m = root ? projection * qsg_matrixForRoot(root) : projection;
+    const QPointF corners[4] = {
+        m.map(QPointF(bounds.tl.x, bounds.tl.y)),
+        m.map(QPointF(bounds.br.x, bounds.tl.y)),
+        m.map(QPointF(bounds.tl.x, bounds.br.y)),
+        m.map(QPointF(bounds.br.x, bounds.br.y))
+    };
+    qreal x1 = corners[0].x(), x2 = x1, y1 = corners[0].y(), y2 = y1;
+    for (int j = 1; j < 4; ++j) {
+        x1 = qMin(x1, corners[j].x());
+        x2 = qMax(x2, corners[j].x());
+        y1 = qMin(y1, corners[j].y());
+        y2 = qMax(y2, corners[j].y());
+    }
+    // From normalized device coordinates to window pixels, with a pixel
+    // of margin for antialiased edges.
+    const qreal halfWidth = target.width() * qreal(0.5);
+    const qreal halfHeight = target.height() * qreal(0.5);
+    const QRectF r(QPointF((x1 + 1) * halfWidth, (y1 + 1) * halfHeight),
+                   QPointF((x2 + 1) * halfWidth, (y2 + 1) * halfHeight));
+    return r.toAlignedRect().adjusted(-1, -1, 1, 1);
+}
+
+void Renderer::damageElement(Element *e, bool hadBounds)
+{
+    if (m_fullDamage || e->damaged)
+        return;
+    if (e->isRenderNode) {
+        m_fullDamage = true;
+        return;
+    }
+    if (hadBounds) {
+        if (!e->boundsComputed) {
+            m_fullDamage = true;
+            return;
+        }
+        addDamage(e->bounds, e->root);
+    }
+    e->damaged = true;
+    m_damagedElements.add(e);
+}
+
+void Renderer::damageSubtree(Node *node)
+{
+    if (m_fullDamage)
+        return;
+    if (node->type() == QSGNode::GeometryNodeType) {
+        Element *e = node->element();
+        if (e)
+            damageElement(e);
+    } else if (node->type() == QSGNode::RenderNodeType) {
+        m_fullDamage = true;
+        return;
+    }
+    SHADOWNODE_TRAVERSE(node)
+        damageSubtree(*child);
+}
+
+/*
+ * Queues the bounds an element was rendered at in the previous frame. Must be
+ * called before the node updater has updated the root matrices for the next
+ * frame, which is the case during synchronization and preprocessing.
+ */
+void Renderer::addDamage(const Rect &bounds, Node *root)
+{
+    if (m_fullDamage)
+        return;
+    if (bounds.isOutsideFloatRange()) {
+        m_fullDamage = true;
+        return;
+    }
+    m_damagedRects.add(qsg_damageRectForBounds(bounds, root, m_lastProjectionMatrix,
+                                               m_lastDeviceRect.size()));
+}
+
+/*
+ * Computes the damage of the frame about to be rendered into
+ * m_damageScissorRect and QSGRenderer::m_damage_rect. Rendering is only
+ * scissored to the damage when the render target is known to still hold
+ * the previous frame, which is the case for single buffered windows.
+ * Otherwise the damage only tells the render loop whether the frame needs
+ * to be presented at all.
+ */
+void Renderer::updateDamage()
+{
+    const QRect deviceRect = this->deviceRect();
+    const QRect target(0, 0, deviceRect.width(), deviceRect.height());
+    const QMatrix4x4 projection = projectionMatrix();
+
+    // Other targets than the default framebuffer may be reused or read back
+    // by their owner at any time.
+    bool full = m_fullDamage
+            || !m_renders_to_default_fbo
+            || m_full_repaint_requested
+            || m_visualizeMode != VisualizeNothing
+            || !m_renderNodeElements.isEmpty()
+            || deviceRect != m_lastDeviceRect
+            || viewportRect() != m_lastViewportRect
+            || projection != m_lastProjectionMatrix
+            || clearColor() != m_lastClearColor
+            || clearMode() != m_lastClearMode;
+
+    QRect damage;
+    if (!full) {
+        for (int i = 0; i < m_damagedRects.size(); ++i)
+            damage |= m_damagedRects.at(i);
+    }
+
+    for (int i = 0; i < m_damagedElements.size(); ++i) {
+        Element *e = m_damagedElements.at(i);
+        e->damaged = false;
+        if (full || e->removed)
+            continue;
+        e->ensureBoundsValid();
+        if (e->bounds.isOutsideFloatRange()) {
+            full = true;
+            continue;
+        }
+        damage |= qsg_damageRectForBounds(e->bounds, e->root, projection, target.size());
+    }
+
+    if (full)
+        damage = target;
+    else
+        damage &= target;
+
+    m_damagedElements.reset();
+    m_damagedRects.reset();
+    m_fullDamage = false;
+    m_lastDeviceRect = deviceRect;
+    m_lastViewportRect = viewportRect();
+    m_lastProjectionMatrix = projection;
+    m_lastClearColor = clearColor();
+    m_lastClearMode = clearMode();
+
+    m_damageScissorRect = damage;
+    m_damage_rect = damage.isEmpty()
+            ? QRect()
+            : QRect(deviceRect.x() + damage.x(),
+                    deviceRect.y() + target.height() - damage.y() - damage.height(),
+                    damage.width(), damage.height());
+
+    m_scissorToDamage = !full && !damage.isEmpty()
+            && context()->openglContext()->format().swapBehavior() == QSurfaceFormat::SingleBuffer;
+
+    if (Q_UNLIKELY(debug_render()))
+        qDebug() << " -> damage:" << m_damage_rect << (full ? "(full)" : "") << (m_scissorToDamage ? "scissored" : "");
+}
+
+void Renderer::applyDamageScissor()
+{
+    if (m_scissorToDamage) {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(m_damageScissorRect.x(), m_damageScissorRect.y(),
+                  m_damageScissorRect.width(), m_damageScissorRect.height());
+    } else {
+        glDisable(GL_SCISSOR_TEST);
+    }
+}
+
+bool Renderer::canMergeBatch(const Batch *b)
+{
+    QSGGeometryNode *gn = b->first->node;
+    QSGGeometry *g = gn->geometry();
+    QSGMaterial::Flags flags = gn->activeMaterial()->flags();
+    return (g->drawingMode() == GL_TRIANGLES || g->drawingMode() == GL_TRIANGLE_STRIP ||
+            g->drawingMode() == GL_LINES || g->drawingMode() == GL_POINTS)
+            && b->positionAttribute >= 0
+            && g->indexType() == GL_UNSIGNED_SHORT
+            && (flags & (QSGMaterial::CustomCompileStep | QSGMaterial_FullMatrix)) == 0
+            && ((flags & QSGMaterial::RequiresFullMatrixExceptTranslate) == 0 || b->isTranslateOnlyToRoot())
+            && b->isSafeToBatch();
+}
+
+/*
+ * When only the vertex data or transforms of some elements in a merged batch
+ * have changed, and their vertex and index counts are the same as in the last
+ * upload, the layout of the batch is unchanged. The changed elements are then
+ * written to the existing buffer object in place instead of uploading the whole
+ * batch again. Returns false if a full upload is needed.
+ */
+bool Renderer::uploadChangedElements(Batch *b)
+{
+    if (!b->first || b->isRenderNode || !b->merged || b->vbo.id == 0)
+        return false;
+
+    // Client side buffers are used for drawing in these cases.
+    if (m_context->hasBrokenIndexBufferObjects() || m_visualizeMode != VisualizeNothing)
+        return false;
+
+    if (!canMergeBatch(b))
+        return false;
+
+    int changedCount = 0;
+    for (Element *e = b->first; e; e = e->nextInBatch) {
+        if (!e->vertexDataChanged)
+            continue;
+        QSGGeometry *eg = e->node->geometry();
+        if (eg->vertexCount() != e->uploadedVertexCount || eg->indexCount() != e->uploadedIndexCount)
+            return false;
+        ++changedCount;
+    }
+
+    if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch:" << b << "updating" << changedCount << "changed elements in place";
+
+    const int vSize = b->first->node->geometry()->sizeOfVertex();
+    glBindBuffer(GL_ARRAY_BUFFER, b->vbo.id);
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, b->ibo.id);
+#endif
+
+    for (Element *e = b->first; e; e = e->nextInBatch) {
+        if (!e->vertexDataChanged)
+            continue;
+        QSGGeometry *eg = e->node->geometry();
+        const int vCount = eg->vertexCount();
+        const int vertexBytes = vCount * vSize;
+        const int zBytes = m_useDepthBuffer ? vCount * int(sizeof(float)) : 0;
+        // Indices of the element, plus the degenerate ones of triangle strips.
+        const int indexBytes = ((eg->indexCount() ? eg->indexCount() : vCount) + 2) * int(sizeof(quint16));
+        if (vertexBytes + zBytes + indexBytes > m_vertexUploadPool.size())
+            m_vertexUploadPool.resize(vertexBytes + zBytes + indexBytes);
+
+        char *vertexData = m_vertexUploadPool.data();
+        char *zData = vertexData + vertexBytes;
+        char *indexData = zData + zBytes;
+        quint16 iBase = e->indexBaseInBatch;
+        int indexCount = 0;
+        uploadMergedElement(e, b->positionAttribute, &vertexData, &zData, &indexData, &iBase, &indexCount);
+
+        const char *data = m_vertexUploadPool.data();
+        glBufferSubData(GL_ARRAY_BUFFER, e->firstVertexInBatch * vSize, vertexBytes, data);
+        if (m_useDepthBuffer) {
+            glBufferSubData(GL_ARRAY_BUFFER, b->vertexCount * vSize + e->firstVertexInBatch * sizeof(float),
+                            zBytes, data + vertexBytes);
+        }
+        // Generated indices only depend on the vertex count, which is unchanged.
+        if (eg->indexCount()) {
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, e->indexOffsetInBatch, indexData - (data + vertexBytes + zBytes),
+                            data + vertexBytes + zBytes);
+#else
+            glBufferSubData(GL_ARRAY_BUFFER, e->indexOffsetInBatch, indexData - (data + vertexBytes + zBytes),
+                            data + vertexBytes + zBytes);
+#endif
+        }
+        e->vertexDataChanged = false;
+    }
+
+    if (Q_UNLIKELY(debug_render()))
+        b->uploadedThisFrame = true;
+    return true;
+}
+
 void Renderer::uploadBatch(Batch *b)
 {
+        if (b->needsPartialUpload) {
+            if (!b->needsUpload && !uploadChangedElements(b))
+                b->needsUpload = true;
+            b->needsPartialUpload = false;
+        }
+
         // Early out if nothing has changed in this batch..
         if (!b->needsUpload) {
             if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch:" << b << "already uploaded...";
@@ -1777,16 +2355,8 @@ void Renderer::uploadBatch(Batch *b)
 
         QSGGeometryNode *gn = b->first->node;
         QSGGeometry *g =  gn->geometry();
-        QSGMaterial::Flags flags = gn->activeMaterial()->flags();
-        bool canMerge = (g->drawingMode() == GL_TRIANGLES || g->drawingMode() == GL_TRIANGLE_STRIP ||
-                         g->drawingMode() == GL_LINES || g->drawingMode() == GL_POINTS)
-                        && b->positionAttribute >= 0
-                        && g->indexType() == GL_UNSIGNED_SHORT
-                        && (flags & (QSGMaterial::CustomCompileStep | QSGMaterial_FullMatrix)) == 0
-                        && ((flags & QSGMaterial::RequiresFullMatrixExceptTranslate) == 0 || b->isTranslateOnlyToRoot())
-                        && b->isSafeToBatch();
 
-        b->merged = canMerge;
+        b->merged = canMergeBatch(b);
 
         // Figure out how much memory we need...
         b->vertexCount = 0;
@@ -1887,6 +2457,16 @@ void Renderer::uploadBatch(Batch *b)
                     verticesInSet = e->node->geometry()->vertexCount();
                     indicesInSet = 0;
                 }
+                e->firstVertexInBatch = (vertexData - b->vbo.data) / g->sizeOfVertex();
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+                e->indexOffsetInBatch = indexData - b->ibo.data;
+#else
+                e->indexOffsetInBatch = indexData - b->vbo.data;
+#endif
+                e->indexBaseInBatch = iOffset;
+                e->uploadedVertexCount = e->node->geometry()->vertexCount();
+                e->uploadedIndexCount = e->node->geometry()->indexCount();
+                e->vertexDataChanged = false;
                 uploadMergedElement(e, b->positionAttribute, &vertexData, &zData, &indexData, &iOffset, &indicesInSet);
                 e = e->nextInBatch;
             }
@@ -1915,6 +2495,7 @@ void Renderer::uploadBatch(Batch *b)
                     memcpy(iboData, g->indexData(), ibs);
                     iboData += ibs;
                 }
+                e->vertexDataChanged = false;
                 e = e->nextInBatch;
             }
         }
@@ -1998,13 +2579,13 @@ Renderer::ClipType Renderer::updateStencilClip(const QSGClipNode *clip)
 {
     if (!clip) {
         glDisable(GL_STENCIL_TEST);
-        glDisable(GL_SCISSOR_TEST);
+        applyDamageScissor();
         return NoClip;
     }
 
     ClipType clipType = NoClip;
 
-    glDisable(GL_SCISSOR_TEST);
+    applyDamageScissor();
 
     m_currentStencilValue = 0;
     m_currentScissorRect = QRect();
@@ -2050,6 +2631,8 @@ Renderer::ClipType Renderer::updateStencilClip(const QSGClipNode *clip)
 
             if (!(clipType & ScissorClip)) {
                 m_currentScissorRect = QRect(ix1, iy1, ix2 - ix1, iy2 - iy1);
+                if (m_scissorToDamage)
+                    m_currentScissorRect &= m_damageScissorRect;
                 glEnable(GL_SCISSOR_TEST);
                 clipType |= ScissorClip;
             } else {
@@ -2471,7 +3054,7 @@ void Renderer::renderBatches()
     }
     glDisable(GL_CULL_FACE);
     glColorMask(true, true, true, true);
-    glDisable(GL_SCISSOR_TEST);
+    applyDamageScissor();
     glDisable(GL_STENCIL_TEST);
 
     bindable()->clear(clearMode());
@@ -2580,6 +3163,8 @@ void Renderer::render()
         timer.start();
     }
 
+    updateDamage();
+
     if (m_vao)
         m_vao->bind();
 
@@ -2698,7 +3283,9 @@ void Renderer::render()
         m_indexUploadPool.resize(largestIBO * 2);
 #endif
 
-    renderBatches();
+    // An empty damage means the frame would be identical to the previous one.
+    if (!m_damageScissorRect.isEmpty())
+        renderBatches();
 
     if (Q_UNLIKELY(debug_render())) {
         qDebug(" -> times: build: %d, prepare(opaque/alpha): %d/%d, sorting: %d, upload(opaque/alpha): %d/%d, render: %d",
@@ -2716,6 +3303,19 @@ void Renderer::render()
     if (m_visualizeMode != VisualizeNothing)
         visualize();
 
+    // The bounds an element is rendered at now are the area it damages when it
+    // changes or goes away, so make sure they are known.
+    for (int i = 0; i < m_opaqueRenderList.size(); ++i) {
+        Element *e = m_opaqueRenderList.at(i);
+        if (e)
+            e->ensureBoundsValid();
+    }
+    for (int i = 0; i < m_alphaRenderList.size(); ++i) {
+        Element *e = m_alphaRenderList.at(i);
+        if (e && !e->isRenderNode)
+            e->ensureBoundsValid();
+    }
+
     if (m_vao)
         m_vao->release();
 }
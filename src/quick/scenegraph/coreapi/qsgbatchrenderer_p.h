@@ -296,6 +296,11 @@ struct Element {
         , nextInBatch(0)
         , root(0)
         , order(0)
+        , firstVertexInBatch(0)
+        , indexOffsetInBatch(0)
+        , uploadedVertexCount(0)
+        , uploadedIndexCount(0)
+        , indexBaseInBatch(0)
         , boundsComputed(false)
         , boundsOutsideFloatRange(false)
         , translateOnlyToRoot(false)
@@ -303,6 +308,8 @@ struct Element {
         , orphaned(false)
         , isRenderNode(false)
         , isMaterialBlended(false)
+        , vertexDataChanged(false)
+        , damaged(false)
     {
     }
 
@@ -326,6 +333,14 @@ struct Element {
 
     int order;
 
+    // Placement of the element by the last upload of its merged batch, which
+    // allows changed elements to be updated in place. See Renderer::uploadBatch().
+    int firstVertexInBatch;
+    int indexOffsetInBatch;
+    int uploadedVertexCount;
+    int uploadedIndexCount;
+    quint16 indexBaseInBatch;
+
     uint boundsComputed : 1;
     uint boundsOutsideFloatRange : 1;
     uint translateOnlyToRoot : 1;
@@ -333,6 +348,8 @@ struct Element {
     uint orphaned : 1;
     uint isRenderNode : 1;
     uint isMaterialBlended : 1;
+    uint vertexDataChanged : 1;
+    uint damaged : 1; // queued in Renderer::m_damagedElements
 };
 
 struct RenderNodeElement : public Element {
@@ -390,6 +407,12 @@ struct Batch
     void invalidate();
     void cleanupRemovedElements();
 
+    // Only the vertex data or transform of 'e' has changed.
+    void elementChanged(Element *e) {
+        e->vertexDataChanged = true;
+        needsPartialUpload = true;
+    }
+
     bool isTranslateOnlyToRoot() const;
     bool isSafeToBatch() const;
 
@@ -401,6 +424,7 @@ struct Batch
         indexCount = 0;
         isOpaque = false;
         needsUpload = false;
+        needsPartialUpload = false;
         merged = false;
         positionAttribute = -1;
         uploadedThisFrame = false;
@@ -419,6 +443,7 @@ struct Batch
 
     uint isOpaque : 1;
     uint needsUpload : 1;
+    uint needsPartialUpload : 1;
     uint merged : 1;
     uint isRenderNode : 1;
 
@@ -590,14 +615,23 @@ private:
 
     void deleteRemovedElements();
     void cleanupBatches(QDataBuffer<Batch *> *batches);
+    int buildBatchChains(const QDataBuffer<Element *> &list, bool backwards);
     void prepareOpaqueBatches();
     bool checkOverlap(int first, int last, const Rect &bounds);
     void prepareAlphaBatches();
     void invalidateBatchAndOverlappingRenderOrders(Batch *batch);
 
+    bool canMergeBatch(const Batch *b);
+    bool uploadChangedElements(Batch *b);
     void uploadBatch(Batch *b);
     void uploadMergedElement(Element *e, int vaOffset, char **vertexData, char **zData, char **indexData, quint16 *iBase, int *indexCount);
 
+    void damageElement(Element *e, bool hadBounds = true);
+    void damageSubtree(Node *node);
+    void addDamage(const Rect &bounds, Node *root);
+    void updateDamage();
+    void applyDamageScissor();
+
     void renderBatches();
     void renderMergedBatch(const Batch *batch);
     void renderUnmergedBatch(const Batch *batch);
@@ -649,6 +683,7 @@ private:
     QDataBuffer<Element *> m_elementsToDelete;
     QDataBuffer<Element *> m_tmpAlphaElements;
     QDataBuffer<Element *> m_tmpOpaqueElements;
+    QDataBuffer<int> m_batchChain; // next element with the same BatchKey, see buildBatchChains()
 
     uint m_rebuild;
     qreal m_zRange;
@@ -672,6 +707,18 @@ private:
     const QSGClipNode *m_currentClip;
     ClipType m_currentClipType;
 
+    // Damage tracking, see updateDamage(). Rects are in GL window coordinates.
+    QDataBuffer<Element *> m_damagedElements;
+    QDataBuffer<QRect> m_damagedRects;
+    bool m_fullDamage;
+    bool m_scissorToDamage;
+    QRect m_damageScissorRect;
+    QRect m_lastDeviceRect;
+    QRect m_lastViewportRect;
+    QMatrix4x4 m_lastProjectionMatrix;
+    QColor m_lastClearColor;
+    ClearMode m_lastClearMode;
+
     QDataBuffer<char> m_vertexUploadPool;
 #ifdef QSG_SEPARATE_INDEX_BUFFER
     QDataBuffer<char> m_indexUploadPool;
@@ -105,6 +105,14 @@ void QSGBindableFboId::bind() const
     The renderer can make use of stencil, depth and color buffers in addition to the
     scissor rect.
 
+    After rendering, damageRect() holds the part of the device rect, in device
+    pixels with the origin in the top-left corner, that differs from the
+    previously rendered frame. It is the full device rect unless the renderer
+    tracks changes itself, and empty when the frame is identical to the previous
+    one, in which case the render loop does not need to present it. Call
+    requestFullRepaint() when the render target no longer holds the previous
+    frame, or when something other than the scene graph draws into it.
+
     \internal
  */
 
@@ -114,6 +122,8 @@ QSGRenderer::QSGRenderer(QSGRenderContext *context)
     , m_current_determinant(1)
     , m_device_pixel_ratio(1)
     , m_context(context)
+    , m_full_repaint_requested(true)
+    , m_renders_to_default_fbo(false)
     , m_node_updater(0)
     , m_bindable(0)
     , m_changed_emitted(false)
@@ -165,6 +175,8 @@ bool QSGRenderer::isMirrored() const
 
 void QSGRenderer::renderScene(GLuint fboId)
 {
+    // Only the default framebuffer is known to be presented by the render loop.
+    m_renders_to_default_fbo = fboId == 0;
     if (fboId) {
         QSGBindableFboId bindable(fboId);
         renderScene(bindable);
@@ -215,7 +227,10 @@ void QSGRenderer::renderScene(const QSGBindable &bindable)
         }
     }
 
+    // Renderers that track damage narrow this down in render().
+    m_damage_rect = deviceRect();
     render();
+    m_full_repaint_requested = false;
     if (profileFrames)
         renderTime = frameTimer.nsecsElapsed();
     Q_QUICK_SG_PROFILE_END(QQuickProfiler::SceneGraphRendererFrame,
@@ -223,6 +238,7 @@ void QSGRenderer::renderScene(const QSGBindable &bindable)
 
     m_is_rendering = false;
     m_changed_emitted = false;
+    m_renders_to_default_fbo = false;
     m_bindable = 0;
 
     qCDebug(QSG_LOG_TIME_RENDERER,
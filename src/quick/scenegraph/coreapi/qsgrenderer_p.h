@@ -92,6 +92,9 @@ public:
 
     void clearChangedFlag() { m_changed_emitted = false; }
 
+    QRect damageRect() const { return m_damage_rect; }
+    void requestFullRepaint() { m_full_repaint_requested = true; }
+
 protected:
     virtual void render() = 0;
 
@@ -110,6 +113,10 @@ protected:
 
     QSGRenderContext *m_context;
 
+    QRect m_damage_rect;
+    bool m_full_repaint_requested;
+    bool m_renders_to_default_fbo;
+
 private:
     QSGNodeUpdater *m_node_updater;
 
@@ -39,15 +39,292 @@
 #include <QtQuick/private/qsgcontext_p.h>
 #include <private/qrawfont_p.h>
 #include <QtGui/qguiapplication.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtQml/private/qqmlglobal_p.h>
 #include <qdir.h>
+#include <qfileinfo.h>
+#include <qsavefile.h>
+#include <qstandardpaths.h>
+#include <qcryptographichash.h>
+#include <qdatetime.h>
+#include <qmutex.h>
+#include <qrunnable.h>
+#include <qthreadpool.h>
 
 #include <private/qquickprofiler_p.h>
 #include <QElapsedTimer>
 
 QT_BEGIN_NAMESPACE
 
+DEFINE_BOOL_CONFIG_OPTION(qsgSynchronousDistanceFields, QSG_DISTANCEFIELD_SYNCHRONOUS)
+DEFINE_BOOL_CONFIG_OPTION(qsgDisableDistanceFieldDiskCache, QSG_DISTANCEFIELD_NO_DISK_CACHE)
+
+// Batches up to this size are cheaper to generate right away than to hand
+// over to a worker thread and show one frame later.
+static const int qsg_maxSynchronousGlyphs = 16;
+
 static QElapsedTimer qsg_render_timer;
 
+/*
+    Distance fields of glyphs are stored on disk, one file per glyph, in a
+    directory per font file. The directory name hashes everything the field
+    depends on, so a changed font file or distance field setup simply ends up
+    in a different directory. The cache is only ever read and written by the
+    worker threads, never by the render thread.
+ */
+
+struct QSGDistanceFieldFileHeader
+{
+    quint32 magic;
+    quint16 width;
+    quint16 height;
+};
+
+static const quint32 qsg_distanceFieldFileMagic = 0x51534446; // "QSDF"
+
+// The directories of the least recently written fonts are removed once the
+// cache grows beyond this size.
+static const qint64 qsg_maxDistanceFieldCacheSize = 32 * 1024 * 1024;
+
+QString QSGDistanceFieldDiskCache::cachePath(const QFontEngine::FaceId &faceId, bool doubleResolution)
+{
+    // Fonts loaded from memory have no file to key the cache on
+    if (faceId.filename.isEmpty())
+        return QString();
+
+    const QFileInfo fontFile(QFile::decodeName(faceId.filename));
+    if (!fontFile.exists())
+        return QString();
+
+    QString root = QFile::decodeName(qgetenv("QSG_DISTANCEFIELD_CACHE_DIR"));
+    if (root.isEmpty()) {
+        root = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+        if (root.isEmpty())
+            return QString();
+        root += QLatin1String("/qtquick/distancefields");
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(faceId.filename);
+    hash.addData(QByteArray::number(faceId.index));
+    hash.addData(QByteArray::number(fontFile.size()));
+    hash.addData(QByteArray::number(fontFile.lastModified().toMSecsSinceEpoch()));
+    hash.addData(QByteArray::number(QT_DISTANCEFIELD_BASEFONTSIZE(doubleResolution)));
+    hash.addData(QByteArray::number(QT_DISTANCEFIELD_SCALE(doubleResolution)));
+    hash.addData(QByteArray::number(QT_DISTANCEFIELD_RADIUS(doubleResolution)));
+    return root + QLatin1Char('/') + QString::fromLatin1(hash.result().toHex());
+}
+
+/*
+    Returns false if \a glyph is not in the cache. Glyphs without outline
+    have an empty field, which is a valid cache entry as well.
+ */
+bool QSGDistanceFieldDiskCache::load(const QString &cachePath, glyph_t glyph, QDistanceField *field)
+{
+    QFile file(cachePath + QLatin1Char('/') + QString::number(glyph));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QByteArray data = file.readAll();
+    QSGDistanceFieldFileHeader header;
+    if (data.size() < int(sizeof(header)))
+        return false;
+    memcpy(&header, data.constData(), sizeof(header));
+
+    const int size = header.width * header.height;
+    if (header.magic != qsg_distanceFieldFileMagic || data.size() != int(sizeof(header)) + size)
+        return false;
+
+    *field = QDistanceField(header.width, header.height);
+    if (size > 0)
+        memcpy(field->bits(), data.constData() + sizeof(header), size);
+    return true;
+}
+
+bool QSGDistanceFieldDiskCache::save(const QString &cachePath, glyph_t glyph, const QDistanceField &field)
+{
+    QSaveFile file(cachePath + QLatin1Char('/') + QString::number(glyph));
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (!QDir().mkpath(cachePath) || !file.open(QIODevice::WriteOnly))
+            return false;
+    }
+
+    const int size = field.isNull() ? 0 : field.width() * field.height();
+    QSGDistanceFieldFileHeader header;
+    header.magic = qsg_distanceFieldFileMagic;
+    header.width = size > 0 ? field.width() : 0;
+    header.height = size > 0 ? field.height() : 0;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (size > 0)
+        file.write(reinterpret_cast<const char *>(field.constBits()), size);
+    return file.commit();
+}
+
+/*
+    Removes the directories of other fonts, least recently written first,
+    until the cache holding \a cachePath takes at most \a maximumSize bytes.
+    Returns false if the directory of \a cachePath alone exceeds the limit,
+    in which case no more glyphs should be written to it.
+ */
+bool QSGDistanceFieldDiskCache::prune(const QString &cachePath, qint64 maximumSize)
+{
+    const QFileInfo cacheDir(cachePath);
+    const QDir root = cacheDir.dir();
+    const QFileInfoList fontDirs = root.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Time | QDir::Reversed);
+
+    qint64 totalSize = 0;
+    qint64 ownSize = 0;
+    QVector<qint64> sizes;
+    sizes.reserve(fontDirs.size());
+    foreach (const QFileInfo &fontDir, fontDirs) {
+        qint64 size = 0;
+        foreach (const QFileInfo &glyphFile, QDir(fontDir.filePath()).entryInfoList(QDir::Files))
+            size += glyphFile.size();
+        sizes.append(size);
+        totalSize += size;
+        if (fontDir.fileName() == cacheDir.fileName())
+            ownSize = size;
+    }
+
+    for (int i = 0; i < fontDirs.size() && totalSize > maximumSize; ++i) {
+        if (fontDirs.at(i).fileName() == cacheDir.fileName())
+            continue;
+        if (QDir(fontDirs.at(i).filePath()).removeRecursively())
+            totalSize -= sizes.at(i);
+    }
+
+    return ownSize < maximumSize;
+}
+
+/*
+    Distance fields generated on worker threads are collected here until the
+    cache picks them up in its next update(). The cache and its pending jobs
+    share ownership, so jobs can outlive the cache.
+ */
+class QSGDistanceFieldGlyphResults
+{
+public:
+    QSGDistanceFieldGlyphResults(const QFontEngine::FaceId &faceId, bool doubleResolution)
+        : faceId(faceId)
+        , doubleResolution(doubleResolution)
+        , diskCacheResolved(false)
+        , diskCacheWritable(false)
+    {
+    }
+
+    QMutex mutex;
+    QHash<glyph_t, QDistanceField> fields;
+
+    // Resolved by the first job that runs, as it needs to look at the disk
+    const QFontEngine::FaceId faceId;
+    const bool doubleResolution;
+    QMutex diskCacheMutex;
+    bool diskCacheResolved;
+    bool diskCacheWritable;
+    QString diskCachePath;
+};
+
+/*
+    Lives on the GUI thread and schedules a frame on all Qt Quick windows
+    when worker threads have finished glyphs, coalescing the notifications of
+    jobs that finish close together.
+ */
+class QSGDistanceFieldGlyphReadyNotifier : public QObject
+{
+public:
+    QSGDistanceFieldGlyphReadyNotifier()
+    {
+        if (QCoreApplication::instance())
+            moveToThread(QCoreApplication::instance()->thread());
+    }
+
+    void notify()
+    {
+        if (m_posted.testAndSetOrdered(0, 1))
+            QCoreApplication::postEvent(this, new QEvent(QEvent::User));
+    }
+
+    bool event(QEvent *e) Q_DECL_OVERRIDE
+    {
+        if (e->type() != QEvent::User)
+            return QObject::event(e);
+
+        m_posted.store(0);
+        foreach (QWindow *window, QGuiApplication::allWindows()) {
+            if (QQuickWindow *quickWindow = qobject_cast<QQuickWindow *>(window))
+                quickWindow->update();
+        }
+        return true;
+    }
+
+private:
+    QAtomicInt m_posted;
+};
+
+// The notifier must be created before the thread pool so that it is destroyed
+// after the pool has waited for the last job.
+Q_GLOBAL_STATIC(QSGDistanceFieldGlyphReadyNotifier, qsg_glyphReadyNotifier)
+Q_GLOBAL_STATIC(QThreadPool, qsg_distanceFieldThreadPool)
+
+class QSGDistanceFieldGenerationJob : public QRunnable
+{
+public:
+    QSGDistanceFieldGenerationJob(const QSharedPointer<QSGDistanceFieldGlyphResults> &results,
+                                  const QVector<glyph_t> &glyphs,
+                                  const QVector<QPainterPath> &paths)
+        : m_results(results)
+        , m_glyphs(glyphs)
+        , m_paths(paths)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        QString cachePath;
+        bool writable = false;
+        if (!m_results->faceId.filename.isEmpty()) {
+            QMutexLocker locker(&m_results->diskCacheMutex);
+            if (!m_results->diskCacheResolved) {
+                m_results->diskCacheResolved = true;
+                m_results->diskCachePath = QSGDistanceFieldDiskCache::cachePath(m_results->faceId,
+                                                                               m_results->doubleResolution);
+                if (!m_results->diskCachePath.isEmpty()) {
+                    m_results->diskCacheWritable = QSGDistanceFieldDiskCache::prune(m_results->diskCachePath,
+                                                                                    qsg_maxDistanceFieldCacheSize);
+                }
+            }
+            cachePath = m_results->diskCachePath;
+            writable = m_results->diskCacheWritable;
+        }
+
+        QList<QDistanceField> fields;
+        fields.reserve(m_glyphs.size());
+        for (int i = 0; i < m_glyphs.size(); ++i) {
+            QDistanceField field;
+            if (cachePath.isEmpty() || !QSGDistanceFieldDiskCache::load(cachePath, m_glyphs.at(i), &field)) {
+                field = QDistanceField(m_paths.at(i), m_glyphs.at(i), m_results->doubleResolution);
+                if (writable)
+                    QSGDistanceFieldDiskCache::save(cachePath, m_glyphs.at(i), field);
+            }
+            fields.append(field);
+        }
+
+        {
+            QMutexLocker locker(&m_results->mutex);
+            for (int i = 0; i < m_glyphs.size(); ++i)
+                m_results->fields.insert(m_glyphs.at(i), fields.at(i));
+        }
+
+        if (QSGDistanceFieldGlyphReadyNotifier *notifier = qsg_glyphReadyNotifier())
+            notifier->notify();
+    }
+
+private:
+    QSharedPointer<QSGDistanceFieldGlyphResults> m_results;
+    QVector<glyph_t> m_glyphs;
+    QVector<QPainterPath> m_paths;
+};
+
 QSGDistanceFieldGlyphCache::Texture QSGDistanceFieldGlyphCache::s_emptyTexture;
 
 QSGDistanceFieldGlyphCache::QSGDistanceFieldGlyphCache(QSGDistanceFieldGlyphCacheManager *man, QOpenGLContext *c, const QRawFont &font)
@@ -68,6 +345,9 @@ QSGDistanceFieldGlyphCache::QSGDistanceFieldGlyphCache(QSGDistanceFieldGlyphCach
     Q_ASSERT(m_referenceFont.isValid());
 
     m_coreProfile = (c->format().profile() == QSurfaceFormat::CoreProfile);
+
+    if (!qsgDisableDistanceFieldDiskCache())
+        m_diskCacheFaceId = fontD->fontEngine->faceId();
 }
 
 QSGDistanceFieldGlyphCache::~QSGDistanceFieldGlyphCache()
@@ -156,22 +436,31 @@ void QSGDistanceFieldGlyphCache::update()
 {
     m_populatingGlyphs.clear();
 
+    if (!m_generatingGlyphs.isEmpty())
+        storeGeneratedGlyphs();
+
     if (m_pendingGlyphs.isEmpty())
         return;
 
+    if (m_pendingGlyphs.size() > qsg_maxSynchronousGlyphs && !qsgSynchronousDistanceFields()) {
+        generateGlyphsAsync();
+        return;
+    }
+
     bool profileFrames = QSG_LOG_TIME_GLYPH().isDebugEnabled();
     if (profileFrames)
         qsg_render_timer.start();
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphAdaptationLayerFrame);
 
-    QList<QDistanceField> distanceFields;
+    QHash<glyph_t, QDistanceField> distanceFields;
     const int pendingGlyphsSize = m_pendingGlyphs.size();
     distanceFields.reserve(pendingGlyphsSize);
     for (int i = 0; i < pendingGlyphsSize; ++i) {
-        GlyphData &gd = glyphData(m_pendingGlyphs.at(i));
-        distanceFields.append(QDistanceField(gd.path,
-                                             m_pendingGlyphs.at(i),
-                                             m_doubleGlyphResolution));
+        glyph_t glyphIndex = m_pendingGlyphs.at(i);
+        GlyphData &gd = glyphData(glyphIndex);
+        distanceFields.insert(glyphIndex, QDistanceField(gd.path,
+                                                         glyphIndex,
+                                                         m_doubleGlyphResolution));
         gd.path = QPainterPath(); // no longer needed, so release memory used by the painter path
     }
 
@@ -205,6 +494,74 @@ void QSGDistanceFieldGlyphCache::update()
                                         (qint64)count);
 }
 
+void QSGDistanceFieldGlyphCache::generateGlyphsAsync()
+{
+    const int count = m_pendingGlyphs.size();
+    QVector<glyph_t> glyphs(count);
+    QVector<QPainterPath> paths(count);
+    for (int i = 0; i < count; ++i) {
+        glyph_t glyphIndex = m_pendingGlyphs.at(i);
+        GlyphData &gd = glyphData(glyphIndex);
+        glyphs[i] = glyphIndex;
+        paths[i] = gd.path;
+        gd.path = QPainterPath();
+        m_generatingGlyphs.insert(glyphIndex);
+    }
+    m_pendingGlyphs.reset();
+
+    if (!m_generatedGlyphs) {
+        m_generatedGlyphs = QSharedPointer<QSGDistanceFieldGlyphResults>(
+                    new QSGDistanceFieldGlyphResults(m_diskCacheFaceId, m_doubleGlyphResolution));
+    }
+
+    // The glyphs keep their place in the atlas but no texture, so consumers
+    // leave them out until storeGeneratedGlyphs() has uploaded them.
+    qsg_glyphReadyNotifier();
+    qsg_distanceFieldThreadPool()->start(new QSGDistanceFieldGenerationJob(m_generatedGlyphs, glyphs, paths));
+
+    qCDebug(QSG_LOG_TIME_GLYPH, "distancefield: %d glyphs sent to worker threads", count);
+}
+
+void QSGDistanceFieldGlyphCache::storeGeneratedGlyphs()
+{
+    QHash<glyph_t, QDistanceField> generated;
+    {
+        QMutexLocker locker(&m_generatedGlyphs->mutex);
+        generated.swap(m_generatedGlyphs->fields);
+    }
+
+    QHash<glyph_t, QDistanceField> distanceFields;
+    QVector<glyph_t> readyGlyphs;
+    for (QHash<glyph_t, QDistanceField>::const_iterator it = generated.constBegin(), cend = generated.constEnd(); it != cend; ++it) {
+        // Glyphs evicted from the atlas in the meantime have no place to go,
+        // and a glyph that was requested twice is only stored once.
+        if (!m_generatingGlyphs.remove(it.key()) || !containsGlyph(it.key()))
+            continue;
+        distanceFields.insert(it.key(), it.value());
+        readyGlyphs.append(it.key());
+    }
+
+    if (distanceFields.isEmpty())
+        return;
+
+    storeGlyphs(distanceFields);
+
+    // setGlyphsTexture() only reports glyphs that had a texture already,
+    // these were left out by the consumers so far.
+    invalidateConsumers(readyGlyphs);
+
+    qCDebug(QSG_LOG_TIME_GLYPH, "distancefield: %d glyphs from worker threads stored", readyGlyphs.size());
+}
+
+void QSGDistanceFieldGlyphCache::invalidateConsumers(const QVector<glyph_t> &glyphs)
+{
+    QLinkedList<QSGDistanceFieldGlyphConsumer *>::iterator it = m_registeredNodes.begin();
+    while (it != m_registeredNodes.end()) {
+        (*it)->invalidateGlyphs(glyphs);
+        ++it;
+    }
+}
+
 void QSGDistanceFieldGlyphCache::setGlyphsPosition(const QList<GlyphPosition> &glyphs)
 {
     QVector<quint32> invalidatedGlyphs;
@@ -225,13 +582,8 @@ void QSGDistanceFieldGlyphCache::setGlyphsPosition(const QList<GlyphPosition> &g
         gd.texCoord.height = gd.boundingRect.height();
     }
 
-    if (!invalidatedGlyphs.isEmpty()) {
-        QLinkedList<QSGDistanceFieldGlyphConsumer *>::iterator it = m_registeredNodes.begin();
-        while (it != m_registeredNodes.end()) {
-            (*it)->invalidateGlyphs(invalidatedGlyphs);
-            ++it;
-        }
-    }
+    if (!invalidatedGlyphs.isEmpty())
+        invalidateConsumers(invalidatedGlyphs);
 }
 
 void QSGDistanceFieldGlyphCache::registerOwnerElement(QQuickItem *ownerElement)
@@ -271,13 +623,8 @@ void QSGDistanceFieldGlyphCache::setGlyphsTexture(const QVector<glyph_t> &glyphs
         gd.texture = texture;
     }
 
-    if (!invalidatedGlyphs.isEmpty()) {
-        QLinkedList<QSGDistanceFieldGlyphConsumer*>::iterator it = m_registeredNodes.begin();
-        while (it != m_registeredNodes.end()) {
-            (*it)->invalidateGlyphs(invalidatedGlyphs);
-            ++it;
-        }
-    }
+    if (!invalidatedGlyphs.isEmpty())
+        invalidateConsumers(invalidatedGlyphs);
 }
 
 void QSGDistanceFieldGlyphCache::markGlyphsToRender(const QVector<glyph_t> &glyphs)
@@ -505,6 +852,9 @@ void QSGNodeVisitorEx::visitChildren(QSGNode *node)
             visitChildren(child);
             break;
         }
+        case QSGNode::RenderNodeType:
+            // Render nodes issue their own OpenGL calls and cannot be visited.
+            break;
         default:
             Q_UNREACHABLE();
             break;
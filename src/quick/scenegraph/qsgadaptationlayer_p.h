@@ -69,6 +69,7 @@ class QImage;
 class TextureReference;
 class QSGDistanceFieldGlyphCacheManager;
 class QSGDistanceFieldGlyphNode;
+class QSGDistanceFieldGlyphResults;
 class QOpenGLContext;
 class QSGImageNode;
 class QSGPainterNode;
@@ -259,6 +260,15 @@ public:
     virtual void invalidateGlyphs(const QVector<quint32> &glyphs) = 0;
 };
 
+class Q_QUICK_PRIVATE_EXPORT QSGDistanceFieldDiskCache
+{
+public:
+    static QString cachePath(const QFontEngine::FaceId &faceId, bool doubleResolution);
+    static bool load(const QString &cachePath, glyph_t glyph, QDistanceField *field);
+    static bool save(const QString &cachePath, glyph_t glyph, const QDistanceField &field);
+    static bool prune(const QString &cachePath, qint64 maximumSize);
+};
+
 class Q_QUICK_PRIVATE_EXPORT QSGDistanceFieldGlyphCache
 {
 public:
@@ -344,7 +354,7 @@ protected:
     };
 
     virtual void requestGlyphs(const QSet<glyph_t> &glyphs) = 0;
-    virtual void storeGlyphs(const QList<QDistanceField> &glyphs) = 0;
+    virtual void storeGlyphs(const QHash<glyph_t, QDistanceField> &glyphs) = 0;
     virtual void referenceGlyphs(const QSet<glyph_t> &glyphs) = 0;
     virtual void releaseGlyphs(const QSet<glyph_t> &glyphs) = 0;
 
@@ -367,6 +377,10 @@ protected:
     inline bool isCoreProfile() const { return m_coreProfile; }
 
 private:
+    void generateGlyphsAsync();
+    void storeGeneratedGlyphs();
+    void invalidateConsumers(const QVector<glyph_t> &glyphs);
+
     QSGDistanceFieldGlyphCacheManager *m_manager;
 
     QRawFont m_referenceFont;
@@ -379,6 +393,9 @@ private:
     QHash<glyph_t, GlyphData> m_glyphsData;
     QDataBuffer<glyph_t> m_pendingGlyphs;
     QSet<glyph_t> m_populatingGlyphs;
+    QSet<glyph_t> m_generatingGlyphs;
+    QSharedPointer<QSGDistanceFieldGlyphResults> m_generatedGlyphs;
+    QFontEngine::FaceId m_diskCacheFaceId;
     QLinkedList<QSGDistanceFieldGlyphConsumer*> m_registeredNodes;
 
     static Texture s_emptyTexture;
@@ -52,6 +52,7 @@
 #include <QScreen>
 #include <QOpenGLContext>
 #include <QQuickWindow>
+#include <QQuickItem>
 #include <QtGui/qopenglframebufferobject.h>
 
 #include <private/qqmlglobal_p.h>
@@ -84,6 +85,8 @@ DEFINE_BOOL_CONFIG_OPTION(qmlDisableDistanceField, QML_DISABLE_DISTANCEFIELD)
 
 QT_BEGIN_NAMESPACE
 
+int qt_sg_envInt(const char *name, int defaultValue);
+
 // Used for very high-level info about the renderering and gl context
 // Includes GL_VERSION, type of render loop, atlas size, etc.
 Q_LOGGING_CATEGORY(QSG_LOG_INFO,                "qt.scenegraph.general")
@@ -527,6 +530,10 @@ QSGRenderContext::QSGRenderContext(QSGContext *context)
     , m_atlasManager(0)
     , m_depthStencilManager(0)
     , m_distanceFieldCacheManager(0)
+    , m_uploadBudget(qint64(qt_sg_envInt("QSG_TEXTURE_UPLOAD_BUDGET", 16384)) * 1024)
+    , m_uploadedBytes(0)
+    , m_deferredOnScreenBytes(0)
+    , m_reservedUploadBytes(0)
     , m_maxTextureSize(0)
     , m_brokenIBOs(false)
     , m_serializedRender(false)
@@ -543,6 +550,10 @@ void QSGRenderContext::endSync()
 {
     qDeleteAll(m_texturesToDelete);
     m_texturesToDelete.clear();
+
+    m_uploadedBytes = 0;
+    m_reservedUploadBytes = m_deferredOnScreenBytes;
+    m_deferredOnScreenBytes = 0;
 }
 
 static QBasicMutex qsg_framerender_mutex;
@@ -790,6 +801,71 @@ QSGTexture *QSGRenderContext::textureForFactory(QQuickTextureFactory *factory, Q
     return texture;
 }
 
+static bool qsg_isItemOnScreen(QQuickItem *item)
+{
+    QQuickWindow *window = item->window();
+    if (!window)
+        return false;
+
+    QRectF rect = item->mapRectToScene(item->clipRect()) & QRectF(0, 0, window->width(), window->height());
+    for (QQuickItem *parent = item->parentItem(); parent && !rect.isEmpty(); parent = parent->parentItem()) {
+        if (parent->clip())
+            rect &= parent->mapRectToScene(parent->clipRect());
+    }
+    return !rect.isEmpty();
+}
+
+/*!
+    Returns the texture for \a factory in the same way as textureForFactory(),
+    but limits how much new texture data is created, and thus uploaded, in a
+    single frame.
+
+    Textures that do not exist yet count against a budget of bytes per
+    synchronization, which is set in kilobytes with the environment variable
+    \c QSG_TEXTURE_UPLOAD_BUDGET and disabled by setting it to 0. The first
+    texture of a frame is always created, however large it is, but after
+    that the budget applies to all items.
+
+    Items that are at least partially on screen spend the budget first.
+    When the texture of such an item is deferred, its size is reserved in
+    the budget of the next frame, and items that are not on screen only get
+    what is left after the reservation and the textures deferred so far.
+
+    When the texture is deferred, this function returns 0 and schedules
+    another update of \a item, which should then show nothing, as it does
+    while its image is loading. It must be called from
+    QQuickItem::updatePaintNode().
+ */
+QSGTexture *QSGRenderContext::scheduledTextureForFactory(QQuickTextureFactory *factory, QQuickItem *item)
+{
+    if (!factory)
+        return 0;
+
+    if (m_uploadBudget > 0) {
+        m_mutex.lock();
+        const bool exists = m_textures.contains(factory);
+        m_mutex.unlock();
+
+        if (!exists) {
+            const qint64 bytes = factory->textureByteCount();
+            const bool onScreen = qsg_isItemOnScreen(item);
+            const qint64 spentBytes = onScreen
+                    ? m_uploadedBytes
+                    : m_uploadedBytes + m_reservedUploadBytes + m_deferredOnScreenBytes;
+            if (spentBytes > 0 && spentBytes + bytes > m_uploadBudget) {
+                qCDebug(QSG_LOG_INFO, "texture upload of %d bytes deferred to the next frame", int(bytes));
+                if (onScreen)
+                    m_deferredOnScreenBytes += bytes;
+                item->update();
+                return 0;
+            }
+            m_uploadedBytes += bytes;
+        }
+    }
+
+    return textureForFactory(factory, item->window());
+}
+
 void QSGRenderContext::textureFactoryDestroyed(QObject *o)
 {
     m_mutex.lock();
@@ -82,6 +82,7 @@ class QOpenGLContext;
 class QOpenGLFramebufferObject;
 
 class QQuickTextureFactory;
+class QQuickItem;
 class QSGDistanceFieldGlyphCacheManager;
 class QSGContext;
 class QQuickPaintedItem;
@@ -123,6 +124,7 @@ public:
 
     virtual QSGDistanceFieldGlyphCache *distanceFieldGlyphCache(const QRawFont &font);
     QSGTexture *textureForFactory(QQuickTextureFactory *factory, QQuickWindow *window);
+    QSGTexture *scheduledTextureForFactory(QQuickTextureFactory *factory, QQuickItem *item);
 
     virtual QSGTexture *createTexture(const QImage &image, uint flags = CreateTexture_Alpha) const;
 
@@ -138,6 +140,7 @@ public:
 
     bool hasBrokenIndexBufferObjects() const { return m_brokenIBOs; }
     int maxTextureSize() const { return m_maxTextureSize; }
+    QSGAtlasTexture::Manager *atlasManager() const { return m_atlasManager; }
 
 Q_SIGNALS:
     void initialized();
@@ -159,6 +162,10 @@ protected:
     QSGDistanceFieldGlyphCacheManager *m_distanceFieldCacheManager;
 
     QSet<QFontEngine *> m_fontEnginesToClean;
+    qint64 m_uploadBudget;
+    qint64 m_uploadedBytes;
+    qint64 m_deferredOnScreenBytes;
+    qint64 m_reservedUploadBytes;
     int m_maxTextureSize;
     bool m_brokenIBOs;
     bool m_serializedRender;
@@ -149,7 +149,7 @@ void QSGDefaultDistanceFieldGlyphCache::requestGlyphs(const QSet<glyph_t> &glyph
     markGlyphsToRender(glyphsToRender);
 }
 
-void QSGDefaultDistanceFieldGlyphCache::storeGlyphs(const QList<QDistanceField> &glyphs)
+void QSGDefaultDistanceFieldGlyphCache::storeGlyphs(const QHash<glyph_t, QDistanceField> &glyphs)
 {
     typedef QHash<TextureInfo *, QVector<glyph_t> > GlyphTextureHash;
     typedef GlyphTextureHash::const_iterator GlyphTextureHashConstIt;
@@ -162,9 +162,9 @@ void QSGDefaultDistanceFieldGlyphCache::storeGlyphs(const QList<QDistanceField>
     // Distance field data is always tightly packed
     m_funcs->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-    for (int i = 0; i < glyphs.size(); ++i) {
-        QDistanceField glyph = glyphs.at(i);
-        glyph_t glyphIndex = glyph.glyph();
+    for (QHash<glyph_t, QDistanceField>::const_iterator it = glyphs.constBegin(), cend = glyphs.constEnd(); it != cend; ++it) {
+        QDistanceField glyph = it.value();
+        glyph_t glyphIndex = it.key();
         TexCoord c = glyphTexCoord(glyphIndex);
         TextureInfo *texInfo = m_glyphsTexture.value(glyphIndex);
 
@@ -38,6 +38,7 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QTime>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QLibraryInfo>
 #include <QtCore/private/qabstractanimation_p.h>
 
@@ -102,6 +103,25 @@ void QSGRenderLoop::cleanup()
     s_instance = 0;
 }
 
+namespace {
+struct QSGFrameClock
+{
+    QSGFrameClock() { timer.start(); }
+    QElapsedTimer timer;
+};
+}
+Q_GLOBAL_STATIC(QSGFrameClock, qsg_frame_clock)
+
+/*!
+ * Returns the current time on the clock used for QSGFrameTimings, in
+ * nanoseconds. The clock is shared by all threads, and only differences
+ * between its values are meaningful.
+ */
+qint64 QSGRenderLoop::frameTimestamp()
+{
+    return qsg_frame_clock()->timer.nsecsElapsed();
+}
+
 /*!
  * Non-threaded render loops immediately run the job if there is a context.
  */
@@ -146,9 +166,12 @@ public:
 
     bool event(QEvent *);
 
+    QSGFrameTimings frameTimings(QQuickWindow *window) const { return m_windows.value(window).timings; }
+
     struct WindowData {
         bool updatePending : 1;
         bool grabOnly : 1;
+        QSGFrameTimings timings;
     };
 
     QHash<QQuickWindow *, WindowData> m_windows;
@@ -378,7 +401,10 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
         renderTimer.start();
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphPolishFrame);
 
+    QSGFrameTimings timings;
+    timings.polishStart = frameTimestamp();
     cd->polishItems();
+    timings.polishEnd = frameTimestamp();
 
     if (profileFrames)
         polishTime = renderTimer.nsecsElapsed();
@@ -388,14 +414,18 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
 
     emit window->afterAnimating();
 
+    timings.syncStart = frameTimestamp();
     cd->syncSceneGraph();
+    timings.syncEnd = frameTimestamp();
 
     if (profileFrames)
         syncTime = renderTimer.nsecsElapsed();
     Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphRenderLoopFrame,
                               QQuickProfiler::SceneGraphRenderLoopSync);
 
+    timings.renderStart = frameTimestamp();
     cd->renderSceneGraph(window->size());
+    timings.renderEnd = frameTimestamp();
 
     if (profileFrames)
         renderTime = renderTimer.nsecsElapsed();
@@ -409,9 +439,18 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
     }
 
     if (alsoSwap && window->isVisible()) {
-        if (!cd->customRenderStage || !cd->customRenderStage->swap())
-            gl->swapBuffers(window);
+        // Nothing to present when the frame is identical to the previous one
+        if (cd->customRenderStage || !cd->renderer || !cd->renderer->damageRect().isEmpty()) {
+            if (!cd->customRenderStage || !cd->customRenderStage->swap())
+                gl->swapBuffers(window);
+        }
+        timings.swapEnd = frameTimestamp();
+        data.timings = timings;
         cd->fireFrameSwapped();
+    } else if (cd->renderer) {
+        // What was rendered did not reach the screen, so the next frame cannot
+        // rely on it.
+        cd->renderer->requestFullRepaint();
     }
 
     qint64 swapTime = 0;
@@ -442,6 +481,9 @@ void QSGGuiThreadRenderLoop::exposureChanged(QQuickWindow *window)
 {
     if (window->isExposed()) {
         m_windows[window].updatePending = true;
+        QQuickWindowPrivate *cd = QQuickWindowPrivate::get(window);
+        if (cd->renderer)
+            cd->renderer->requestFullRepaint();
         renderWindow(window);
     }
 }
@@ -453,6 +495,10 @@ QImage QSGGuiThreadRenderLoop::grab(QQuickWindow *window)
 
     m_windows[window].grabOnly = true;
 
+    QQuickWindowPrivate *cd = QQuickWindowPrivate::get(window);
+    if (cd->renderer)
+        cd->renderer->requestFullRepaint();
+
     renderWindow(window);
 
     QImage grabbed = grabContent;
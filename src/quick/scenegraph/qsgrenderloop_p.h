@@ -47,6 +47,7 @@
 
 #include <QtGui/QImage>
 #include <QtGui/QSurface>
+#include <QtGui/QSurfaceFormat>
 #include <private/qtquickglobal_p.h>
 #include <QtCore/QSet>
 
@@ -58,6 +59,33 @@ class QSGRenderContext;
 class QAnimationDriver;
 class QRunnable;
 
+// Start and end of the phases of the last presented frame of a window, in
+// nanoseconds on the QSGRenderLoop::frameTimestamp() clock. Phases a render
+// loop does not have, or did not run for the frame, are 0.
+struct QSGFrameTimings
+{
+    QSGFrameTimings()
+        : animationStart(0), animationEnd(0)
+        , polishStart(0), polishEnd(0)
+        , syncStart(0), syncEnd(0)
+        , renderStart(0), renderEnd(0)
+        , swapEnd(0)
+    {
+    }
+
+    bool isValid() const { return swapEnd != 0; }
+
+    qint64 animationStart;
+    qint64 animationEnd;
+    qint64 polishStart;
+    qint64 polishEnd;
+    qint64 syncStart;
+    qint64 syncEnd;
+    qint64 renderStart;
+    qint64 renderEnd;
+    qint64 swapEnd;
+};
+
 class Q_QUICK_PRIVATE_EXPORT QSGRenderLoop : public QObject
 {
     Q_OBJECT
@@ -91,6 +119,8 @@ public:
     QSet<QQuickWindow *> windows() const { return m_windows; }
 
     virtual QSurface::SurfaceType windowSurfaceType() const;
+    // The format a new window requests, based on the scene graph's default
+    virtual QSurfaceFormat windowFormat(QQuickWindow *, const QSurfaceFormat &format) const { return format; }
 
     // ### make this less of a singleton
     static QSGRenderLoop *instance();
@@ -98,6 +128,14 @@ public:
 
     virtual bool interleaveIncubation() const { return false; }
 
+    // True when all windows use the same render context. The render loop then
+    // emits QQuickWindow::sceneGraphInitialized() and sceneGraphInvalidated()
+    // for each window itself.
+    virtual bool sharesRenderContext() const { return false; }
+
+    virtual QSGFrameTimings frameTimings(QQuickWindow *) const { return QSGFrameTimings(); }
+    static qint64 frameTimestamp();
+
     static void cleanup();
 
 Q_SIGNALS:
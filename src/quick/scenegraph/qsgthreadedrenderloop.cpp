@@ -37,6 +37,7 @@
 #include <QtCore/QWaitCondition>
 #include <QtCore/QAnimationDriver>
 #include <QtCore/QQueue>
+#include <QtCore/QSet>
 #include <QtCore/QTime>
 
 #include <QtGui/QGuiApplication>
@@ -54,6 +55,7 @@
 #include <private/qquickanimatorcontroller_p.h>
 
 #include <private/qquickprofiler_p.h>
+#include <private/qqmlglobal_p.h>
 #include <private/qqmldebugserviceinterfaces_p.h>
 #include <private/qqmldebugconnector_p.h>
 
@@ -118,6 +120,16 @@ static inline int qsgrl_animation_interval() {
 }
 
 
+// When set, the render thread picks up the GUI thread's sync request for the
+// next frame as soon as the current frame is rendered, before it is swapped,
+// so the GUI thread does not wait for the swap to start its next frame.
+DEFINE_BOOL_CONFIG_OPTION(qsgPipelinedSync, QSG_PIPELINED_SYNC)
+
+// When set, all windows are rendered by one render thread with one OpenGL
+// context and one render context, so that textures, atlases and glyph caches
+// are shared instead of duplicated per window.
+DEFINE_BOOL_CONFIG_OPTION(qsgSharedRenderThread, QSG_SHARED_RENDER_THREAD)
+
 static QElapsedTimer threadTimer;
 static qint64 syncTime;
 static qint64 renderTime;
@@ -185,15 +197,17 @@ public:
 class WMSyncEvent : public WMWindowEvent
 {
 public:
-    WMSyncEvent(QQuickWindow *c, bool inExpose, bool force)
+    WMSyncEvent(QQuickWindow *c, bool inExpose, bool force, const QSGFrameTimings &guiTimings)
         : WMWindowEvent(c, WM_RequestSync)
         , size(c->size())
         , syncInExpose(inExpose)
         , forceRenderPass(force)
+        , timings(guiTimings)
     {}
     QSize size;
     bool syncInExpose;
     bool forceRenderPass;
+    QSGFrameTimings timings;
 };
 
 
@@ -248,6 +262,20 @@ public:
         return has;
     }
 
+    // Takes the first event if it is a sync request for window that is not
+    // part of an expose.
+    QEvent *takeSyncEvent(QQuickWindow *window) {
+        QEvent *e = 0;
+        mutex.lock();
+        if (!isEmpty() && head()->type() == WM_RequestSync) {
+            WMSyncEvent *se = static_cast<WMSyncEvent *>(head());
+            if (se->window == window && !se->syncInExpose)
+                e = dequeue();
+        }
+        mutex.unlock();
+        return e;
+    }
+
 private:
     QMutex mutex;
     QWaitCondition condition;
@@ -264,11 +292,10 @@ public:
         , gl(0)
         , sgrc(renderContext)
         , animatorDriver(0)
-        , pendingUpdate(0)
         , sleeping(false)
-        , syncResultedInChanges(false)
+        , animatorsAdvanced(false)
         , active(false)
-        , window(0)
+        , windowCount(0)
         , stopEventProcessing(false)
     {
 #if defined(Q_OS_QNX) && !defined(Q_OS_BLACKBERRY) && defined(Q_PROCESSOR_X86)
@@ -283,21 +310,52 @@ public:
         delete sgrc;
     }
 
+    // An exposed window rendered by this thread
+    struct RenderWindow {
+        RenderWindow()
+            : window(0)
+            , pendingUpdate(0)
+            , syncResultedInChanges(false)
+            , syncedAhead(false)
+            , waitsForVsync(true)
+        {}
+        QQuickWindow *window;
+        QSize size;
+        uint pendingUpdate;
+        bool syncResultedInChanges;
+        bool syncedAhead; // the next frame was synced while presenting the current one
+        bool waitsForVsync; // swapping blocks until the vertical blank
+
+        // Timings of the next frame to render and of the frame being rendered
+        QSGFrameTimings syncedFrameTimings;
+        QSGFrameTimings renderFrameTimings;
+    };
+
     void invalidateOpenGL(QQuickWindow *window, bool inDestructor, QOffscreenSurface *backupSurface);
+    void releaseWindow(QQuickWindow *window, bool inDestructor, QOffscreenSurface *backupSurface);
     void initializeOpenGL();
 
+    void sceneGraphInitialized(QQuickWindow *window);
+    void sceneGraphInvalidated(QQuickWindow *window);
+    void allSceneGraphsInvalidated();
+
     bool event(QEvent *);
     void run();
 
-    void syncAndRender();
-    void sync(bool inExpose);
+    bool syncAndRender(RenderWindow *rw);
+    void sync(RenderWindow *rw, bool inExpose);
+    void syncAhead(RenderWindow *rw);
+
+    RenderWindow *renderWindow(QQuickWindow *window);
+    bool hasPendingUpdates() const;
 
-    void requestRepaint()
+    void requestRepaint(QQuickWindow *window)
     {
         if (sleeping)
             stopEventProcessing = true;
-        if (window)
-            pendingUpdate |= RepaintRequest;
+        RenderWindow *rw = renderWindow(window);
+        if (rw)
+            rw->pendingUpdate |= RepaintRequest;
     }
 
     void processEventsAndWaitForMore();
@@ -307,7 +365,11 @@ public:
 public slots:
     void sceneGraphChanged() {
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "sceneGraphChanged";
-        syncResultedInChanges = true;
+        for (int i = 0; i < windows.size(); ++i) {
+            RenderWindow &rw = windows[i];
+            if (QQuickWindowPrivate::get(rw.window)->renderer == sender())
+                rw.syncResultedInChanges = true;
+        }
     }
 
 public:
@@ -323,9 +385,8 @@ public:
 
     QAnimationDriver *animatorDriver;
 
-    uint pendingUpdate;
     bool sleeping;
-    bool syncResultedInChanges;
+    bool animatorsAdvanced;
 
     volatile bool active;
 
@@ -336,14 +397,41 @@ public:
 
     QElapsedTimer m_timer;
 
-    QQuickWindow *window; // Will be 0 when window is not exposed
-    QSize windowSize;
+    // Exposed windows, only accessed on the render thread
+    QList<RenderWindow> windows;
+
+    // Number of QQuickWindows using this thread and its render context,
+    // exposed or not. Changed by the GUI thread with the mutex held.
+    int windowCount;
+
+    // Windows that were told their scene graph is initialized, when the
+    // render context is shared and the signals are emitted per window.
+    QSet<QQuickWindow *> initializedWindows;
+
+    // Timings of the last presented frame, read by the GUI thread.
+    QHash<QQuickWindow *, QSGFrameTimings> lastFrameTimings;
+    QMutex timingsMutex;
 
     // Local event queue stuff...
     bool stopEventProcessing;
     QSGRenderThreadEventQueue eventQueue;
 };
 
+QSGRenderThread::RenderWindow *QSGRenderThread::renderWindow(QQuickWindow *window)
+{
+    return windowFor(windows, window);
+}
+
+bool QSGRenderThread::hasPendingUpdates() const
+{
+    for (int i = 0; i < windows.size(); ++i) {
+        const RenderWindow &rw = windows.at(i);
+        if (rw.pendingUpdate || rw.syncedAhead)
+            return true;
+    }
+    return false;
+}
+
 bool QSGRenderThread::event(QEvent *e)
 {
     switch ((int) e->type()) {
@@ -351,13 +439,16 @@ bool QSGRenderThread::event(QEvent *e)
     case WM_Obscure: {
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "WM_Obscure";
 
-        Q_ASSERT(!window || window == static_cast<WMWindowEvent *>(e)->window);
+        QQuickWindow *window = static_cast<WMWindowEvent *>(e)->window;
 
         mutex.lock();
-        if (window) {
-            QQuickWindowPrivate::get(window)->fireAboutToStop();
-            qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- window removed";
-            window = 0;
+        for (int i = 0; i < windows.size(); ++i) {
+            if (windows.at(i).window == window) {
+                QQuickWindowPrivate::get(window)->fireAboutToStop();
+                qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- window removed";
+                windows.removeAt(i);
+                break;
+            }
         }
         waitCondition.wakeOne();
         mutex.unlock();
@@ -369,17 +460,25 @@ bool QSGRenderThread::event(QEvent *e)
         WMSyncEvent *se = static_cast<WMSyncEvent *>(e);
         if (sleeping)
             stopEventProcessing = true;
-        window = se->window;
-        windowSize = se->size;
+        RenderWindow *rw = renderWindow(se->window);
+        if (!rw) {
+            RenderWindow newWindow;
+            newWindow.window = se->window;
+            newWindow.waitsForVsync = se->window->format().swapInterval() != 0;
+            windows << newWindow;
+            rw = &windows.last();
+        }
+        rw->size = se->size;
+        rw->syncedFrameTimings = se->timings;
 
-        pendingUpdate |= SyncRequest;
+        rw->pendingUpdate |= SyncRequest;
         if (se->syncInExpose) {
             qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- triggered from expose";
-            pendingUpdate |= ExposeRequest;
+            rw->pendingUpdate |= ExposeRequest;
         }
         if (se->forceRenderPass) {
             qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- repaint regardless";
-            pendingUpdate |= RepaintRequest;
+            rw->pendingUpdate |= RepaintRequest;
         }
         return true; }
 
@@ -388,13 +487,26 @@ bool QSGRenderThread::event(QEvent *e)
         mutex.lock();
         wm->m_lockedForSync = true;
         WMTryReleaseEvent *wme = static_cast<WMTryReleaseEvent *>(e);
-        if (!window || wme->inDestructor) {
-            qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- setting exit flag and invalidating OpenGL";
-            invalidateOpenGL(wme->window, wme->inDestructor, wme->fallbackSurface);
-            active = gl;
-            Q_ASSERT_X(!wme->inDestructor || !active, "QSGRenderThread::invalidateOpenGL()", "Thread's active state is not set to false when shutting down");
-            if (sleeping)
-                stopEventProcessing = true;
+        if (!renderWindow(wme->window) || wme->inDestructor) {
+            if (windowCount > 1) {
+                // The render context and OpenGL context are shared with
+                // other windows, so only this window's scene graph goes.
+                qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- shared with other windows, releasing window only";
+                releaseWindow(wme->window, wme->inDestructor, wme->fallbackSurface);
+            } else {
+                qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- setting exit flag and invalidating OpenGL";
+                invalidateOpenGL(wme->window, wme->inDestructor, wme->fallbackSurface);
+                active = gl;
+                Q_ASSERT_X(!wme->inDestructor || !active, "QSGRenderThread::invalidateOpenGL()", "Thread's active state is not set to false when shutting down");
+                if (sleeping)
+                    stopEventProcessing = true;
+            }
+            if (wme->inDestructor) {
+                initializedWindows.remove(wme->window);
+                timingsMutex.lock();
+                lastFrameTimings.remove(wme->window);
+                timingsMutex.unlock();
+            }
         } else {
             qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- not releasing because window is still active";
         }
@@ -408,9 +520,10 @@ bool QSGRenderThread::event(QEvent *e)
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "WM_Grab";
         WMGrabEvent *ce = static_cast<WMGrabEvent *>(e);
         Q_ASSERT(ce->window);
-        Q_ASSERT(ce->window == window || !window);
         mutex.lock();
         if (ce->window) {
+            RenderWindow *rw = renderWindow(ce->window);
+            const QSize size = rw ? rw->size : ce->window->size();
             gl->makeCurrent(ce->window);
 
             qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- sync scene graph";
@@ -418,11 +531,16 @@ bool QSGRenderThread::event(QEvent *e)
             d->syncSceneGraph();
 
             qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- rendering scene graph";
-            QQuickWindowPrivate::get(ce->window)->renderSceneGraph(ce->window->size());
+            // The grab reads back the whole frame, and the frame is never presented.
+            if (d->renderer)
+                d->renderer->requestFullRepaint();
+            d->renderSceneGraph(ce->window->size());
+            if (d->renderer)
+                d->renderer->requestFullRepaint();
 
             qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- grabbing result";
             bool alpha = ce->window->format().alphaBufferSize() > 0 && ce->window->color().alpha() != 255;
-            *ce->image = qt_gl_read_framebuffer(windowSize * ce->window->effectiveDevicePixelRatio(), alpha, alpha);
+            *ce->image = qt_gl_read_framebuffer(size * ce->window->effectiveDevicePixelRatio(), alpha, alpha);
         }
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- waking gui to handle result";
         waitCondition.wakeOne();
@@ -433,9 +551,8 @@ bool QSGRenderThread::event(QEvent *e)
     case WM_PostJob: {
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "WM_PostJob";
         WMJobEvent *ce = static_cast<WMJobEvent *>(e);
-        Q_ASSERT(ce->window == window);
-        if (window) {
-            gl->makeCurrent(window);
+        if (renderWindow(ce->window)) {
+            gl->makeCurrent(ce->window);
             ce->job->run();
             delete ce->job;
             ce->job = 0;
@@ -444,12 +561,15 @@ bool QSGRenderThread::event(QEvent *e)
         return true;
     }
 
-    case WM_RequestRepaint:
+    case WM_RequestRepaint: {
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "WM_RequestPaint";
         // When GUI posts this event, it is followed by a polishAndSync, so we mustn't
         // exit the event loop yet.
-        pendingUpdate |= RepaintRequest;
+        RenderWindow *rw = renderWindow(static_cast<WMWindowEvent *>(e)->window);
+        if (rw)
+            rw->pendingUpdate |= RepaintRequest;
         break;
+    }
 
     default:
         break;
@@ -493,6 +613,7 @@ void QSGRenderThread::invalidateOpenGL(QQuickWindow *window, bool inDestructor,
     }
 
     sgrc->invalidate();
+    allSceneGraphsInvalidated();
     QCoreApplication::processEvents();
     QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
     if (inDestructor)
@@ -510,29 +631,96 @@ void QSGRenderThread::invalidateOpenGL(QQuickWindow *window, bool inDestructor,
     }
 }
 
+/*
+ * Releases the scene graph of one window while other windows keep using
+ * the render context and the OpenGL context, which therefore stay valid.
+ */
+void QSGRenderThread::releaseWindow(QQuickWindow *window, bool inDestructor, QOffscreenSurface *fallback)
+{
+    qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "releaseWindow()";
+
+    if (!gl || !window)
+        return;
+
+    if (!inDestructor && window->isPersistentSceneGraph()) {
+        qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- persistent SG, avoiding cleanup";
+        return;
+    }
+
+    bool current = gl->makeCurrent(fallback ? static_cast<QSurface *>(fallback) : static_cast<QSurface *>(window));
+    if (Q_UNLIKELY(!current)) {
+        qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- cleanup without an OpenGL context";
+    }
+
+    QQuickWindowPrivate *dd = QQuickWindowPrivate::get(window);
+    dd->cleanupNodesOnShutdown();
+    sceneGraphInvalidated(window);
+    QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+    if (inDestructor)
+        delete dd->animationController;
+    if (current)
+        gl->doneCurrent();
+}
+
+/*
+ * When windows share the render context, its initialized() and invalidated()
+ * signals do not say anything about a particular window, so the render thread
+ * emits QQuickWindow::sceneGraphInitialized() before the first sync of each
+ * window and sceneGraphInvalidated() when the window's scene graph is released.
+ * Otherwise the window is connected to the render context signals directly.
+ */
+void QSGRenderThread::sceneGraphInitialized(QQuickWindow *window)
+{
+    if (!qsgSharedRenderThread() || !sgrc->isValid() || initializedWindows.contains(window))
+        return;
+    initializedWindows.insert(window);
+    emit window->sceneGraphInitialized();
+}
+
+void QSGRenderThread::sceneGraphInvalidated(QQuickWindow *window)
+{
+    if (initializedWindows.remove(window))
+        emit window->sceneGraphInvalidated();
+}
+
+void QSGRenderThread::allSceneGraphsInvalidated()
+{
+    const QSet<QQuickWindow *> invalidated = initializedWindows;
+    initializedWindows.clear();
+    foreach (QQuickWindow *window, invalidated)
+        emit window->sceneGraphInvalidated();
+}
+
 /*!
     Enters the mutex lock to make sure GUI is blocking and performs
     sync, then wakes GUI.
  */
-void QSGRenderThread::sync(bool inExpose)
+void QSGRenderThread::sync(RenderWindow *rw, bool inExpose)
 {
     qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "sync()";
     mutex.lock();
+    rw->syncedFrameTimings.syncStart = QSGRenderLoop::frameTimestamp();
 
     Q_ASSERT_X(wm->m_lockedForSync, "QSGRenderThread::sync()", "sync triggered on bad terms as gui is not already locked...");
 
+    QQuickWindow *window = rw->window;
     bool current = false;
-    if (windowSize.width() > 0 && windowSize.height() > 0)
+    if (rw->size.width() > 0 && rw->size.height() > 0)
         current = gl->makeCurrent(window);
     // Check for context loss.
     if (!current && !gl->isValid()) {
-        QQuickWindowPrivate::get(window)->cleanupNodesOnShutdown();
+        // The context may be shared by several windows, all of which have
+        // nodes referring to its resources.
+        for (int i = 0; i < windows.size(); ++i)
+            QQuickWindowPrivate::get(windows.at(i).window)->cleanupNodesOnShutdown();
         sgrc->invalidate();
+        allSceneGraphsInvalidated();
         current = gl->create() && gl->makeCurrent(window);
         if (current)
             sgrc->initialize(gl);
     }
     if (current) {
+        sceneGraphInitialized(window);
         QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
         bool hadRenderer = d->renderer != 0;
         // If the scene graph was touched since the last sync() make sure it sends the
@@ -542,7 +730,7 @@ void QSGRenderThread::sync(bool inExpose)
         d->syncSceneGraph();
         if (!hadRenderer && d->renderer) {
             qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- renderer was created";
-            syncResultedInChanges = true;
+            rw->syncResultedInChanges = true;
             connect(d->renderer, SIGNAL(sceneGraphChanged()), this, SLOT(sceneGraphChanged()), Qt::DirectConnection);
         }
 
@@ -553,6 +741,7 @@ void QSGRenderThread::sync(bool inExpose)
     } else {
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- window has bad size, sync aborted";
     }
+    rw->syncedFrameTimings.syncEnd = QSGRenderLoop::frameTimestamp();
 
     if (!inExpose) {
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- sync complete, waking Gui";
@@ -561,7 +750,11 @@ void QSGRenderThread::sync(bool inExpose)
     }
 }
 
-void QSGRenderThread::syncAndRender()
+/*
+ * Syncs and renders one window. Returns true if the frame was swapped, as
+ * the swap is what normally throttles the render thread to the display.
+ */
+bool QSGRenderThread::syncAndRender(RenderWindow *rw)
 {
     bool profileFrames = QSG_LOG_TIME_RENDERLOOP().isDebugEnabled();
     if (profileFrames) {
@@ -570,23 +763,33 @@ void QSGRenderThread::syncAndRender()
     }
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphRenderLoopFrame);
 
-    QElapsedTimer waitTimer;
-    waitTimer.start();
+    qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "syncAndRender()" << rw->window;
 
-    qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "syncAndRender()";
-
-    syncResultedInChanges = false;
+    QQuickWindow *window = rw->window;
     QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
 
-    bool repaintRequested = (pendingUpdate & RepaintRequest) || d->customRenderStage;
-    bool syncRequested = pendingUpdate & SyncRequest;
-    bool exposeRequested = (pendingUpdate & ExposeRequest) == ExposeRequest;
-    pendingUpdate = 0;
+    bool repaintRequested = d->customRenderStage;
+    bool syncRequested = false;
+    bool exposeRequested = false;
+    if (rw->syncedAhead) {
+        // This frame was already synced by syncAhead(). Requests that arrived
+        // since then are for the frame after it, so leave them pending.
+        qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- synced ahead";
+        rw->syncedAhead = false;
+    } else {
+        rw->syncResultedInChanges = false;
+        repaintRequested |= bool(rw->pendingUpdate & RepaintRequest);
+        syncRequested = rw->pendingUpdate & SyncRequest;
+        exposeRequested = (rw->pendingUpdate & ExposeRequest) == ExposeRequest;
+        rw->pendingUpdate = 0;
+    }
 
     if (syncRequested) {
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- updatePending, doing sync";
-        sync(exposeRequested);
+        sync(rw, exposeRequested);
     }
+    if (exposeRequested && d->renderer)
+        d->renderer->requestFullRepaint();
 #ifndef QSG_NO_RENDER_TIMING
     if (profileFrames)
         syncTime = threadTimer.nsecsElapsed();
@@ -594,25 +797,31 @@ void QSGRenderThread::syncAndRender()
     Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphRenderLoopFrame,
                               QQuickProfiler::SceneGraphRenderLoopSync);
 
-    if (!syncResultedInChanges && !repaintRequested && sgrc->isValid()) {
+    rw->renderFrameTimings = rw->syncedFrameTimings;
+    rw->syncedFrameTimings = QSGFrameTimings();
+
+    if (!rw->syncResultedInChanges && !repaintRequested && sgrc->isValid()) {
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- no changes, render aborted";
-        int waitTime = vsyncDelta - (int) waitTimer.elapsed();
-        if (waitTime > 0)
-            msleep(waitTime);
-        return;
+        return false;
     }
 
     qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- rendering started";
 
 
-    if (animatorDriver->isRunning()) {
-        d->animationController->lock();
+    // The driver ticks the animators of all windows on this thread, so it
+    // advances once per pass over the windows.
+    if (animatorDriver->isRunning() && !animatorsAdvanced) {
+        for (int i = 0; i < windows.size(); ++i)
+            QQuickWindowPrivate::get(windows.at(i).window)->animationController->lock();
         animatorDriver->advance();
-        d->animationController->unlock();
+        for (int i = 0; i < windows.size(); ++i)
+            QQuickWindowPrivate::get(windows.at(i).window)->animationController->unlock();
+        animatorsAdvanced = true;
     }
 
+    bool swapped = false;
     bool current = false;
-    if (d->renderer && windowSize.width() > 0 && windowSize.height() > 0)
+    if (d->renderer && rw->size.width() > 0 && rw->size.height() > 0)
         current = gl->makeCurrent(window);
     // Check for context loss.
     if (!current && !gl->isValid()) {
@@ -621,13 +830,32 @@ void QSGRenderThread::syncAndRender()
         QCoreApplication::postEvent(window, new QEvent(QEvent::Type(QQuickWindowPrivate::FullUpdateRequest)));
     }
     if (current) {
-        d->renderSceneGraph(windowSize);
+        rw->renderFrameTimings.renderStart = QSGRenderLoop::frameTimestamp();
+        d->renderSceneGraph(rw->size);
+        rw->renderFrameTimings.renderEnd = QSGRenderLoop::frameTimestamp();
         if (profileFrames)
             renderTime = threadTimer.nsecsElapsed();
         Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphRenderLoopFrame,
                                   QQuickProfiler::SceneGraphRenderLoopRender);
-        if (!d->customRenderStage || !d->customRenderStage->swap())
-            gl->swapBuffers(window);
+
+        // The frame is recorded, so the scene graph may change for the next one
+        // while this one is presented. Not during an expose, where the mutex is
+        // held until the frame is done.
+        if (qsgPipelinedSync() && !exposeRequested)
+            syncAhead(rw);
+        if (!d->customRenderStage && d->renderer->damageRect().isEmpty()) {
+            // The frame is identical to the one on screen, so there is nothing
+            // to present.
+            qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- no damage, swap skipped";
+        } else {
+            if (!d->customRenderStage || !d->customRenderStage->swap())
+                gl->swapBuffers(window);
+            swapped = true;
+        }
+        rw->renderFrameTimings.swapEnd = QSGRenderLoop::frameTimestamp();
+        timingsMutex.lock();
+        lastFrameTimings.insert(window, rw->renderFrameTimings);
+        timingsMutex.unlock();
         d->fireFrameSwapped();
     } else {
         Q_QUICK_SG_PROFILE_SKIP(QQuickProfiler::SceneGraphRenderLoopFrame,
@@ -658,10 +886,41 @@ void QSGRenderThread::syncAndRender()
 
     Q_QUICK_SG_PROFILE_END(QQuickProfiler::SceneGraphRenderLoopFrame,
                            QQuickProfiler::SceneGraphRenderLoopSwap);
+
+    return swapped;
 }
 
 
 
+/*
+ * Runs the sync for the next frame if the GUI thread is already waiting
+ * for it. The GUI thread is then released before the current frame is
+ * swapped, and the next syncAndRender() renders without syncing.
+ *
+ * The request is either still in the event queue, or was already picked up
+ * by processEvents() after the previous swap, when the GUI thread posted
+ * it while that frame was presented.
+ */
+void QSGRenderThread::syncAhead(RenderWindow *rw)
+{
+    if (!(rw->pendingUpdate & SyncRequest)) {
+        QEvent *e = eventQueue.takeSyncEvent(rw->window);
+        if (!e)
+            return;
+        event(e);
+        delete e;
+    } else if ((rw->pendingUpdate & ExposeRequest) == ExposeRequest) {
+        // An expose syncs with the mutex held until its frame is rendered.
+        return;
+    }
+    qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "syncAhead()";
+
+    rw->pendingUpdate &= ~SyncRequest;
+    rw->syncResultedInChanges = false;
+    sync(rw, false);
+    rw->syncedAhead = true;
+}
+
 void QSGRenderThread::postEvent(QEvent *e)
 {
     eventQueue.addEvent(e);
@@ -702,16 +961,38 @@ void QSGRenderThread::run()
 
     while (active) {
 
-        if (window) {
-            if (!sgrc->openglContext() && windowSize.width() > 0 && windowSize.height() > 0 && gl->makeCurrent(window))
+        // Render every window that has something pending. Windows whose
+        // scene did not change cost nothing beyond the check.
+        QElapsedTimer passTimer;
+        passTimer.start();
+        bool rendered = false;
+        bool throttled = false;
+        animatorsAdvanced = false;
+        for (int i = 0; i < windows.size(); ++i) {
+            RenderWindow *rw = &windows[i];
+            if (!rw->pendingUpdate && !rw->syncedAhead)
+                continue;
+            if (!sgrc->openglContext() && rw->size.width() > 0 && rw->size.height() > 0 && gl->makeCurrent(rw->window))
                 sgrc->initialize(gl);
-            syncAndRender();
+            if (syncAndRender(rw) && rw->waitsForVsync)
+                throttled = true;
+            rendered = true;
+        }
+
+        // Without a swap that waited for the vertical blank to throttle us,
+        // wait out the rest of the frame instead. With the shared thread only
+        // one window waits for it, see windowFormat(), so that a pass over N
+        // windows takes one frame and not N.
+        if (rendered && !throttled) {
+            int waitTime = vsyncDelta - (int) passTimer.elapsed();
+            if (waitTime > 0)
+                msleep(waitTime);
         }
 
         processEvents();
         QCoreApplication::processEvents();
 
-        if (active && (pendingUpdate == 0 || !window)) {
+        if (active && !hasPendingUpdates()) {
             qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "done drawing, sleep...";
             sleeping = true;
             processEventsAndWaitForMore();
@@ -732,6 +1013,8 @@ void QSGRenderThread::run()
 
 QSGThreadedRenderLoop::QSGThreadedRenderLoop()
     : sg(QSGContext::createDefaultContext())
+    , m_sharedRenderContext(0)
+    , m_sharedThread(0)
     , m_animation_timer(0)
 {
 #if defined(QSG_RENDER_LOOP_DEBUG)
@@ -748,11 +1031,23 @@ QSGThreadedRenderLoop::QSGThreadedRenderLoop()
 
 QSGThreadedRenderLoop::~QSGThreadedRenderLoop()
 {
+    // The shared thread owns the shared render context once it exists
+    if (m_sharedThread) {
+        if (!m_sharedThread->isRunning())
+            delete m_sharedThread;
+    } else {
+        delete m_sharedRenderContext;
+    }
     delete sg;
 }
 
 QSGRenderContext *QSGThreadedRenderLoop::createRenderContext(QSGContext *sg) const
 {
+    if (qsgSharedRenderThread()) {
+        if (!m_sharedRenderContext)
+            m_sharedRenderContext = sg->createRenderContext();
+        return m_sharedRenderContext;
+    }
     return sg->createRenderContext();
 }
 
@@ -781,11 +1076,46 @@ bool QSGThreadedRenderLoop::anyoneShowing() const
     return false;
 }
 
+QSGFrameTimings QSGThreadedRenderLoop::frameTimings(QQuickWindow *window) const
+{
+    Window *w = windowFor(m_windows, window);
+    if (!w || !w->thread)
+        return QSGFrameTimings();
+    QMutexLocker locker(&w->thread->timingsMutex);
+    return w->thread->lastFrameTimings.value(window);
+}
+
 bool QSGThreadedRenderLoop::interleaveIncubation() const
 {
     return m_animation_driver->isRunning() && anyoneShowing();
 }
 
+bool QSGThreadedRenderLoop::sharesRenderContext() const
+{
+    return qsgSharedRenderThread();
+}
+
+/*!
+    With the shared render thread, windows are swapped one after the other
+    on the same thread, and a swap that waits for the vertical blank holds up
+    all the windows after it. Only one window waits for it then, and the
+    others use a swap interval of 0. The render thread is throttled by that
+    window's swap, or by a timer when it is not rendered in a pass.
+ */
+QSurfaceFormat QSGThreadedRenderLoop::windowFormat(QQuickWindow *window, const QSurfaceFormat &format) const
+{
+    if (!qsgSharedRenderThread() || format.swapInterval() == 0)
+        return format;
+    foreach (QQuickWindow *other, windows()) {
+        if (other != window && other->requestedFormat().swapInterval() != 0) {
+            QSurfaceFormat fmt = format;
+            fmt.setSwapInterval(0);
+            return fmt;
+        }
+    }
+    return format;
+}
+
 void QSGThreadedRenderLoop::animationStarted()
 {
     qCDebug(QSG_LOG_RENDERLOOP) << "- animationStarted()";
@@ -865,10 +1195,20 @@ void QSGThreadedRenderLoop::windowDestroyed(QQuickWindow *window)
     releaseResources(w, true);
 
     QSGRenderThread *thread = w->thread;
-    while (thread->isRunning())
-        QThread::yieldCurrentThread();
-    Q_ASSERT(thread->thread() == QThread::currentThread());
-    delete thread;
+    thread->mutex.lock();
+    const bool lastWindow = --thread->windowCount == 0;
+    thread->mutex.unlock();
+
+    // A thread shared with other windows keeps running for them
+    if (lastWindow) {
+        while (thread->isRunning())
+            QThread::yieldCurrentThread();
+        Q_ASSERT(thread->thread() == QThread::currentThread());
+        // The shared thread is kept, its render context is already handed
+        // out to windows that are not exposed yet.
+        if (thread != m_sharedThread)
+            delete thread;
+    }
 
     for (int i=0; i<m_windows.size(); ++i) {
         if (m_windows.at(i).window == window) {
@@ -907,16 +1247,32 @@ void QSGThreadedRenderLoop::handleExposure(QQuickWindow *window)
         Window win;
         win.window = window;
         win.actualWindowFormat = window->format();
-        win.thread = new QSGRenderThread(this, QQuickWindowPrivate::get(window)->context);
+        if (qsgSharedRenderThread()) {
+            if (!m_sharedThread)
+                m_sharedThread = new QSGRenderThread(this, QQuickWindowPrivate::get(window)->context);
+            Q_ASSERT(m_sharedThread->sgrc == QQuickWindowPrivate::get(window)->context);
+            win.thread = m_sharedThread;
+        } else {
+            win.thread = new QSGRenderThread(this, QQuickWindowPrivate::get(window)->context);
+        }
         win.updateDuringSync = false;
         win.forceRenderPass = true; // also covered by polishAndSync(inExpose=true), but doesn't hurt
+        win.exposed = false;
         m_windows << win;
         w = &m_windows.last();
+
+        w->thread->mutex.lock();
+        ++w->thread->windowCount;
+        w->thread->mutex.unlock();
+
+        // Joining a shared thread that already has its OpenGL context
+        if (w->thread->gl && w->thread->isRunning())
+            QQuickWindowPrivate::get(window)->fireOpenGLContextCreated(w->thread->gl);
     }
 
     // set this early as we'll be rendering shortly anyway and this avoids
     // specialcasing exposure in polishAndSync.
-    w->thread->window = window;
+    w->exposed = true;
 
     if (w->window->width() <= 0 || w->window->height() <= 0
         || (w->window->isTopLevel() && !w->window->geometry().intersects(w->window->screen()->availableGeometry()))) {
@@ -932,6 +1288,11 @@ void QSGThreadedRenderLoop::handleExposure(QQuickWindow *window)
     if (!w->window->handle())
         w->window->create();
 
+    // The animators of the window run on the render thread
+    QQuickAnimatorController *controller = QQuickWindowPrivate::get(w->window)->animationController;
+    if (controller->thread() != w->thread)
+        controller->moveToThread(w->thread);
+
     // Start render thread if it is not running
     if (!w->thread->isRunning()) {
 
@@ -957,10 +1318,6 @@ void QSGThreadedRenderLoop::handleExposure(QQuickWindow *window)
             qCDebug(QSG_LOG_RENDERLOOP) << "- OpenGL context created";
         }
 
-        QQuickAnimatorController *controller = QQuickWindowPrivate::get(w->window)->animationController;
-        if (controller->thread() != w->thread)
-            controller->moveToThread(w->thread);
-
         w->thread->active = true;
         if (w->thread->thread() == QThread::currentThread()) {
             w->thread->sgrc->moveToThread(w->thread);
@@ -996,6 +1353,7 @@ void QSGThreadedRenderLoop::handleObscurity(Window *w)
         w->thread->waitCondition.wait(&w->thread->mutex);
         w->thread->mutex.unlock();
     }
+    w->exposed = false;
     startOrStopAnimationTimer();
 }
 
@@ -1059,7 +1417,7 @@ void QSGThreadedRenderLoop::update(QQuickWindow *window)
 
     if (w->thread == QThread::currentThread()) {
         qCDebug(QSG_LOG_RENDERLOOP) << "update on window - on render thread" << w->window;
-        w->thread->requestRepaint();
+        w->thread->requestRepaint(window);
         return;
     }
 
@@ -1133,7 +1491,7 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
     qCDebug(QSG_LOG_RENDERLOOP) << "polishAndSync" << (inExpose ? "(in expose)" : "(normal)") << w->window;
 
     QQuickWindow *window = w->window;
-    if (!w->thread || !w->thread->window) {
+    if (!w->thread || !w->exposed) {
         qCDebug(QSG_LOG_RENDERLOOP) << "- not exposed, abort";
         return;
     }
@@ -1142,7 +1500,7 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
     QQuickWindowPrivate::get(window)->flushDelayedTouchEvent();
     // The delivery of the event might have caused the window to stop rendering
     w = windowFor(m_windows, window);
-    if (!w || !w->thread || !w->thread->window) {
+    if (!w || !w->thread || !w->exposed) {
         qCDebug(QSG_LOG_RENDERLOOP) << "- removed after event flushing, abort";
         return;
     }
@@ -1158,7 +1516,9 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphPolishAndSync);
 
     QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
+    w->timings.polishStart = QSGRenderLoop::frameTimestamp();
     d->polishItems();
+    w->timings.polishEnd = QSGRenderLoop::frameTimestamp();
 
     if (profileFrames)
         polishTime = timer.nsecsElapsed();
@@ -1172,8 +1532,9 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
     qCDebug(QSG_LOG_RENDERLOOP) << "- lock for sync";
     w->thread->mutex.lock();
     m_lockedForSync = true;
-    w->thread->postEvent(new WMSyncEvent(window, inExpose, w->forceRenderPass));
+    w->thread->postEvent(new WMSyncEvent(window, inExpose, w->forceRenderPass, w->timings));
     w->forceRenderPass = false;
+    w->timings = QSGFrameTimings();
 
     qCDebug(QSG_LOG_RENDERLOOP) << "- wait for sync";
     if (profileFrames)
@@ -1192,7 +1553,10 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
 
     if (m_animation_timer == 0 && m_animation_driver->isRunning()) {
         qCDebug(QSG_LOG_RENDERLOOP) << "- advancing animations";
+        // The animations advanced here are what the next frame shows.
+        w->timings.animationStart = QSGRenderLoop::frameTimestamp();
         m_animation_driver->advance();
+        w->timings.animationEnd = QSGRenderLoop::frameTimestamp();
         qCDebug(QSG_LOG_RENDERLOOP) << "- animations done..";
         // We need to trigger another sync to keep animations running...
         maybePostPolishRequest(w);
@@ -1284,7 +1648,7 @@ QImage QSGThreadedRenderLoop::grab(QQuickWindow *window)
 void QSGThreadedRenderLoop::postJob(QQuickWindow *window, QRunnable *job)
 {
     Window *w = windowFor(m_windows, window);
-    if (w && w->thread && w->thread->window)
+    if (w && w->thread && w->exposed)
         w->thread->postEvent(new WMJobEvent(window, job));
     else
         delete job;
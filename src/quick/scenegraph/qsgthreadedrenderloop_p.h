@@ -85,6 +85,9 @@ public:
     void postJob(QQuickWindow *window, QRunnable *job);
 
     bool interleaveIncubation() const;
+    bool sharesRenderContext() const;
+    QSurfaceFormat windowFormat(QQuickWindow *window, const QSurfaceFormat &format) const;
+    QSGFrameTimings frameTimings(QQuickWindow *window) const;
 
 public Q_SLOTS:
     void animationStarted();
@@ -97,6 +100,8 @@ private:
         QSurfaceFormat actualWindowFormat;
         uint updateDuringSync : 1;
         uint forceRenderPass : 1;
+        uint exposed : 1;
+        QSGFrameTimings timings; // GUI thread phases of the next frame
     };
 
     friend class QSGRenderThread;
@@ -118,6 +123,9 @@ private:
 
 
     QSGContext *sg;
+    // Only used with QSG_SHARED_RENDER_THREAD
+    mutable QSGRenderContext *m_sharedRenderContext;
+    QSGRenderThread *m_sharedThread;
     QAnimationDriver *m_animation_driver;
     QList<Window> m_windows;
 
@@ -275,6 +275,9 @@ void QSGWindowsRenderLoop::exposureChanged(QQuickWindow *window)
         RLDEBUG("exposureChanged - exposed");
         WindowData *wd = windowData(window);
         wd->pendingUpdate = true;
+        QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
+        if (d->renderer)
+            d->renderer->requestFullRepaint();
 
         // If we have a pending timer and we get an expose, we need to stop it.
         // Otherwise we get two frames and two animation ticks in the same time-interval.
@@ -310,7 +313,12 @@ QImage QSGWindowsRenderLoop::grab(QQuickWindow *window)
     QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
     d->polishItems();
     d->syncSceneGraph();
+    // The grab reads back the whole frame, and the frame is never presented.
+    if (d->renderer)
+        d->renderer->requestFullRepaint();
     d->renderSceneGraph(window->size());
+    if (d->renderer)
+        d->renderer->requestFullRepaint();
 
     bool alpha = window->format().alphaBufferSize() > 0 && window->color().alpha() != 255;
     QImage image = qt_gl_read_framebuffer(window->size() * window->effectiveDevicePixelRatio(), alpha, alpha);
@@ -433,6 +441,8 @@ void QSGWindowsRenderLoop::renderWindow(QQuickWindow *window)
     if (!windowData(window))
         return;
 
+    QElapsedTimer frameTimer;
+    frameTimer.start();
     QSG_LOG_TIME_SAMPLE(time_start);
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphPolishFrame);
 
@@ -455,9 +465,19 @@ void QSGWindowsRenderLoop::renderWindow(QQuickWindow *window)
     QSG_RENDER_TIMING_SAMPLE(QQuickProfiler::SceneGraphRenderLoopFrame, time_rendered,
                              QQuickProfiler::SceneGraphRenderLoopRender);
 
-    RLDEBUG(" - swapping");
-    if (!d->customRenderStage || !d->customRenderStage->swap())
-        m_gl->swapBuffers(window);
+    if (!d->customRenderStage && d->renderer && d->renderer->damageRect().isEmpty()) {
+        // Nothing changed on screen. Sleep for the rest of the interval the
+        // swap would have blocked for so animations keep ticking at the
+        // display rate.
+        RLDEBUG(" - no damage, sleep");
+        const qint64 remaining = m_vsyncDelta - frameTimer.elapsed();
+        if (remaining > 0)
+            QThread::msleep(remaining);
+    } else {
+        RLDEBUG(" - swapping");
+        if (!d->customRenderStage || !d->customRenderStage->swap())
+            m_gl->swapBuffers(window);
+    }
     QSG_RENDER_TIMING_SAMPLE(QQuickProfiler::SceneGraphRenderLoopFrame, time_swapped,
                              QQuickProfiler::SceneGraphRenderLoopSwap);
 
@@ -61,8 +61,27 @@ static QElapsedTimer qsg_renderer_timer;
 namespace QSGAtlasTexture
 {
 
+/*
+    Allocations are rounded up to a size class, so that the area freed by one
+    texture can be taken by another one of similar size instead of leaving
+    slivers behind. The rounding is finer for small images, where it would
+    otherwise waste a larger share of the area.
+ */
+static int qsg_allocationClass(int dimension)
+{
+    const int granularity = dimension <= 32 ? 4 : (dimension <= 128 ? 8 : 16);
+    return (dimension + granularity - 1) & ~(granularity - 1);
+}
+
+static QSize qsg_allocationSize(const QSize &size)
+{
+    return QSize(qsg_allocationClass(size.width()), qsg_allocationClass(size.height()));
+}
+
 Manager::Manager()
-    : m_atlas(0)
+    : m_too_large_fallbacks(0)
+    , m_atlas_full_fallbacks(0)
+    , m_released_pages(0)
 {
     QOpenGLContext *gl = QOpenGLContext::currentContext();
     Q_ASSERT(gl);
@@ -85,43 +104,131 @@ Manager::Manager()
 
     m_atlas_size_limit = qt_sg_envInt("QSG_ATLAS_SIZE_LIMIT", qMax(w, h) / 2);
     m_atlas_size = QSize(w, h);
+    m_max_pages = qMax(1, qt_sg_envInt("QSG_ATLAS_MAX_PAGES", 4));
+    m_log_stats = qEnvironmentVariableIsSet("QSG_ATLAS_STATS");
 
-    qCDebug(QSG_LOG_INFO, "texture atlas dimensions: %dx%d", w, h);
+    qCDebug(QSG_LOG_INFO, "texture atlas dimensions: %dx%d, up to %d pages", w, h, m_max_pages);
 }
 
 
 Manager::~Manager()
 {
-    Q_ASSERT(m_atlas == 0);
+    Q_ASSERT(m_atlases.isEmpty());
 }
 
 void Manager::invalidate()
 {
-    if (m_atlas) {
-        m_atlas->invalidate();
-        m_atlas->deleteLater();
-        m_atlas = 0;
+    if (m_log_stats && !m_atlases.isEmpty())
+        logStats("invalidated");
+
+    foreach (Atlas *atlas, m_atlases) {
+        atlas->invalidate();
+        atlas->deleteLater();
+    }
+    m_atlases.clear();
+}
+
+/*
+    A page is sparse when most of it has been freed again. New textures go
+    to sparse pages only when the others are full, so that their remaining
+    textures have a chance to go away and the page can be released.
+ */
+bool Manager::isSparse(const Atlas *atlas) const
+{
+    if (m_atlases.size() < 2)
+        return false;
+    return atlas->usedArea() * 4 < qint64(m_atlas_size.width()) * m_atlas_size.height();
+}
+
+void Manager::releaseEmptyPages()
+{
+    // Keep the first page around, it is the one that is needed again anyway.
+    for (int i = m_atlases.size() - 1; i > 0; --i) {
+        Atlas *atlas = m_atlases.at(i);
+        if (atlas->textureCount() == 0) {
+            m_atlases.removeAt(i);
+            atlas->invalidate();
+            delete atlas;
+            ++m_released_pages;
+            if (m_log_stats)
+                logStats("page released");
+        }
     }
 }
 
 QSGTexture *Manager::create(const QImage &image, bool hasAlphaChannel)
 {
+    if (image.width() >= m_atlas_size_limit || image.height() >= m_atlas_size_limit) {
+        ++m_too_large_fallbacks;
+        if (m_log_stats)
+            logStats("image too large");
+        return 0;
+    }
+
+    releaseEmptyPages();
+
+    // t may be null for atlas allocation failure
     Texture *t = 0;
-    if (image.width() < m_atlas_size_limit && image.height() < m_atlas_size_limit) {
-        if (!m_atlas)
-            m_atlas = new Atlas(m_atlas_size);
-        // t may be null for atlas allocation failure
-        t = m_atlas->create(image);
-        if (t && !hasAlphaChannel && t->hasAlphaChannel())
-            t->setHasAlphaChannel(false);
+    for (int pass = 0; pass < 2 && !t; ++pass) {
+        for (int i = 0; i < m_atlases.size() && !t; ++i) {
+            Atlas *atlas = m_atlases.at(i);
+            if (isSparse(atlas) == (pass == 0))
+                continue;
+            t = atlas->create(image);
+        }
+    }
+
+    if (!t && m_atlases.size() < m_max_pages) {
+        Atlas *atlas = new Atlas(m_atlas_size);
+        m_atlases.append(atlas);
+        if (m_log_stats)
+            logStats("page added");
+        t = atlas->create(image);
+    }
+
+    if (!t) {
+        ++m_atlas_full_fallbacks;
+        if (m_log_stats)
+            logStats("atlas full");
+        return 0;
     }
+
+    if (!hasAlphaChannel && t->hasAlphaChannel())
+        t->setHasAlphaChannel(false);
     return t;
 }
 
+Manager::Stats Manager::stats() const
+{
+    Stats s;
+    s.pages = m_atlases.size();
+    foreach (const Atlas *atlas, m_atlases) {
+        s.textures += atlas->textureCount();
+        s.usedArea += atlas->usedArea();
+    }
+    s.totalArea = qint64(m_atlas_size.width()) * m_atlas_size.height() * s.pages;
+    s.tooLargeFallbacks = m_too_large_fallbacks;
+    s.atlasFullFallbacks = m_atlas_full_fallbacks;
+    s.releasedPages = m_released_pages;
+    return s;
+}
+
+void Manager::logStats(const char *event) const
+{
+    const Stats s = stats();
+    qDebug("QSGTextureAtlas: %s: %d pages of %dx%d, %d textures, %d%% occupied, "
+           "fallbacks: %d too large, %d atlas full, %d pages released",
+           event, s.pages, m_atlas_size.width(), m_atlas_size.height(), s.textures,
+           s.totalArea ? int(s.usedArea * 100 / s.totalArea) : 0,
+           s.tooLargeFallbacks, s.atlasFullFallbacks, s.releasedPages);
+}
+
 Atlas::Atlas(const QSize &size)
     : m_allocator(size)
     , m_texture_id(0)
     , m_size(size)
+    , m_texture_count(0)
+    , m_used_area(0)
     , m_atlas_transient_image_threshold(0)
     , m_allocated(false)
 {
@@ -194,10 +301,13 @@ void Atlas::invalidate()
 Texture *Atlas::create(const QImage &image)
 {
     // No need to lock, as manager already locked it.
-    QRect rect = m_allocator.allocate(QSize(image.width() + 2, image.height() + 2));
+    const QSize size(image.width() + 2, image.height() + 2);
+    QRect rect = m_allocator.allocate(qsg_allocationSize(size));
     if (rect.width() > 0 && rect.height() > 0) {
-        Texture *t = new Texture(this, rect, image);
+        Texture *t = new Texture(this, QRect(rect.topLeft(), size), image);
         m_pending_uploads << t;
+        ++m_texture_count;
+        m_used_area += rect.width() * rect.height();
         return t;
     }
     return 0;
@@ -433,6 +543,10 @@ void Atlas::remove(Texture *t)
     QRect atlasRect = t->atlasSubRect();
     m_allocator.deallocate(atlasRect);
     m_pending_uploads.removeOne(t);
+
+    const QSize allocated = qsg_allocationSize(atlasRect.size());
+    --m_texture_count;
+    m_used_area -= allocated.width() * allocated.height();
 }
 
 
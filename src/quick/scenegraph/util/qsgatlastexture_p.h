@@ -61,7 +61,7 @@ namespace QSGAtlasTexture
 class Texture;
 class Atlas;
 
-class Manager : public QObject
+class Q_QUICK_PRIVATE_EXPORT Manager : public QObject
 {
     Q_OBJECT
 
@@ -69,14 +69,49 @@ public:
     Manager();
     ~Manager();
 
+    struct Stats
+    {
+        Stats()
+            : pages(0)
+            , textures(0)
+            , usedArea(0)
+            , totalArea(0)
+            , tooLargeFallbacks(0)
+            , atlasFullFallbacks(0)
+            , releasedPages(0)
+        {
+        }
+
+        int pages;
+        int textures;
+        qint64 usedArea;
+        qint64 totalArea;
+        int tooLargeFallbacks;
+        int atlasFullFallbacks;
+        int releasedPages;
+    };
+
     QSGTexture *create(const QImage &image, bool hasAlphaChannel);
     void invalidate();
 
+    Stats stats() const;
+
 private:
-    Atlas *m_atlas;
+    bool isSparse(const Atlas *atlas) const;
+    void releaseEmptyPages();
+    void logStats(const char *event) const;
+
+    QList<Atlas *> m_atlases;
 
     QSize m_atlas_size;
     int m_atlas_size_limit;
+    int m_max_pages;
+
+    int m_too_large_fallbacks;
+    int m_atlas_full_fallbacks;
+    int m_released_pages;
+
+    uint m_log_stats : 1;
 };
 
 class Atlas : public QObject
@@ -97,6 +132,8 @@ public:
     void remove(Texture *t);
 
     QSize size() const { return m_size; }
+    int textureCount() const { return m_texture_count; }
+    qint64 usedArea() const { return m_used_area; }
 
     GLuint internalFormat() const { return m_internalFormat; }
     GLuint externalFormat() const { return m_externalFormat; }
@@ -106,6 +143,8 @@ private:
     GLuint m_texture_id;
     QSize m_size;
     QList<Texture *> m_pending_uploads;
+    int m_texture_count;
+    qint64 m_used_area;
 
     GLuint m_internalFormat;
     GLuint m_externalFormat;
@@ -369,6 +369,36 @@ static void maybeRemoveAlpha(QImage *image)
     }
 }
 
+/*
+    Converts a decoded image to one of the formats the scene graph uploads
+    as is, so that the conversion happens on the thread that decoded the
+    image rather than on the render thread in the middle of a frame.
+    Indexed and grayscale images are left alone, as they would take up to
+    four times as much memory for as long as they are cached.
+ */
+static void prepareImageForUpload(QImage *image)
+{
+    static const bool disabled = qEnvironmentVariableIsSet("QSG_NO_IMAGE_PRECONVERSION");
+    if (disabled || image->isNull())
+        return;
+
+    switch (image->format()) {
+    case QImage::Format_Mono:
+    case QImage::Format_MonoLSB:
+    case QImage::Format_Indexed8:
+    case QImage::Format_Alpha8:
+    case QImage::Format_Grayscale8:
+        return;
+    default:
+        break;
+    }
+
+    const QImage::Format format = image->hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                           : QImage::Format_RGB32;
+    if (image->format() != format)
+        *image = image->convertToFormat(format);
+}
+
 static bool readImage(const QUrl& url, QIODevice *dev, QImage *image, QString *errorString, QSize *impsize,
                       const QSize &requestSize, AutoTransform &autoTransform)
 {
@@ -403,6 +433,7 @@ static bool readImage(const QUrl& url, QIODevice *dev, QImage *image, QString *e
 
     if (imgio.read(image)) {
         maybeRemoveAlpha(image);
+        prepareImageForUpload(image);
         if (impsize && impsize->width() < 0)
             *impsize = image->size();
         return true;
@@ -662,6 +693,8 @@ void QQuickPixmapReader::processJob(QQuickPixmapReply *runningJob, const QUrl &u
                 if (image.isNull()) {
                     errorCode = QQuickPixmapReply::Loading;
                     errorStr = QQuickPixmap::tr("Failed to get image from provider: %1").arg(url.toString());
+                } else {
+                    prepareImageForUpload(&image);
                 }
                 mutex.lock();
                 if (!cancelled.contains(runningJob))
@@ -675,13 +708,17 @@ void QQuickPixmapReader::processJob(QQuickPixmapReply *runningJob, const QUrl &u
                 const QPixmap pixmap = provider->requestPixmap(imageId(url), &readSize, runningJob->requestSize);
                 QQuickPixmapReply::ReadError errorCode = QQuickPixmapReply::NoError;
                 QString errorStr;
+                QImage image;
                 if (pixmap.isNull()) {
                     errorCode = QQuickPixmapReply::Loading;
                     errorStr = QQuickPixmap::tr("Failed to get image from provider: %1").arg(url.toString());
+                } else {
+                    image = pixmap.toImage();
+                    prepareImageForUpload(&image);
                 }
                 mutex.lock();
                 if (!cancelled.contains(runningJob))
-                    runningJob->postReply(errorCode, errorStr, readSize, QQuickTextureFactory::textureFactoryForImage(pixmap.toImage()));
+                    runningJob->postReply(errorCode, errorStr, readSize, QQuickTextureFactory::textureFactoryForImage(image));
                 mutex.unlock();
                 break;
             }
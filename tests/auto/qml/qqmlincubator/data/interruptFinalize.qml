@@ -0,0 +1,7 @@
+import Qt.test 1.0
+
+SelfRegistering {
+    property variant a: FinalizeCallback {}
+    property variant b: FinalizeCallback {}
+    property variant c: FinalizeCallback {}
+}
@@ -32,6 +32,7 @@
 ****************************************************************************/
 #include "testtypes.h"
 #include <QtQml/qqml.h>
+#include <private/qqmlengine_p.h>
 
 SelfRegisteringType *SelfRegisteringType::m_me = 0;
 SelfRegisteringType::SelfRegisteringType()
@@ -139,6 +140,49 @@ void CompletionCallbackType::registerCallback(callback c, void *d)
     m_data = d;
 }
 
+FinalizeCallbackType::callback FinalizeCallbackType::m_callback = 0;
+void *FinalizeCallbackType::m_data = 0;
+int FinalizeCallbackType::m_totalFinalized = 0;
+FinalizeCallbackType::FinalizeCallbackType()
+: m_finalized(0)
+{
+}
+
+void FinalizeCallbackType::classBegin()
+{
+}
+
+void FinalizeCallbackType::componentComplete()
+{
+    QQmlEnginePrivate::get(qmlEngine(this))->registerFinalizeCallback(
+                this, metaObject()->indexOfSlot("componentFinalized()"));
+}
+
+void FinalizeCallbackType::componentFinalized()
+{
+    ++m_finalized;
+    ++m_totalFinalized;
+    if (m_callback) m_callback(this, m_data);
+}
+
+void FinalizeCallbackType::clearCallback()
+{
+    m_callback = 0;
+    m_data = 0;
+    m_totalFinalized = 0;
+}
+
+void FinalizeCallbackType::registerCallback(callback c, void *d)
+{
+    m_callback = c;
+    m_data = d;
+}
+
+int FinalizeCallbackType::totalFinalized()
+{
+    return m_totalFinalized;
+}
+
 void registerTypes()
 {
     qmlRegisterType<SelfRegisteringType>("Qt.test", 1,0, "SelfRegistering");
@@ -146,4 +190,5 @@ void registerTypes()
     qmlRegisterType<CompletionRegisteringType>("Qt.test", 1,0, "CompletionRegistering");
     qmlRegisterType<CallbackRegisteringType>("Qt.test", 1,0, "CallbackRegistering");
     qmlRegisterType<CompletionCallbackType>("Qt.test", 1,0, "CompletionCallback");
+    qmlRegisterType<FinalizeCallbackType>("Qt.test", 1,0, "FinalizeCallback");
 }
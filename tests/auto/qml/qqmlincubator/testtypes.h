@@ -133,6 +133,35 @@ private:
     static void *m_data;
 };
 
+class FinalizeCallbackType : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+    Q_PROPERTY(int finalized READ finalized)
+public:
+    FinalizeCallbackType();
+
+    virtual void classBegin();
+    virtual void componentComplete();
+
+    int finalized() const { return m_finalized; }
+
+    typedef void (*callback)(FinalizeCallbackType *, void *);
+    static void clearCallback();
+    static void registerCallback(callback, void *);
+    static int totalFinalized();
+
+public slots:
+    void componentFinalized();
+
+private:
+    int m_finalized;
+
+    static callback m_callback;
+    static void *m_data;
+    static int m_totalFinalized;
+};
+
 void registerTypes();
 
 #endif // TESTTYPES_H
@@ -73,6 +73,7 @@ private slots:
     void chainedAsynchronousClear();
     void selfDelete();
     void contextDelete();
+    void interruptFinalize();
 
 private:
     QQmlIncubationController controller;
@@ -1149,6 +1150,54 @@ void tst_qqmlincubator::contextDelete()
     }
 }
 
+// Finalization can be interrupted after every finalize callback, and resumes
+// with the next one without invoking any callback twice.
+void tst_qqmlincubator::interruptFinalize()
+{
+    struct CallbackData {
+        static void callback(FinalizeCallbackType *, void *data) {
+            *static_cast<bool *>(data) = false;
+        }
+    };
+
+    SelfRegisteringType::clearMe();
+
+    QQmlComponent component(&engine, testFileUrl("interruptFinalize.qml"));
+    QVERIFY(component.isReady());
+
+    QQmlIncubator incubator(QQmlIncubator::Asynchronous);
+    component.create(incubator);
+    QVERIFY(incubator.isLoading());
+
+    bool b = true;
+    FinalizeCallbackType::registerCallback(&CallbackData::callback, &b);
+
+    for (int i = 1; i <= 3; ++i) {
+        b = true;
+        controller.incubateWhile(&b);
+        QVERIFY(incubator.isLoading());
+        QCOMPARE(FinalizeCallbackType::totalFinalized(), i);
+    }
+
+    b = true;
+    controller.incubateWhile(&b);
+    QVERIFY(incubator.isReady());
+    QCOMPARE(FinalizeCallbackType::totalFinalized(), 3);
+    FinalizeCallbackType::clearCallback();
+
+    QObject *object = incubator.object();
+    QVERIFY(object);
+    QCOMPARE(object, static_cast<QObject *>(SelfRegisteringType::me()));
+    const char *properties[] = { "a", "b", "c" };
+    for (int i = 0; i < 3; ++i) {
+        QObject *finalizeCallback = object->property(properties[i]).value<QObject *>();
+        QVERIFY(finalizeCallback);
+        QCOMPARE(finalizeCallback->property("finalized").toInt(), 1);
+    }
+
+    delete object;
+}
+
 QTEST_MAIN(tst_qqmlincubator)
 
 #include "tst_qqmlincubator.moc"
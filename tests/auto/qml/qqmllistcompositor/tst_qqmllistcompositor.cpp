@@ -142,6 +142,8 @@ class tst_qqmllistcompositor : public QObject
 private slots:
     void find_data();
     void find();
+    void findFragmented();
+    void findFragmentedAfterChanges();
     void findInsertPosition_data();
     void findInsertPosition();
     void insert();
@@ -225,6 +227,109 @@ void tst_qqmllistcompositor::find()
     QCOMPARE(it->index, rangeIndex);
 }
 
+void tst_qqmllistcompositor::findFragmented()
+{
+    int listA; void *a = &listA;
+
+    QQmlListCompositor compositor;
+    compositor.setGroupCount(4);
+    compositor.setDefaultGroups(VisibleFlag | C::DefaultFlag);
+
+    // Remove every other item from the visible group so each item has a range of its own.
+    const int count = 1000;
+    compositor.append(a, 0, count, C::AppendFlag | C::PrependFlag | VisibleFlag | C::DefaultFlag);
+    for (int i = 1; i <= count / 2; ++i)
+        compositor.clearFlags(Visible, i, 1, VisibleFlag);
+
+    QCOMPARE(compositor.count(C::Default), count);
+    QCOMPARE(compositor.count(Visible), count / 2);
+
+    // Jump back and forth so lookups are not adjacent to the previous one.
+    for (int i = 0; i < count / 2; ++i) {
+        const int index = i % 2 ? count / 2 - i : i;
+        C::iterator it = compositor.find(Visible, index);
+        QCOMPARE(it.index[Visible], index);
+        QCOMPARE(it.index[C::Default], 2 * index);
+        QCOMPARE(it.modelIndex(), 2 * index);
+
+        it = compositor.find(C::Default, count - 1 - index);
+        QCOMPARE(it.modelIndex(), count - 1 - index);
+    }
+
+    // Lookups remain valid after the ranges are modified.
+    compositor.setFlags(C::Default, 1, 1, VisibleFlag);
+    QCOMPARE(compositor.count(Visible), count / 2 + 1);
+    C::iterator it = compositor.find(Visible, count / 2);
+    QCOMPARE(it.modelIndex(), count - 2);
+    it = compositor.find(Visible, 1);
+    QCOMPARE(it.modelIndex(), 1);
+
+    QQmlListCompositor::insert_iterator insertIt = compositor.findInsertPosition(Visible, count / 2 + 1);
+    QCOMPARE(insertIt.index[Visible], count / 2 + 1);
+}
+
+void tst_qqmllistcompositor::findFragmentedAfterChanges()
+{
+    int listA; void *a = &listA;
+
+    QQmlListCompositor compositor;
+    compositor.setGroupCount(4);
+    compositor.setDefaultGroups(VisibleFlag | C::DefaultFlag);
+
+    const int count = 1000;
+    compositor.append(a, 0, count, C::AppendFlag | C::PrependFlag | VisibleFlag | C::DefaultFlag);
+
+    // The model index and visibility of every item in the default group.
+    QList<int> modelIndexes;
+    QList<bool> visible;
+    for (int i = 0; i < count; ++i) {
+        modelIndexes.append(i);
+        visible.append(true);
+    }
+
+    // Modify the ranges at scattered positions, each time looking up items both in front of
+    // and after the modification so checkpoints on either side of it are used.
+    int position = 0;
+    for (int i = 0; i < 300; ++i) {
+        position = (position + 379) % count;
+        switch (i % 3) {
+        case 0:
+            compositor.clearFlags(C::Default, position, 1, VisibleFlag);
+            visible[position] = false;
+            break;
+        case 1:
+            compositor.setFlags(C::Default, position, 1, VisibleFlag);
+            visible[position] = true;
+            break;
+        default: {
+            const int to = (position + 500) % count;
+            compositor.move(C::Default, position, C::Default, to, 1, C::Default);
+            modelIndexes.move(position, to);
+            visible.move(position, to);
+            break;
+        }
+        }
+
+        QList<int> visibleIndexes;
+        for (int j = 0; j < count; ++j) {
+            if (visible.at(j))
+                visibleIndexes.append(j);
+        }
+        QCOMPARE(compositor.count(Visible), visibleIndexes.count());
+
+        for (int j = 0; j < 4; ++j) {
+            const int index = (position + j * count / 4) % count;
+            C::iterator it = compositor.find(C::Default, index);
+            QCOMPARE(it.modelIndex(), modelIndexes.at(index));
+
+            const int visibleIndex = index % visibleIndexes.count();
+            it = compositor.find(Visible, visibleIndex);
+            QCOMPARE(it.index[C::Default], visibleIndexes.at(visibleIndex));
+            QCOMPARE(it.modelIndex(), modelIndexes.at(visibleIndexes.at(visibleIndex)));
+        }
+    }
+}
+
 void tst_qqmllistcompositor::findInsertPosition_data()
 {
     QTest::addColumn<RangeList>("ranges");
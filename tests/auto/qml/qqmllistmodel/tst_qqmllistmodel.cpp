@@ -42,6 +42,7 @@
 #include <QtCore/qtimer.h>
 #include <QtCore/qdebug.h>
 #include <QtCore/qtranslator.h>
+#include <QtCore/qpointer.h>
 #include <QSignalSpy>
 
 #include "../../shared/util.h"
@@ -87,6 +88,7 @@ private:
     int roleFromName(const QQmlListModel *model, const QString &roleName);
 
     static bool compareVariantList(const QVariantList &testList, QVariant object);
+    static QQmlListModel *createModel(QQmlEngine *engine, bool dynamicRoles);
 
 private slots:
     void static_types();
@@ -128,8 +130,30 @@ private slots:
     void about_to_be_signals();
     void modify_through_delegate();
     void bindingsOnGetResult();
+    void batchChanges_data();
+    void batchChanges();
+    void setRows_data();
+    void setRows();
+    void setRowsUnchanged_data();
+    void setRowsUnchanged();
+    void setRowsInvalid();
+    void batchMethodsRevision();
+    void objectIndexAfterChange_data();
+    void objectIndexAfterChange();
 };
 
+// setRows(), beginBatch() and endBatch() are only available from QtQml.Models 2.3
+QQmlListModel *tst_qqmllistmodel::createModel(QQmlEngine *engine, bool dynamicRoles)
+{
+    QQmlComponent component(engine);
+    component.setData(QByteArray("import QtQml.Models 2.3\nListModel { dynamicRoles: ")
+                      + (dynamicRoles ? "true" : "false") + " }", QUrl());
+    QQmlListModel *model = qobject_cast<QQmlListModel *>(component.create());
+    if (model)
+        engine->rootContext()->setContextObject(model);
+    return model;
+}
+
 bool tst_qqmllistmodel::compareVariantList(const QVariantList &testList, QVariant object)
 {
     bool allOk = true;
@@ -1487,6 +1511,261 @@ void tst_qqmllistmodel::bindingsOnGetResult()
     QVERIFY(obj->property("success").toBool());
 }
 
+void tst_qqmllistmodel::batchChanges_data()
+{
+    QTest::addColumn<bool>("dynamicRoles");
+
+    QTest::newRow("static") << false;
+    QTest::newRow("dynamic") << true;
+}
+
+void tst_qqmllistmodel::batchChanges()
+{
+    QFETCH(bool, dynamicRoles);
+
+    QQmlEngine engine;
+    QScopedPointer<QQmlListModel> modelPtr(createModel(&engine, dynamicRoles));
+    QVERIFY(modelPtr);
+    QQmlListModel &model = *modelPtr;
+
+    QQmlExpression setup(engine.rootContext(), &model,
+            "{ for (var i = 0; i < 5; ++i) append({'a': i, 'b': i}); }");
+    setup.evaluate();
+    QCOMPARE(model.count(), 5);
+
+    QSignalSpy spyChanged(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    QSignalSpy spyInserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+
+    QQmlExpression change(engine.rootContext(), &model,
+            "{ beginBatch(); setProperty(1, 'a', 10); beginBatch(); set(3, {'b': 30}); endBatch(); }");
+    change.evaluate();
+    QCOMPARE(spyChanged.count(), 0);
+
+    QQmlExpression end(engine.rootContext(), &model, "{ endBatch(); }");
+    end.evaluate();
+    QCOMPARE(spyChanged.count(), 1);
+    QCOMPARE(spyChanged.at(0).at(0).value<QModelIndex>(), model.index(1, 0, QModelIndex()));
+    QCOMPARE(spyChanged.at(0).at(1).value<QModelIndex>(), model.index(3, 0, QModelIndex()));
+    QCOMPARE(spyChanged.at(0).at(2).value<QVector<int> >().count(), 2);
+
+    // Structural changes report the changes collected so far first
+    spyChanged.clear();
+    QQmlExpression structural(engine.rootContext(), &model,
+            "{ beginBatch(); setProperty(0, 'a', 20); append({'a': 5, 'b': 5}); setProperty(4, 'a', 40); }");
+    structural.evaluate();
+    QCOMPARE(spyChanged.count(), 1);
+    QCOMPARE(spyInserted.count(), 1);
+    QCOMPARE(spyChanged.at(0).at(0).value<QModelIndex>(), model.index(0, 0, QModelIndex()));
+
+    end.evaluate();
+    QCOMPARE(spyChanged.count(), 2);
+    QCOMPARE(spyChanged.at(1).at(0).value<QModelIndex>(), model.index(4, 0, QModelIndex()));
+
+    QTest::ignoreMessage(QtWarningMsg, "<Unknown File>:2:1: QML ListModel: endBatch: no batch in progress");
+    end.evaluate();
+}
+
+void tst_qqmllistmodel::setRows_data()
+{
+    QTest::addColumn<bool>("dynamicRoles");
+
+    QTest::newRow("static") << false;
+    QTest::newRow("dynamic") << true;
+}
+
+void tst_qqmllistmodel::setRows()
+{
+    QFETCH(bool, dynamicRoles);
+
+    QQmlEngine engine;
+    QScopedPointer<QQmlListModel> modelPtr(createModel(&engine, dynamicRoles));
+    QVERIFY(modelPtr);
+    QQmlListModel &model = *modelPtr;
+
+    QQmlExpression setup(engine.rootContext(), &model,
+            "{ for (var i = 0; i < 5; ++i) append({'a': i}); }");
+    setup.evaluate();
+
+    QSignalSpy spyChanged(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    QSignalSpy spyInserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+
+    QQmlExpression expr(engine.rootContext(), &model,
+            "{ setRows(3, [{'a': 30}, {'a': 40}, {'a': 50}, {'a': 60}]); }");
+    expr.evaluate();
+    QVERIFY2(!expr.hasError(), QTest::toString(expr.error().toString()));
+
+    QCOMPARE(model.count(), 7);
+
+    QCOMPARE(spyChanged.count(), 1);
+    QCOMPARE(spyChanged.at(0).at(0).value<QModelIndex>(), model.index(3, 0, QModelIndex()));
+    QCOMPARE(spyChanged.at(0).at(1).value<QModelIndex>(), model.index(4, 0, QModelIndex()));
+
+    QCOMPARE(spyInserted.count(), 1);
+    QCOMPARE(spyInserted.at(0).at(1).toInt(), 5);
+    QCOMPARE(spyInserted.at(0).at(2).toInt(), 6);
+
+    const int role = model.roleNames().key("a");
+    QCOMPARE(model.data(model.index(2, 0, QModelIndex()), role).toInt(), 2);
+    QCOMPARE(model.data(model.index(3, 0, QModelIndex()), role).toInt(), 30);
+    QCOMPARE(model.data(model.index(6, 0, QModelIndex()), role).toInt(), 60);
+}
+
+void tst_qqmllistmodel::setRowsUnchanged_data()
+{
+    QTest::addColumn<bool>("dynamicRoles");
+
+    QTest::newRow("static") << false;
+    QTest::newRow("dynamic") << true;
+}
+
+void tst_qqmllistmodel::setRowsUnchanged()
+{
+    QFETCH(bool, dynamicRoles);
+
+    QQmlEngine engine;
+    QScopedPointer<QQmlListModel> modelPtr(createModel(&engine, dynamicRoles));
+    QVERIFY(modelPtr);
+    QQmlListModel &model = *modelPtr;
+
+    QQmlExpression setup(engine.rootContext(), &model,
+            "{ for (var i = 0; i < 3; ++i) append({'a': i, 'b': i}); }");
+    setup.evaluate();
+
+    QSignalSpy spyChanged(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+
+    // Setting the values rows already have reports nothing, rather than a change of all roles
+    QQmlExpression unchanged(engine.rootContext(), &model,
+            "{ setRows(0, [{'a': 0}, {'a': 1, 'b': 1}]); }");
+    unchanged.evaluate();
+    QCOMPARE(spyChanged.count(), 0);
+
+    // Only the roles that changed in any of the rows are reported
+    QQmlExpression changed(engine.rootContext(), &model,
+            "{ setRows(0, [{'a': 0}, {'a': 1, 'b': 10}, {'a': 2}]); }");
+    changed.evaluate();
+    QCOMPARE(spyChanged.count(), 1);
+    const QVector<int> roles = spyChanged.at(0).at(2).value<QVector<int> >();
+    QCOMPARE(roles.count(), 1);
+    QCOMPARE(roles.at(0), model.roleNames().key("b"));
+}
+
+void tst_qqmllistmodel::setRowsInvalid()
+{
+    QQmlEngine engine;
+    QScopedPointer<QQmlListModel> modelPtr(createModel(&engine, false));
+    QVERIFY(modelPtr);
+    QQmlListModel &model = *modelPtr;
+
+    QQmlExpression setup(engine.rootContext(), &model, "{ append({'a': 0}); }");
+    setup.evaluate();
+
+    QSignalSpy spyChanged(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    QSignalSpy spyInserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+
+    QTest::ignoreMessage(QtWarningMsg, "<Unknown File>:2:1: QML ListModel: setRows: incorrect number of arguments");
+    QQmlExpression noArray(engine.rootContext(), &model, "{ setRows(0); }");
+    noArray.evaluate();
+
+    QTest::ignoreMessage(QtWarningMsg, "<Unknown File>:2:1: QML ListModel: setRows: incorrect number of arguments");
+    QQmlExpression tooMany(engine.rootContext(), &model, "{ setRows(0, [{'a': 1}], 1); }");
+    tooMany.evaluate();
+
+    QTest::ignoreMessage(QtWarningMsg, "<Unknown File>:2:1: QML ListModel: setRows: value is not an array");
+    QQmlExpression notArray(engine.rootContext(), &model, "{ setRows(0, {'a': 1}); }");
+    notArray.evaluate();
+
+    QTest::ignoreMessage(QtWarningMsg, "<Unknown File>:2:1: QML ListModel: setRows: index 2 out of range");
+    QQmlExpression outOfRange(engine.rootContext(), &model, "{ setRows(2, [{'a': 1}]); }");
+    outOfRange.evaluate();
+
+    QCOMPARE(model.count(), 1);
+    QCOMPARE(spyChanged.count(), 0);
+    QCOMPARE(spyInserted.count(), 0);
+}
+
+void tst_qqmllistmodel::batchMethodsRevision()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData("import QtQml.Models 2.1\n"
+                      "ListModel {\n"
+                      "    property bool hasSetRows: typeof setRows === 'function'\n"
+                      "    property bool hasBeginBatch: typeof beginBatch === 'function'\n"
+                      "    property bool hasEndBatch: typeof endBatch === 'function'\n"
+                      "}", QUrl());
+    QScopedPointer<QObject> model(component.create());
+    QVERIFY2(model, qPrintable(component.errorString()));
+    QCOMPARE(model->property("hasSetRows").toBool(), false);
+    QCOMPARE(model->property("hasBeginBatch").toBool(), false);
+    QCOMPARE(model->property("hasEndBatch").toBool(), false);
+
+    QScopedPointer<QQmlListModel> revisioned(createModel(&engine, false));
+    QVERIFY(revisioned);
+    QQmlExpression expr(engine.rootContext(), revisioned.data(),
+            "typeof setRows === 'function' && typeof beginBatch === 'function' && typeof endBatch === 'function'");
+    QCOMPARE(expr.evaluate().toBool(), true);
+}
+
+void tst_qqmllistmodel::objectIndexAfterChange_data()
+{
+    QTest::addColumn<QString>("change");
+    QTest::addColumn<QList<int> >("order");
+
+    // order lists the original row of every row after the change, or -1 for new rows
+    QTest::newRow("insert front") << "insert(0, {'a': -1})" << (QList<int>() << -1 << 0 << 1 << 2 << 3 << 4 << 5);
+    QTest::newRow("insert middle") << "insert(3, {'a': -1})" << (QList<int>() << 0 << 1 << 2 << -1 << 3 << 4 << 5);
+    QTest::newRow("remove front") << "remove(0)" << (QList<int>() << 1 << 2 << 3 << 4 << 5);
+    QTest::newRow("remove middle") << "remove(2, 2)" << (QList<int>() << 0 << 1 << 4 << 5);
+    QTest::newRow("move forwards") << "move(1, 3, 2)" << (QList<int>() << 0 << 3 << 4 << 1 << 2 << 5);
+    QTest::newRow("move backwards") << "move(4, 1, 2)" << (QList<int>() << 0 << 4 << 5 << 1 << 2 << 3);
+}
+
+// Objects returned by get() must keep referring to their row when other rows are
+// inserted, removed or moved.
+void tst_qqmllistmodel::objectIndexAfterChange()
+{
+    QFETCH(QString, change);
+    QFETCH(QList<int>, order);
+
+    QQmlEngine engine;
+    QQmlListModel model;
+    QQmlEngine::setContextForObject(&model, engine.rootContext());
+    engine.rootContext()->setContextObject(&model);
+
+    QQmlExpression setup(engine.rootContext(), &model,
+            QString::fromLatin1("{ for (var i = 0; i < 6; ++i) append({'a': i}); }"));
+    setup.evaluate();
+    QVERIFY2(!setup.hasError(), qPrintable(setup.error().toString()));
+
+    QList<QPointer<QObject> > objects;
+    for (int i = 0; i < 6; ++i) {
+        QQmlExpression getObject(engine.rootContext(), &model, QString::fromLatin1("get(%1)").arg(i));
+        QObject *object = getObject.evaluate().value<QObject *>();
+        QVERIFY(object);
+        objects.append(object);
+    }
+
+    QQmlExpression expr(engine.rootContext(), &model, change);
+    expr.evaluate();
+    QVERIFY2(!expr.hasError(), qPrintable(expr.error().toString()));
+
+    // Writing through the cached object uses the element index it stores.
+    for (int row = 0; row < order.count(); ++row) {
+        const int original = order.at(row);
+        if (original < 0)
+            continue;
+        QVERIFY(objects.at(original));
+        QVERIFY(objects.at(original)->setProperty("a", 100 + original));
+    }
+
+    QCOMPARE(model.count(), order.count());
+    const int role = model.roleNames().key("a");
+    for (int row = 0; row < order.count(); ++row) {
+        const int expected = order.at(row) >= 0 ? 100 + order.at(row) : -1;
+        QCOMPARE(model.data(model.index(row, 0, QModelIndex()), role).toInt(), expected);
+    }
+}
+
 QTEST_MAIN(tst_qqmllistmodel)
 
 #include "tst_qqmllistmodel.moc"
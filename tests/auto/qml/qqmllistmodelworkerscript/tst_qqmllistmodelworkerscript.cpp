@@ -287,6 +287,9 @@ void tst_qqmllistmodelworkerscript::dynamic_data()
         QTest::newRow("move3c") << "{append({'foo':123});append({'foo':456});append({'foo':789});move(1,0,-1);count}" << 3 << "<Unknown File>: QML ListModel: move: out of range" << dr;
         QTest::newRow("move3d") << "{append({'foo':123});append({'foo':456});append({'foo':789});move(0,3,1);count}" << 3 << "<Unknown File>: QML ListModel: move: out of range" << dr;
 
+        QTest::newRow("mixed1") << "{append({'foo':1});append({'foo':2});append({'foo':3});remove(0);insert(0,{'foo':4});set(2,{'foo':5});move(0,2,1);get(1).foo}" << 5 << "" << dr;
+        QTest::newRow("mixed2") << "{append({'foo':1});append({'foo':2});setProperty(0,'foo',6);clear();append({'foo':7});append({'foo':8});setProperty(1,'foo',9);get(1).foo}" << 9 << "" << dr;
+
         QTest::newRow("large1") << "{append({'a':1,'b':2,'c':3,'d':4,'e':5,'f':6,'g':7,'h':8});get(0).h}" << 8 << "" << dr;
 
         QTest::newRow("datatypes1") << "{append({'a':1});append({'a':'string'});}" << 0 << "<Unknown File>: Can't assign to existing role 'a' of different type [String -> Number]" << dr;
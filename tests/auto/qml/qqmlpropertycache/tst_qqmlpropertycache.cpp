@@ -33,7 +33,9 @@
 
 #include <qtest.h>
 #include <private/qqmlpropertycache_p.h>
+#include <private/qqmlengine_p.h>
 #include <QtQml/qqmlengine.h>
+#include <QtQml/qqml.h>
 #include <private/qv8engine_p.h>
 #include "../../shared/util.h"
 
@@ -50,6 +52,7 @@ private slots:
     void methodsDerived();
     void signalHandlers();
     void signalHandlersDerived();
+    void sharedBetweenEngines();
 
 private:
     QQmlEngine engine;
@@ -277,6 +280,36 @@ void tst_qqmlpropertycache::signalHandlersDerived()
     QCOMPARE(data->coreIndex, metaObject->indexOfMethod("propertyDChanged()"));
 }
 
+void tst_qqmlpropertycache::sharedBetweenEngines()
+{
+    qmlRegisterType<BaseObject>("Test.PropertyCache", 1, 0, "BaseObject");
+
+    QQmlEngine engine1;
+    QQmlEngine engine2;
+    QQmlEnginePrivate *ep1 = QQmlEnginePrivate::get(&engine1);
+    QQmlEnginePrivate *ep2 = QQmlEnginePrivate::get(&engine2);
+
+    // Registered C++ types are cached once for all engines
+    QQmlPropertyCache *baseCache = ep1->cache(&BaseObject::staticMetaObject);
+    QVERIFY(baseCache);
+    QCOMPARE(ep2->cache(&BaseObject::staticMetaObject), baseCache);
+    QVERIFY(!baseCache->engine);
+    QVERIFY(cacheProperty(baseCache, "propertyA"));
+
+    // Types that are not registered are cached per engine
+    QQmlPropertyCache *derivedCache1 = ep1->cache(&DerivedObject::staticMetaObject);
+    QQmlPropertyCache *derivedCache2 = ep2->cache(&DerivedObject::staticMetaObject);
+    QVERIFY(derivedCache1);
+    QVERIFY(derivedCache2);
+    QVERIFY(derivedCache1 != derivedCache2);
+    QCOMPARE(derivedCache1->parent(), baseCache);
+    QCOMPARE(derivedCache2->parent(), baseCache);
+    QCOMPARE(derivedCache1->engine, QV8Engine::getV4(&engine1));
+    QCOMPARE(derivedCache2->engine, QV8Engine::getV4(&engine2));
+    QVERIFY(cacheProperty(derivedCache1, "propertyA"));
+    QVERIFY(cacheProperty(derivedCache1, "propertyC"));
+}
+
 QTEST_MAIN(tst_qqmlpropertycache)
 
 #include "tst_qqmlpropertycache.moc"
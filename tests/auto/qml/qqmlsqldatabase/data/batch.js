@@ -0,0 +1,58 @@
+.import QtQuick.LocalStorage 2.0 as Sql
+
+function test() {
+    var db = Sql.LocalStorage.openDatabaseSync("QmlTestDB-batch", "", "Test database from Qt autotests", 1000000);
+    var r="transaction_not_finished";
+
+    db.transaction(
+        function(tx) {
+            tx.executeSql('CREATE TABLE IF NOT EXISTS Numbers(num INTEGER, txt TEXT)');
+            var values = [];
+            for (var i = 0; i < 1000; ++i)
+                values.push([ i, 'number ' + i ]);
+            var rs = tx.executeSqlBatch('INSERT INTO Numbers VALUES(?, ?)', values);
+            if (rs.rowsAffected != 1000)
+                r = "BATCH AFFECTED WRONG ROW COUNT " + rs.rowsAffected;
+            else
+                r = "";
+            tx.executeSqlBatch('INSERT INTO Numbers VALUES(:num, :txt)', [ { ":num": 1000, ":txt": "named" } ]);
+            // Re-executing a statement with fewer values than before must not reuse the old ones.
+            try {
+                tx.executeSql('INSERT INTO Numbers VALUES(?, ?)', [ 1001 ]);
+                r += " MISSING VALUE NOT REPORTED";
+            } catch (e) {
+            }
+        }
+    );
+
+    if (r == "") {
+        db.readTransaction(function (tx) {
+            var rs = tx.executeSql('SELECT * FROM Numbers ORDER BY num');
+            if (rs.rows.length != 1001)
+                r = "SELECT RETURNED WRONG COUNT " + rs.rows.length;
+            else if (rs.rows.item(500).txt != "number 500" || rs.rows.item(1000).txt != "named")
+                r = "SELECT RETURNED WRONG VALUES";
+            else
+                r = "passed";
+        });
+    }
+
+    if (r == "passed") {
+        try {
+            db.transaction(function (tx) {
+                tx.executeSqlBatch('INSERT INTO Numbers VALUES(?, ?)', [ [ 2000, 'a' ], [ 2001 ] ]);
+            });
+            r = "FAILED BATCH NOT REPORTED";
+        } catch (e) {
+            if (e.code != SQLException.DATABASE_ERR)
+                r = "WRONG ERROR CODE " + e.code;
+        }
+        db.readTransaction(function (tx) {
+            var rs = tx.executeSql('SELECT * FROM Numbers WHERE num >= 2000');
+            if (rs.rows.length != 0)
+                r = "FAILED BATCH NOT ROLLED BACK";
+        });
+    }
+
+    return r;
+}
@@ -0,0 +1,37 @@
+.import QtQuick.LocalStorage 2.0 as Sql
+
+function test() {
+    var db = Sql.LocalStorage.openDatabaseSync("QmlTestDB-cache-bindnames", "", "Test database from Qt autotests", 1000000);
+    var r="transaction_not_finished";
+
+    db.transaction(
+        function(tx) {
+            tx.executeSql('CREATE TABLE IF NOT EXISTS Pairs(a INTEGER, b TEXT)');
+            tx.executeSql('INSERT INTO Pairs VALUES(:a, :b)', { ':a': 1, ':b': 'one' });
+            // Same statement, other names: the value bound to :b before must not be reused.
+            try {
+                tx.executeSql('INSERT INTO Pairs VALUES(:a, :b)', { ':a': 2, ':c': 'two' });
+            } catch (e) {
+            }
+            tx.executeSql('INSERT INTO Pairs VALUES(:a, :b)', { ':b': 'three', ':a': 3 });
+            tx.executeSql('INSERT INTO Pairs VALUES(:a, :b)', [ 4, 'four' ]);
+            r = "";
+        }
+    );
+
+    if (r == "") {
+        db.readTransaction(function (tx) {
+            var rs = tx.executeSql('SELECT * FROM Pairs ORDER BY a');
+            var rows = [];
+            for (var i = 0; i < rs.rows.length; ++i)
+                rows.push(rs.rows.item(i).a + "=" + rs.rows.item(i).b);
+            var expected = "1=one,3=three,4=four";
+            if (rows.join(",") != expected && rows.join(",") != "1=one,2=null,3=three,4=four")
+                r = "SELECT RETURNED WRONG VALUES " + rows.join(",");
+            else
+                r = "passed";
+        });
+    }
+
+    return r;
+}
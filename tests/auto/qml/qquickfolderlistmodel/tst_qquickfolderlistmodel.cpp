@@ -36,6 +36,7 @@
 #include <QtQml/qqmlcomponent.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
+#include <QtCore/qtemporarydir.h>
 #include <QtCore/qabstractitemmodel.h>
 #include <QDebug>
 #include "../../shared/util.h"
@@ -75,6 +76,9 @@ private slots:
     void showDotAndDotDot_data();
     void sortReversed();
     void introspectQrc();
+#ifndef QT_NO_FILESYSTEMWATCHER
+    void incrementalUpdate();
+#endif
 
 private:
     void checkNoErrors(const QQmlComponent& component);
@@ -366,6 +370,54 @@ void tst_qquickfolderlistmodel::introspectQrc()
     QCOMPARE(flm->data(flm->index(0),FileNameRole).toString(), QLatin1String("hello.txt"));
 }
 
+#ifndef QT_NO_FILESYSTEMWATCHER
+static bool touchFile(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly);
+}
+
+void tst_qquickfolderlistmodel::incrementalUpdate()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString dirPath = tempDir.path();
+    QVERIFY(touchFile(dirPath + QLatin1String("/a.qml")));
+    QVERIFY(touchFile(dirPath + QLatin1String("/c.qml")));
+    QVERIFY(touchFile(dirPath + QLatin1String("/e.qml")));
+
+    QQmlComponent component(&engine, testFileUrl("basic.qml"));
+    checkNoErrors(component);
+    QAbstractListModel *flm = qobject_cast<QAbstractListModel*>(component.create());
+    QVERIFY(flm != 0);
+    flm->setProperty("folder", QUrl::fromLocalFile(dirPath));
+    QTRY_COMPARE(flm->property("count").toInt(), 3); // wait for refresh
+
+    QSignalSpy insertedSpy(flm, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy removedSpy(flm, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+
+    // Only the new file is inserted, the existing rows are left alone.
+    QVERIFY(touchFile(dirPath + QLatin1String("/b.qml")));
+    QTRY_COMPARE(flm->property("count").toInt(), 4);
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(insertedSpy.at(0).at(1).toInt(), 1);
+    QCOMPARE(insertedSpy.at(0).at(2).toInt(), 1);
+    QCOMPARE(flm->data(flm->index(1), FileNameRole).toString(), QLatin1String("b.qml"));
+
+    insertedSpy.clear();
+    QVERIFY(QFile::remove(dirPath + QLatin1String("/c.qml")));
+    QTRY_COMPARE(flm->property("count").toInt(), 3);
+    QCOMPARE(insertedSpy.count(), 0);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(removedSpy.at(0).at(1).toInt(), 2);
+    QCOMPARE(removedSpy.at(0).at(2).toInt(), 2);
+    QCOMPARE(flm->data(flm->index(2), FileNameRole).toString(), QLatin1String("e.qml"));
+
+    delete flm;
+}
+#endif
+
 QTEST_MAIN(tst_qquickfolderlistmodel)
 
 #include "tst_qquickfolderlistmodel.moc"
@@ -0,0 +1,11 @@
+CONFIG += testcase
+TARGET = tst_distancefielddiskcache
+macx:CONFIG   -= app_bundle
+
+SOURCES += tst_distancefielddiskcache.cpp
+
+TESTDATA = data/*
+
+CONFIG+=parallel_test
+
+QT += core-private gui-private quick-private testlib
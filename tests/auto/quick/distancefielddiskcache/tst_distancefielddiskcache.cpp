@@ -0,0 +1,195 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QRawFont>
+
+#include <QtQuick/private/qsgadaptationlayer_p.h>
+
+class tst_distancefielddiskcache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void saveAndLoad();
+    void saveAndLoadEmptyField();
+    void loadMissingGlyph();
+    void cachePathFollowsFont();
+    void prune();
+
+private:
+    QString copyFont(const QString &fileName);
+
+    QTemporaryDir m_cacheDir;
+    QTemporaryDir m_fontDir;
+    QString m_fontFile;
+};
+
+void tst_distancefielddiskcache::initTestCase()
+{
+    QVERIFY(m_cacheDir.isValid());
+    QVERIFY(m_fontDir.isValid());
+    qputenv("QSG_DISTANCEFIELD_CACHE_DIR", QFile::encodeName(m_cacheDir.path()));
+
+    m_fontFile = QFINDTESTDATA("data/font.ttf");
+    QVERIFY(!m_fontFile.isEmpty());
+}
+
+QString tst_distancefielddiskcache::copyFont(const QString &fileName)
+{
+    const QString copy = m_fontDir.path() + QLatin1Char('/') + fileName;
+    QFile::remove(copy);
+    if (!QFile::copy(m_fontFile, copy))
+        return QString();
+    return copy;
+}
+
+void tst_distancefielddiskcache::saveAndLoad()
+{
+    QRawFont font(m_fontFile, 32);
+    QVERIFY(font.isValid());
+    const QVector<quint32> glyphs = font.glyphIndexesForString(QStringLiteral("A"));
+    QCOMPARE(glyphs.size(), 1);
+
+    const QDistanceField field(font, glyphs.at(0), false);
+    QVERIFY(!field.isNull());
+    QVERIFY(field.width() > 0 && field.height() > 0);
+
+    const QString cachePath = m_cacheDir.path() + QLatin1String("/saveAndLoad");
+    QVERIFY(QSGDistanceFieldDiskCache::save(cachePath, glyphs.at(0), field));
+
+    QDistanceField loaded;
+    QVERIFY(QSGDistanceFieldDiskCache::load(cachePath, glyphs.at(0), &loaded));
+    QCOMPARE(loaded.width(), field.width());
+    QCOMPARE(loaded.height(), field.height());
+    QVERIFY(memcmp(loaded.constBits(), field.constBits(), field.width() * field.height()) == 0);
+}
+
+void tst_distancefielddiskcache::saveAndLoadEmptyField()
+{
+    // Glyphs without outline must be cached as well, rather than being
+    // generated again on every run.
+    const QString cachePath = m_cacheDir.path() + QLatin1String("/saveAndLoadEmptyField");
+    QVERIFY(QSGDistanceFieldDiskCache::save(cachePath, 3, QDistanceField()));
+
+    QDistanceField loaded;
+    QVERIFY(QSGDistanceFieldDiskCache::load(cachePath, 3, &loaded));
+    QCOMPARE(loaded.width(), 0);
+    QCOMPARE(loaded.height(), 0);
+}
+
+void tst_distancefielddiskcache::loadMissingGlyph()
+{
+    const QString cachePath = m_cacheDir.path() + QLatin1String("/loadMissingGlyph");
+    QDistanceField loaded;
+    QVERIFY(!QSGDistanceFieldDiskCache::load(cachePath, 5, &loaded));
+
+    // A truncated file is not a valid entry either
+    QVERIFY(QDir().mkpath(cachePath));
+    QFile file(cachePath + QLatin1String("/5"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("QSDF");
+    file.close();
+    QVERIFY(!QSGDistanceFieldDiskCache::load(cachePath, 5, &loaded));
+}
+
+void tst_distancefielddiskcache::cachePathFollowsFont()
+{
+    const QString fontFile = copyFont(QLatin1String("cachePathFollowsFont.ttf"));
+    QVERIFY(!fontFile.isEmpty());
+
+    QFontEngine::FaceId faceId;
+    faceId.filename = QFile::encodeName(fontFile);
+    faceId.index = 0;
+
+    const QString cachePath = QSGDistanceFieldDiskCache::cachePath(faceId, false);
+    QVERIFY(cachePath.startsWith(m_cacheDir.path() + QLatin1Char('/')));
+    QCOMPARE(QSGDistanceFieldDiskCache::cachePath(faceId, false), cachePath);
+
+    // Other distance field parameters and other faces use another directory
+    QVERIFY(QSGDistanceFieldDiskCache::cachePath(faceId, true) != cachePath);
+    QFontEngine::FaceId otherFace = faceId;
+    otherFace.index = 1;
+    QVERIFY(QSGDistanceFieldDiskCache::cachePath(otherFace, false) != cachePath);
+
+    // Changing the font file invalidates the cache
+    QFile file(fontFile);
+    QVERIFY(file.open(QIODevice::Append));
+    file.write(QByteArray(16, '\0'));
+    file.close();
+    QVERIFY(QSGDistanceFieldDiskCache::cachePath(faceId, false) != cachePath);
+
+    // Fonts without a file are not cached at all
+    QVERIFY(QFile::remove(fontFile));
+    QVERIFY(QSGDistanceFieldDiskCache::cachePath(faceId, false).isEmpty());
+    QVERIFY(QSGDistanceFieldDiskCache::cachePath(QFontEngine::FaceId(), false).isEmpty());
+}
+
+void tst_distancefielddiskcache::prune()
+{
+    QTemporaryDir root;
+    QVERIFY(root.isValid());
+    const QString oldPath = root.path() + QLatin1String("/old");
+    const QString ownPath = root.path() + QLatin1String("/own");
+
+    const QDistanceField field(16, 16);
+    for (glyph_t glyph = 0; glyph < 4; ++glyph) {
+        QVERIFY(QSGDistanceFieldDiskCache::save(oldPath, glyph, field));
+        QVERIFY(QSGDistanceFieldDiskCache::save(ownPath, glyph, field));
+    }
+
+    qint64 ownSize = 0;
+    foreach (const QFileInfo &glyphFile, QDir(ownPath).entryInfoList(QDir::Files))
+        ownSize += glyphFile.size();
+    QVERIFY(ownSize > 0);
+
+    // Within the limit nothing is removed
+    QVERIFY(QSGDistanceFieldDiskCache::prune(ownPath, 4 * ownSize));
+    QVERIFY(QFileInfo(oldPath).exists());
+
+    // Beyond the limit the other fonts make room
+    QVERIFY(QSGDistanceFieldDiskCache::prune(ownPath, ownSize + 1));
+    QVERIFY(!QFileInfo(oldPath).exists());
+    QVERIFY(QFileInfo(ownPath).exists());
+
+    // A font that exceeds the limit on its own is kept, but not written to
+    QVERIFY(!QSGDistanceFieldDiskCache::prune(ownPath, ownSize - 1));
+    QVERIFY(QFileInfo(ownPath).exists());
+}
+
+QTEST_MAIN(tst_distancefielddiskcache)
+
+#include "tst_distancefielddiskcache.moc"
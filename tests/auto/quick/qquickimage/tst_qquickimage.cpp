@@ -42,6 +42,7 @@
 #include <private/qquickimage_p.h>
 #include <private/qquickimagebase_p.h>
 #include <private/qquickloader_p.h>
+#include <private/qquickitem_p.h>
 #include <QtQml/qqmlcontext.h>
 #include <QtQml/qqmlexpression.h>
 #include <QtTest/QSignalSpy>
@@ -60,6 +61,38 @@ using namespace QQuickVisualTestUtil;
 
 Q_DECLARE_METATYPE(QQuickImageBase::Status)
 
+// Counts, for every frame, the images that have a texture.
+class TextureFrameLog : public QObject
+{
+    Q_OBJECT
+public:
+    TextureFrameLog(const QList<QQuickItem *> &onScreen, const QList<QQuickItem *> &offScreen)
+        : onScreen(onScreen), offScreen(offScreen) {}
+
+    QList<QQuickItem *> onScreen;
+    QList<QQuickItem *> offScreen;
+    QList<int> onScreenReady;
+    QList<int> offScreenReady;
+
+public slots:
+    void frameSwapped()
+    {
+        onScreenReady << ready(onScreen);
+        offScreenReady << ready(offScreen);
+    }
+
+private:
+    static int ready(const QList<QQuickItem *> &items)
+    {
+        int count = 0;
+        foreach (QQuickItem *item, items) {
+            if (QQuickItemPrivate::get(item)->paintNode)
+                ++count;
+        }
+        return count;
+    }
+};
+
 class tst_qquickimage : public QQmlDataTest
 {
     Q_OBJECT
@@ -97,6 +130,7 @@ private slots:
     void correctStatus();
     void highdpi();
     void hugeImages();
+    void uploadBudget();
 
 private:
     QQmlEngine engine;
@@ -992,6 +1026,51 @@ void tst_qquickimage::hugeImages()
     QCOMPARE(contents.pixel(199, 99), qRgba(0, 0, 255, 255));
 }
 
+void tst_qquickimage::uploadBudget()
+{
+    // The render context reads QSG_TEXTURE_UPLOAD_BUDGET when it is created.
+    QQML_TEST_IN_CHILD_PROCESS(QStringList() << QStringLiteral("QSG_RENDER_LOOP=basic")
+                                             << QStringLiteral("QSG_TEXTURE_UPLOAD_BUDGET=1"));
+
+    QQuickView view;
+    view.setSource(testFileUrl("uploadBudget.qml"));
+    QVERIFY(view.rootObject());
+
+    QList<QQuickItem *> onScreen;
+    QList<QQuickItem *> offScreen;
+    foreach (QQuickItem *item, view.rootObject()->childItems()) {
+        if (item->objectName() == QLatin1String("onScreen"))
+            onScreen << item;
+        else if (item->objectName() == QLatin1String("offScreen"))
+            offScreen << item;
+    }
+    QCOMPARE(onScreen.size(), 2);
+    QCOMPARE(offScreen.size(), 3);
+
+    TextureFrameLog log(onScreen, offScreen);
+    connect(&view, SIGNAL(frameSwapped()), &log, SLOT(frameSwapped()), Qt::DirectConnection);
+
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+    QTRY_VERIFY(!log.offScreenReady.isEmpty() && log.offScreenReady.last() == offScreen.size());
+
+    QCOMPARE(log.onScreenReady.last(), onScreen.size());
+    QVERIFY(log.offScreenReady.size() >= onScreen.size() + offScreen.size());
+
+    // The budget is smaller than any image, so at most one image gets its texture per frame,
+    // whether it is on screen or not.
+    QVERIFY(log.onScreenReady.first() + log.offScreenReady.first() <= 1);
+    for (int i = 1; i < log.offScreenReady.size(); ++i) {
+        const int onScreenCreated = log.onScreenReady.at(i) - log.onScreenReady.at(i - 1);
+        const int offScreenCreated = log.offScreenReady.at(i) - log.offScreenReady.at(i - 1);
+        QVERIFY(onScreenCreated + offScreenCreated <= 1);
+
+        // Images on screen whose textures were deferred come first in the following frames.
+        if (offScreenCreated > 0)
+            QCOMPARE(log.onScreenReady.at(i - 1), onScreen.size());
+    }
+}
+
 QTEST_MAIN(tst_qquickimage)
 
 #include "tst_qquickimage.moc"
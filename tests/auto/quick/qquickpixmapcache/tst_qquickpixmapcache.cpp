@@ -67,6 +67,8 @@ private slots:
 #endif
     void lockingCrash();
     void uncached();
+    void uploadFormat_data();
+    void uploadFormat();
 #if PIXMAP_DATA_LEAK_TEST
     void dataLeak();
 #endif
@@ -478,6 +480,39 @@ void tst_qquickpixmapcache::uncached()
     }
 }
 
+void tst_qquickpixmapcache::uploadFormat_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<bool>("converted");
+
+    // Images with full color are converted to a format the scene graph can upload as is,
+    // indexed and grayscale images keep their compact format.
+    QTest::newRow("argb") << "exists.png" << true;
+    QTest::newRow("indexed") << "indexed.png" << false;
+    QTest::newRow("grayscale") << "massive.png" << false;
+}
+
+void tst_qquickpixmapcache::uploadFormat()
+{
+    QFETCH(QString, file);
+    QFETCH(bool, converted);
+
+    const QImage decoded(testFile(file));
+    QVERIFY(!decoded.isNull());
+
+    QQmlEngine engine;
+    QQuickPixmap p;
+    p.load(&engine, testFileUrl(file), 0);
+    QVERIFY(p.isReady());
+
+    const QImage img = p.image();
+    QCOMPARE(img.size(), decoded.size());
+    if (converted)
+        QVERIFY(img.format() == QImage::Format_ARGB32_Premultiplied || img.format() == QImage::Format_RGB32);
+    else
+        QCOMPARE(img.format(), decoded.format());
+}
+
 
 #if PIXMAP_DATA_LEAK_TEST
 // This test should not be enabled by default as it
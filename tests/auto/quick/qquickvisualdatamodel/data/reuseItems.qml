@@ -0,0 +1,14 @@
+import QtQuick 2.0
+import QtQml.Models 2.3
+
+DelegateModel {
+    reuseItems: true
+    model: 10
+    delegate: Item {
+        property int modelIndex: index
+        property int pooledCount: 0
+        property int reusedCount: 0
+        DelegateModel.onPooled: ++pooledCount
+        DelegateModel.onReused: ++reusedCount
+    }
+}
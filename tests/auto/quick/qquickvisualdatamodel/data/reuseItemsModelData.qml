@@ -0,0 +1,28 @@
+import QtQuick 2.0
+import QtQml.Models 2.3
+
+DelegateModel {
+    reuseItems: true
+    model: ListModel {
+        ListElement { name: "one" }
+        ListElement { name: "two" }
+        ListElement { name: "three" }
+        ListElement { name: "four" }
+    }
+    delegate: Item {
+        property int modelIndex: index
+        property string modelName: model.name
+        property string nestedName: loader.item ? loader.item.nestedName : ""
+        property int itemsIndex: DelegateModel.itemsIndex
+        property bool inItems: DelegateModel.inItems
+        property int itemsIndexChanges: 0
+        DelegateModel.onItemsIndexChanged: ++itemsIndexChanges
+
+        Loader {
+            id: loader
+            sourceComponent: Item {
+                property string nestedName: name
+            }
+        }
+    }
+}
@@ -0,0 +1,10 @@
+import QtQuick 2.0
+import QtQml.Models 2.3
+
+DelegateModel {
+    reuseItems: true
+    model: 100
+    delegate: Item {
+        property int modelIndex: index
+    }
+}
@@ -0,0 +1,9 @@
+import QtQml.Models 2.2
+import QtQuick 2.0
+
+DelegateModel {
+    model: myModel
+    delegate: Item {
+        property string modelName: name
+    }
+}
@@ -0,0 +1,26 @@
+import QtQuick 2.0
+import QtQml.Models 2.3
+
+DelegateModel {
+    id: visualModel
+
+    groups: DelegateModelGroup { id: visibleGroup; name: "visible" }
+
+    model: ListModel {
+        ListElement { name: "d"; rank: 3; enabled: true }
+        ListElement { name: "b"; rank: 1; enabled: false }
+        ListElement { name: "e"; rank: 4; enabled: true }
+        ListElement { name: "a"; rank: 0; enabled: true }
+        ListElement { name: "c"; rank: 1; enabled: false }
+        ListElement { name: "f"; rank: 5; enabled: true }
+    }
+
+    delegate: Item {}
+
+    function names(group) {
+        var result = ""
+        for (var i = 0; i < group.count; ++i)
+            result += group.get(i).model.name
+        return result
+    }
+}
@@ -0,0 +1,14 @@
+import QtQuick 2.0
+import QtQml.Models 2.3
+
+DelegateModel {
+    model: myModel
+    delegate: Item {}
+
+    function ids() {
+        var result = ""
+        for (var i = 0; i < items.count; ++i)
+            result += items.get(i).model.toolTip
+        return result
+    }
+}
@@ -50,6 +50,7 @@
 #include <private/qqmlengine_p.h>
 #include <math.h>
 #include <QtGui/qstandarditemmodel.h>
+#include <QtCore/qregularexpression.h>
 
 using namespace QQuickVisualTestUtil;
 using namespace QQuickViewTestUtil;
@@ -238,6 +239,28 @@ private:
     Branch trunk;
 };
 
+class IncrementalModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    IncrementalModel() : rows(10), fetchMoreCount(0) {}
+
+    int rowCount(const QModelIndex &parent) const { return parent.isValid() ? 0 : rows; }
+    QVariant data(const QModelIndex &index, int role) const {
+        return role == Qt::DisplayRole ? QVariant(index.row()) : QVariant(); }
+
+    bool canFetchMore(const QModelIndex &parent) const { return !parent.isValid() && rows < 100; }
+    void fetchMore(const QModelIndex &) {
+        ++fetchMoreCount;
+        beginInsertRows(QModelIndex(), rows, rows + 9);
+        rows += 10;
+        endInsertRows();
+    }
+
+    int rows;
+    int fetchMoreCount;
+};
+
 class StandardItem : public QObject, public QStandardItem
 {
     Q_OBJECT
@@ -401,6 +424,7 @@ private slots:
     void qaimRowsMoved_data();
     void subtreeRowsMoved();
     void watchedRoles();
+    void roleNotifications();
     void hasModelChildren();
     void setValue();
     void remove_data();
@@ -430,6 +454,12 @@ private slots:
     void asynchronousMove_data();
     void asynchronousCancel();
     void invalidContext();
+    void reuseItems();
+    void reuseItemsModelData();
+    void reuseItemsPoolSize();
+    void fetchMoreThreshold();
+    void sortFilter();
+    void sortMixedTypes();
 
 private:
     template <int N> void groups_verify(
@@ -1287,6 +1317,48 @@ void tst_qquickvisualdatamodel::watchedRoles()
     QCOMPARE(changeSet.changes().at(0).count, 1);
 }
 
+void tst_qquickvisualdatamodel::roleNotifications()
+{
+    QaimModel model;
+    model.addItem("one", "1");
+    model.addItem("two", "2");
+
+    QQmlEngine engine;
+    engine.rootContext()->setContextProperty("myModel", &model);
+
+    QQmlComponent component(&engine, testFileUrl("roleNotifications.qml"));
+    QScopedPointer<QObject> object(component.create());
+    QQmlDelegateModel *vdm = qobject_cast<QQmlDelegateModel *>(object.data());
+    QVERIFY(vdm);
+
+    QQuickItem *item = qobject_cast<QQuickItem *>(vdm->object(1));
+    QVERIFY(item);
+    QCOMPARE(item->property("modelName").toString(), QStringLiteral("two"));
+
+    // Only the name role is bound, connecting to the number role later must still be notified.
+    QObject *modelData = qmlContext(item)->contextObject();
+    QVERIFY(modelData);
+    const QMetaObject *meta = modelData->metaObject();
+    const QMetaMethod numberChanged = meta->property(meta->indexOfProperty("number")).notifySignal();
+    QSignalSpy numberSpy(modelData, QByteArray("2" + numberChanged.methodSignature()).constData());
+    QVERIFY(numberSpy.isValid());
+
+    model.modifyItem(1, "changed", "2");
+    QCOMPARE(item->property("modelName").toString(), QStringLiteral("changed"));
+    QCOMPARE(numberSpy.count(), 1);
+
+    model.modifyItem(0, "first", "1");
+    QCOMPARE(numberSpy.count(), 1);
+
+    emit model.dataChanged(model.index(1), model.index(1), QVector<int>() << QaimModel::Name);
+    QCOMPARE(numberSpy.count(), 1);
+
+    emit model.dataChanged(model.index(1), model.index(1), QVector<int>() << QaimModel::Number);
+    QCOMPARE(numberSpy.count(), 2);
+
+    vdm->release(item);
+}
+
 void tst_qquickvisualdatamodel::hasModelChildren()
 {
     SingleRoleModel model(QStringList() << "one" << "two" << "three" << "four");
@@ -4236,6 +4308,249 @@ void tst_qquickvisualdatamodel::invalidContext()
     QVERIFY(!item);
 }
 
+void tst_qquickvisualdatamodel::reuseItems()
+{
+    QQmlEngine engine;
+    QQmlComponent c(&engine, testFileUrl("reuseItems.qml"));
+    QScopedPointer<QObject> object(c.create());
+    QQmlDelegateModel *visualModel = qobject_cast<QQmlDelegateModel *>(object.data());
+    QVERIFY(visualModel);
+    QVERIFY(visualModel->reuseItems());
+
+    QQuickItem *item = qobject_cast<QQuickItem *>(visualModel->object(2, false));
+    QVERIFY(item);
+    QCOMPARE(item->property("modelIndex").toInt(), 2);
+    QQmlGuard<QQuickItem> guard(item);
+
+    // A released item is pooled instead of destroyed.
+    QCOMPARE(visualModel->release(item), QQmlInstanceModel::ReleaseFlags(QQmlInstanceModel::Pooled));
+    QCOMPARE(item->property("pooledCount").toInt(), 1);
+    QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+    QVERIFY(guard);
+
+    // The pooled item is handed out for the next request, rebound to the new index.
+    QQuickItem *reused = qobject_cast<QQuickItem *>(visualModel->object(7, false));
+    QCOMPARE(reused, item);
+    QCOMPARE(reused->property("modelIndex").toInt(), 7);
+    QCOMPARE(reused->property("reusedCount").toInt(), 1);
+    QCOMPARE(visualModel->indexOf(reused, 0), 7);
+
+    // Disabling reuse destroys the pooled items.
+    QCOMPARE(visualModel->release(reused), QQmlInstanceModel::ReleaseFlags(QQmlInstanceModel::Pooled));
+    visualModel->setReuseItems(false);
+    QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+    QVERIFY(!guard);
+
+    item = qobject_cast<QQuickItem *>(visualModel->object(3, false));
+    QVERIFY(item);
+    QCOMPARE(visualModel->release(item), QQmlInstanceModel::ReleaseFlags(QQmlInstanceModel::Destroyed));
+}
+
+void tst_qquickvisualdatamodel::reuseItemsModelData()
+{
+    QQmlEngine engine;
+    QQmlComponent c(&engine, testFileUrl("reuseItemsModelData.qml"));
+    QScopedPointer<QObject> object(c.create());
+    QQmlDelegateModel *visualModel = qobject_cast<QQmlDelegateModel *>(object.data());
+    QVERIFY(visualModel);
+    QObject *listModel = visualModel->model().value<QObject *>();
+    QVERIFY(listModel);
+
+    QQuickItem *item = qobject_cast<QQuickItem *>(visualModel->object(1, false));
+    QVERIFY(item);
+    QCOMPARE(item->property("modelName").toString(), QString("two"));
+    QCOMPARE(item->property("nestedName").toString(), QString("two"));
+    QCOMPARE(item->property("itemsIndex").toInt(), 1);
+    QCOMPARE(item->property("inItems").toBool(), true);
+
+    // A pooled item no longer belongs to any group.
+    QCOMPARE(visualModel->release(item), QQmlInstanceModel::ReleaseFlags(QQmlInstanceModel::Pooled));
+    QCOMPARE(item->property("inItems").toBool(), false);
+
+    // The reused item shows the data of its new row, in nested contexts as well.
+    QQuickItem *reused = qobject_cast<QQuickItem *>(visualModel->object(3, false));
+    QCOMPARE(reused, item);
+    QCOMPARE(reused->property("modelIndex").toInt(), 3);
+    QCOMPARE(reused->property("modelName").toString(), QString("four"));
+    QCOMPARE(reused->property("nestedName").toString(), QString("four"));
+    QCOMPARE(reused->property("itemsIndex").toInt(), 3);
+    QCOMPARE(reused->property("inItems").toBool(), true);
+
+    // Changes to the previous row no longer reach the reused item, changes to the new row do.
+    QVERIFY(QMetaObject::invokeMethod(listModel, "setProperty",
+            Q_ARG(int, 1), Q_ARG(QString, "name"), Q_ARG(QVariant, QVariant(QString("changed")))));
+    QCOMPARE(reused->property("modelName").toString(), QString("four"));
+    QCOMPARE(reused->property("nestedName").toString(), QString("four"));
+
+    QVERIFY(QMetaObject::invokeMethod(listModel, "setProperty",
+            Q_ARG(int, 3), Q_ARG(QString, "name"), Q_ARG(QVariant, QVariant(QString("FOUR")))));
+    QCOMPARE(reused->property("modelName").toString(), QString("FOUR"));
+    QCOMPARE(reused->property("nestedName").toString(), QString("FOUR"));
+
+    // Indexes are notified on reuse even if they equal those of the previous row.
+    const int itemsIndexChanges = reused->property("itemsIndexChanges").toInt();
+    QCOMPARE(visualModel->release(reused), QQmlInstanceModel::ReleaseFlags(QQmlInstanceModel::Pooled));
+    QCOMPARE(visualModel->object(3, false), static_cast<QObject *>(item));
+    QCOMPARE(item->property("itemsIndex").toInt(), 3);
+    QCOMPARE(item->property("itemsIndexChanges").toInt(), itemsIndexChanges + 1);
+
+    visualModel->release(item);
+}
+
+void tst_qquickvisualdatamodel::reuseItemsPoolSize()
+{
+    QQmlEngine engine;
+    QQmlComponent c(&engine, testFileUrl("reuseItemsPoolSize.qml"));
+    QScopedPointer<QObject> object(c.create());
+    QQmlDelegateModel *visualModel = qobject_cast<QQmlDelegateModel *>(object.data());
+    QVERIFY(visualModel);
+
+    QList<QQuickItem *> items;
+    QList<QQmlGuard<QQuickItem> > guards;
+    for (int i = 0; i < 40; ++i) {
+        QQuickItem *item = qobject_cast<QQuickItem *>(visualModel->object(i, false));
+        QVERIFY(item);
+        items << item;
+        guards << QQmlGuard<QQuickItem>(item);
+    }
+
+    // Shrink to a single item in use. Every release pools the item, but the pool never
+    // grows beyond the number of items in use, or 16 if fewer are in use.
+    for (int i = 0; i < 39; ++i)
+        QCOMPARE(visualModel->release(items.at(i)), QQmlInstanceModel::ReleaseFlags(QQmlInstanceModel::Pooled));
+    QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+
+    // The items pooled longest were destroyed.
+    for (int i = 0; i < 23; ++i)
+        QVERIFY2(!guards.at(i), qPrintable(QString::number(i)));
+    for (int i = 23; i < 40; ++i)
+        QVERIFY2(guards.at(i), qPrintable(QString::number(i)));
+
+    // The pooled items are still reused, most recently released first.
+    QQuickItem *reused = qobject_cast<QQuickItem *>(visualModel->object(50, false));
+    QCOMPARE(reused, items.at(38));
+    QCOMPARE(reused->property("modelIndex").toInt(), 50);
+}
+
+void tst_qquickvisualdatamodel::fetchMoreThreshold()
+{
+    IncrementalModel model;
+
+    QQmlEngine engine;
+    engine.rootContext()->setContextProperty("myModel", &model);
+
+    QQmlComponent component(&engine, testFileUrl("visualdatamodel.qml"));
+    QScopedPointer<QObject> object(component.create());
+    QQmlDelegateModel *vdm = qobject_cast<QQmlDelegateModel *>(object.data());
+    QVERIFY(vdm);
+    QCOMPARE(vdm->fetchMoreThreshold(), 0);
+
+    // More data is requested once the model is complete.
+    QCoreApplication::sendPostedEvents(vdm, QEvent::UpdateRequest);
+    QCOMPARE(model.fetchMoreCount, 1);
+    QCOMPARE(vdm->count(), 20);
+
+    QObject *item = vdm->object(18);
+    QVERIFY(item);
+    vdm->release(item);
+    QCoreApplication::sendPostedEvents(vdm, QEvent::UpdateRequest);
+    QCOMPARE(model.fetchMoreCount, 1);
+
+    item = vdm->object(19);
+    vdm->release(item);
+    QCoreApplication::sendPostedEvents(vdm, QEvent::UpdateRequest);
+    QCOMPARE(model.fetchMoreCount, 2);
+    QCOMPARE(vdm->count(), 30);
+
+    // With a threshold more data is requested ahead of the end, once per event loop iteration.
+    QSignalSpy thresholdSpy(vdm, SIGNAL(fetchMoreThresholdChanged()));
+    vdm->setFetchMoreThreshold(5);
+    QCOMPARE(thresholdSpy.count(), 1);
+
+    item = vdm->object(23);
+    vdm->release(item);
+    QCoreApplication::sendPostedEvents(vdm, QEvent::UpdateRequest);
+    QCOMPARE(model.fetchMoreCount, 2);
+
+    for (int i = 24; i < 30; ++i) {
+        item = vdm->object(i);
+        vdm->release(item);
+    }
+    QCoreApplication::sendPostedEvents(vdm, QEvent::UpdateRequest);
+    QCOMPARE(model.fetchMoreCount, 3);
+    QCOMPARE(vdm->count(), 40);
+
+    QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+}
+
+void tst_qquickvisualdatamodel::sortFilter()
+{
+    QQmlEngine engine;
+    QQmlComponent c(&engine, testFileUrl("sortFilter.qml"));
+    QScopedPointer<QObject> object(c.create());
+    QQmlDelegateModel *visualModel = qobject_cast<QQmlDelegateModel *>(object.data());
+    QVERIFY(visualModel);
+
+    QSignalSpy changedSpy(visualModel->items(), SIGNAL(changed(QQmlV4Handle,QQmlV4Handle)));
+
+    QCOMPARE(evaluate<QString>(visualModel, "names(items)"), QStringLiteral("dbeacf"));
+
+    // Items with equal values keep their order and all moves are reported as a single change.
+    evaluate<void>(visualModel, "items.sort(\"rank\")");
+    QCOMPARE(evaluate<QString>(visualModel, "names(items)"), QStringLiteral("abcdef"));
+    QCOMPARE(changedSpy.count(), 1);
+
+    evaluate<void>(visualModel, "items.sort(\"name\", Qt.DescendingOrder)");
+    QCOMPARE(evaluate<QString>(visualModel, "names(items)"), QStringLiteral("fedcba"));
+    QCOMPARE(changedSpy.count(), 2);
+
+    // Sorting a sorted group changes nothing.
+    evaluate<void>(visualModel, "items.sort(\"name\", Qt.DescendingOrder)");
+    QCOMPARE(changedSpy.count(), 2);
+
+    // Filtered items follow the order of the items group.
+    evaluate<void>(visualModel, "visibleGroup.filter(\"enabled\")");
+    QCOMPARE(evaluate<QString>(visualModel, "names(visibleGroup)"), QStringLiteral("feda"));
+
+    evaluate<void>(visualModel, "model.setProperty(0, \"enabled\", false); model.setProperty(4, \"enabled\", true)");
+    evaluate<void>(visualModel, "visibleGroup.filter(\"enabled\")");
+    QCOMPARE(evaluate<QString>(visualModel, "names(visibleGroup)"), QStringLiteral("feca"));
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("filter: the items group cannot be filtered$"));
+    evaluate<void>(visualModel, "items.filter(\"enabled\")");
+    QCOMPARE(evaluate<QString>(visualModel, "names(items)"), QStringLiteral("fedcba"));
+}
+
+void tst_qquickvisualdatamodel::sortMixedTypes()
+{
+    QStandardItemModel model;
+    const QVariant values[] = {
+        QVariant(QStringLiteral("b")), QVariant(3), QVariant(), QVariant(1.5), QVariant(true),
+        QVariant(QStringLiteral("a")), QVariant(2), QVariant(false), QVariant(qQNaN())
+    };
+    const char ids[] = "abcdefghi";
+    for (int i = 0; i < 9; ++i) {
+        QStandardItem *item = new QStandardItem;
+        item->setData(values[i], Qt::DisplayRole);
+        item->setData(QString(QLatin1Char(ids[i])), Qt::ToolTipRole);
+        model.appendRow(item);
+    }
+
+    QQmlEngine engine;
+    engine.rootContext()->setContextProperty("myModel", &model);
+    QQmlComponent c(&engine, testFileUrl("sortMixedTypes.qml"));
+    QScopedPointer<QObject> object(c.create());
+    QQmlDelegateModel *visualModel = qobject_cast<QQmlDelegateModel *>(object.data());
+    QVERIFY(visualModel);
+
+    // Ordered by type first: no value, booleans, numbers with NaN first, strings.
+    evaluate<void>(visualModel, "items.sort(\"display\")");
+    QCOMPARE(evaluate<QString>(visualModel, "ids()"), QStringLiteral("chei" "dgb" "fa"));
+
+    evaluate<void>(visualModel, "items.sort(\"display\", Qt.DescendingOrder)");
+    QCOMPARE(evaluate<QString>(visualModel, "ids()"), QStringLiteral("af" "bgd" "iehc"));
+}
+
 QTEST_MAIN(tst_qquickvisualdatamodel)
 
 #include "tst_qquickvisualdatamodel.moc"
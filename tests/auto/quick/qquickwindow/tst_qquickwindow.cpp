@@ -47,8 +47,10 @@
 #include <QSignalSpy>
 #include <qpa/qwindowsysteminterface.h>
 #include <private/qquickwindow_p.h>
+#include <private/qsgrenderloop_p.h>
 #include <private/qguiapplication_p.h>
 #include <QRunnable>
+#include <QPropertyAnimation>
 
 struct TouchEventData {
     QEvent::Type type;
@@ -273,6 +275,88 @@ protected:
     }
 };
 
+// Records the frame timings of a window after each swap.
+class FrameTimingsRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    FrameTimingsRecorder(QQuickWindow *window) : m_window(window) { }
+
+    QList<QSGFrameTimings> timings()
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_timings;
+    }
+
+public slots:
+    // Called on the render thread. Taking a while after the swap gives the
+    // GUI thread time to post its next sync before the render thread looks
+    // at its events again, which is when that sync gets latched.
+    void frameSwapped()
+    {
+        const QSGFrameTimings timings = QSGRenderLoop::instance()->frameTimings(m_window);
+        {
+            QMutexLocker locker(&m_mutex);
+            m_timings << timings;
+        }
+        QThread::msleep(20);
+    }
+
+private:
+    QQuickWindow *m_window;
+    QMutex m_mutex;
+    QList<QSGFrameTimings> m_timings;
+};
+
+// Logs the scene graph signals of windows, which are emitted on the render thread.
+class SceneGraphSignalLog : public QObject
+{
+    Q_OBJECT
+public:
+    void watch(QQuickWindow *window)
+    {
+        connect(window, SIGNAL(sceneGraphInitialized()), this, SLOT(initialized()), Qt::DirectConnection);
+        connect(window, SIGNAL(sceneGraphInvalidated()), this, SLOT(invalidated()), Qt::DirectConnection);
+        connect(window, SIGNAL(afterRendering()), this, SLOT(rendered()), Qt::DirectConnection);
+    }
+
+    // The log of one window, with consecutive frames collapsed into one entry.
+    QStringList log(const QString &window)
+    {
+        QMutexLocker locker(&m_mutex);
+        QStringList result;
+        foreach (const QString &entry, m_log) {
+            if (!entry.startsWith(window + QLatin1Char(' ')))
+                continue;
+            const QString event = entry.mid(window.size() + 1);
+            if (result.isEmpty() || result.last() != event || event != QLatin1String("rendered"))
+                result << event;
+        }
+        return result;
+    }
+
+    int count(const QString &window, const QString &event)
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_log.count(window + QLatin1Char(' ') + event);
+    }
+
+public slots:
+    void initialized() { add(QStringLiteral("initialized")); }
+    void invalidated() { add(QStringLiteral("invalidated")); }
+    void rendered() { add(QStringLiteral("rendered")); }
+
+private:
+    void add(const QString &event)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_log << sender()->objectName() + QLatin1Char(' ') + event;
+    }
+
+    QMutex m_mutex;
+    QStringList m_log;
+};
+
 class tst_qquickwindow : public QQmlDataTest
 {
     Q_OBJECT
@@ -369,10 +453,19 @@ private slots:
     void attachedProperty();
 
     void testRenderJob();
+    void frameTimings();
+    void pipelinedSyncOverlapsSwap();
+
+    void sharedRenderThreadLateWindow();
+    void sharedRenderThreadHideWindow();
+    void sharedRenderThreadDeleteWindow();
+    void sharedRenderThreadOneVsyncPerPass();
 
     void testHoverChildMouseEventFilter();
     void testHoverTimestamp();
 private:
+    QQuickWindow *createLoggedWindow(const QString &name, SceneGraphSignalLog *log, int x);
+
     QTouchDevice *touchDevice;
     QTouchDevice *touchDeviceWithVelocity;
 };
@@ -2223,6 +2316,248 @@ private:
     QMap<QEvent::Type, int> m_eventCount;
 };
 
+void tst_qquickwindow::frameTimings()
+{
+    QQuickWindow window;
+    window.setTitle(QTest::currentTestFunction());
+    window.resize(100, 100);
+
+    QQuickRectangle *rect = new QQuickRectangle(window.contentItem());
+    rect->setSize(QSizeF(50, 50));
+    rect->setColor(Qt::red);
+
+    QSignalSpy swapSpy(&window, SIGNAL(frameSwapped()));
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QTRY_VERIFY(swapSpy.size() > 0);
+
+    QSGFrameTimings timings = QSGRenderLoop::instance()->frameTimings(&window);
+    if (!timings.isValid())
+        QSKIP("The render loop does not report frame timings");
+
+    QVERIFY(timings.polishStart <= timings.polishEnd);
+    QVERIFY(timings.syncStart > 0);
+    QVERIFY(timings.syncStart <= timings.syncEnd);
+    QVERIFY(timings.syncEnd <= timings.renderStart);
+    QVERIFY(timings.renderStart <= timings.renderEnd);
+    QVERIFY(timings.renderEnd <= timings.swapEnd);
+}
+
+void tst_qquickwindow::pipelinedSyncOverlapsSwap()
+{
+    // The render loop reads QSG_PIPELINED_SYNC when it is first used.
+    QQML_TEST_IN_CHILD_PROCESS(QStringList() << QStringLiteral("QSG_RENDER_LOOP=threaded")
+                                             << QStringLiteral("QSG_PIPELINED_SYNC=1"));
+
+    QQuickWindow window;
+    window.setTitle(QTest::currentTestFunction());
+    window.resize(100, 100);
+
+    QQuickRectangle *rect = new QQuickRectangle(window.contentItem());
+    rect->setSize(QSizeF(50, 50));
+    rect->setColor(Qt::red);
+
+    if (!QSGRenderLoop::instance()->inherits("QSGThreadedRenderLoop"))
+        QSKIP("Pipelined sync is only done by the threaded render loop");
+
+    FrameTimingsRecorder recorder(&window);
+    connect(&window, SIGNAL(frameSwapped()), &recorder, SLOT(frameSwapped()), Qt::DirectConnection);
+
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    // Keep the GUI thread asking for new frames.
+    QPropertyAnimation animation(rect, "x");
+    animation.setStartValue(0);
+    animation.setEndValue(50);
+    animation.setDuration(500);
+    animation.setLoopCount(-1);
+    animation.start();
+
+    QTRY_VERIFY_WITH_TIMEOUT(recorder.timings().size() > 20, 10000);
+    animation.stop();
+
+    const QList<QSGFrameTimings> timings = recorder.timings();
+    if (!timings.first().isValid())
+        QSKIP("The render loop does not report frame timings");
+
+    // A frame synced ahead was synced before the previous frame was swapped.
+    // The first frames come from the expose, which never syncs ahead.
+    int pairs = 0;
+    int overlapping = 0;
+    for (int i = 2; i < timings.size() - 1; ++i) {
+        ++pairs;
+        if (timings.at(i + 1).syncEnd <= timings.at(i).swapEnd)
+            ++overlapping;
+    }
+    QVERIFY2(overlapping * 3 >= pairs * 2,
+             qPrintable(QString::fromLatin1("%1 of %2 frames were synced ahead").arg(overlapping).arg(pairs)));
+}
+
+// The render loop reads QSG_SHARED_RENDER_THREAD when it is first used, so
+// these tests run in child processes with the variable set.
+#define SHARED_RENDER_THREAD_TEST() \
+    do { \
+        QQML_TEST_IN_CHILD_PROCESS(QStringList() << QStringLiteral("QSG_RENDER_LOOP=threaded") \
+                                                 << QStringLiteral("QSG_SHARED_RENDER_THREAD=1")); \
+        if (!QSGRenderLoop::instance()->inherits("QSGThreadedRenderLoop")) \
+            QSKIP("The threaded render loop is not in use"); \
+        QVERIFY(QSGRenderLoop::instance()->sharesRenderContext()); \
+    } while (false)
+
+QQuickWindow *tst_qquickwindow::createLoggedWindow(const QString &name, SceneGraphSignalLog *log, int x)
+{
+    QQuickWindow *window = new QQuickWindow;
+    window->setObjectName(name);
+    window->setGeometry(x, 100, 100, 100);
+    log->watch(window);
+    return window;
+}
+
+// A window shown after the render context was initialized for another one
+// still gets its own sceneGraphInitialized(), and the other one does not get
+// a second one.
+void tst_qquickwindow::sharedRenderThreadLateWindow()
+{
+    SHARED_RENDER_THREAD_TEST();
+
+    SceneGraphSignalLog log;
+    QScopedPointer<QQuickWindow> first(createLoggedWindow("first", &log, 100));
+    first->show();
+    QVERIFY(QTest::qWaitForWindowExposed(first.data()));
+    QTRY_VERIFY(log.count("first", "rendered") > 0);
+
+    QScopedPointer<QQuickWindow> second(createLoggedWindow("second", &log, 250));
+    second->show();
+    QVERIFY(QTest::qWaitForWindowExposed(second.data()));
+    QTRY_VERIFY(log.count("second", "rendered") > 0);
+
+    QCOMPARE(log.log("first"), QStringList() << "initialized" << "rendered");
+    QCOMPARE(log.log("second"), QStringList() << "initialized" << "rendered");
+}
+
+// Hiding one window releases its scene graph only, the other one keeps
+// rendering without being invalidated.
+void tst_qquickwindow::sharedRenderThreadHideWindow()
+{
+    SHARED_RENDER_THREAD_TEST();
+
+    SceneGraphSignalLog log;
+    QScopedPointer<QQuickWindow> first(createLoggedWindow("first", &log, 100));
+    QScopedPointer<QQuickWindow> second(createLoggedWindow("second", &log, 250));
+    second->setPersistentSceneGraph(false);
+    first->show();
+    second->show();
+    QVERIFY(QTest::qWaitForWindowExposed(first.data()));
+    QVERIFY(QTest::qWaitForWindowExposed(second.data()));
+    QTRY_VERIFY(log.count("first", "rendered") > 0);
+    QTRY_VERIFY(log.count("second", "rendered") > 0);
+
+    second->hide();
+    QTRY_COMPARE(log.count("second", "invalidated"), 1);
+
+    const int frames = log.count("first", "rendered");
+    first->update();
+    QTRY_VERIFY(log.count("first", "rendered") > frames);
+    QCOMPARE(log.count("first", "invalidated"), 0);
+
+    second->show();
+    QVERIFY(QTest::qWaitForWindowExposed(second.data()));
+    QTRY_COMPARE(log.count("second", "initialized"), 2);
+    QTRY_VERIFY(log.log("second").endsWith("rendered"));
+
+    QCOMPARE(log.log("first"), QStringList() << "initialized" << "rendered");
+    QCOMPARE(log.log("second"), QStringList() << "initialized" << "rendered"
+                                              << "invalidated"
+                                              << "initialized" << "rendered");
+}
+
+// Deleting one window invalidates its scene graph only. Deleting the last
+// one invalidates the shared one.
+void tst_qquickwindow::sharedRenderThreadDeleteWindow()
+{
+    SHARED_RENDER_THREAD_TEST();
+
+    SceneGraphSignalLog log;
+    QQuickWindow *first = createLoggedWindow("first", &log, 100);
+    QQuickWindow *second = createLoggedWindow("second", &log, 250);
+    first->show();
+    second->show();
+    QVERIFY(QTest::qWaitForWindowExposed(first));
+    QVERIFY(QTest::qWaitForWindowExposed(second));
+    QTRY_VERIFY(log.count("first", "rendered") > 0);
+    QTRY_VERIFY(log.count("second", "rendered") > 0);
+
+    delete second;
+    QCOMPARE(log.count("second", "invalidated"), 1);
+    QCOMPARE(log.count("first", "invalidated"), 0);
+
+    const int frames = log.count("first", "rendered");
+    first->update();
+    QTRY_VERIFY(log.count("first", "rendered") > frames);
+
+    delete first;
+    QCOMPARE(log.log("first"), QStringList() << "initialized" << "rendered" << "invalidated");
+    QCOMPARE(log.log("second"), QStringList() << "initialized" << "rendered" << "invalidated");
+}
+
+// Only the first window waits for vertical sync, so that a pass over all
+// windows with changes presents each of them within one frame, instead of
+// taking one frame per window.
+void tst_qquickwindow::sharedRenderThreadOneVsyncPerPass()
+{
+    SHARED_RENDER_THREAD_TEST();
+
+    const int windowCount = 4;
+    SceneGraphSignalLog log;
+    QScopedPointer<QQuickWindow> windows[windowCount];
+    for (int i = 0; i < windowCount; ++i) {
+        windows[i].reset(createLoggedWindow(QString::fromLatin1("window%1").arg(i), &log, 100 + 150 * i));
+        if (i > 0)
+            QCOMPARE(windows[i]->requestedFormat().swapInterval(), 0);
+
+        QQuickRectangle *rect = new QQuickRectangle(windows[i]->contentItem());
+        rect->setSize(QSizeF(50, 50));
+        rect->setColor(Qt::red);
+
+        // Keep every window changing in every frame.
+        QPropertyAnimation *animation = new QPropertyAnimation(rect, "x", rect);
+        animation->setStartValue(0);
+        animation->setEndValue(50);
+        animation->setDuration(500);
+        animation->setLoopCount(-1);
+        animation->start();
+
+        windows[i]->show();
+    }
+    for (int i = 0; i < windowCount; ++i) {
+        QVERIFY(QTest::qWaitForWindowExposed(windows[i].data()));
+        QTRY_VERIFY(log.count(windows[i]->objectName(), "rendered") > 0);
+    }
+
+    int startFrames[windowCount];
+    for (int i = 0; i < windowCount; ++i)
+        startFrames[i] = log.count(windows[i]->objectName(), "rendered");
+    QElapsedTimer timer;
+    timer.start();
+    QTest::qWait(1000);
+    const qint64 elapsed = timer.elapsed();
+
+    qreal refreshRate = windows[0]->screen()->refreshRate();
+    if (refreshRate < 1)
+        refreshRate = 60;
+    const int frames = int(elapsed * refreshRate / 1000);
+
+    // Waiting for vertical sync once per window would give each window a
+    // quarter of the frames.
+    for (int i = 0; i < windowCount; ++i) {
+        const int rendered = log.count(windows[i]->objectName(), "rendered") - startFrames[i];
+        QVERIFY2(rendered * 2 >= frames,
+                 qPrintable(QString::fromLatin1("%1 rendered %2 of %3 frames")
+                            .arg(windows[i]->objectName()).arg(rendered).arg(frames)));
+    }
+}
+
 void tst_qquickwindow::testHoverChildMouseEventFilter()
 {
     QQuickWindow window;
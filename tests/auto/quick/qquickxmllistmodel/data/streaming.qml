@@ -0,0 +1,14 @@
+import QtQuick 2.0
+import QtQuick.XmlListModel 2.0
+
+XmlListModel {
+    xml: "<feed>"
+       + "<entry id=\"1\"><title>One</title><tag>a</tag><tag>b</tag></entry>"
+       + "<entry><title>Two <b>bold</b></title><tag>c</tag></entry>"
+       + "<other><entry id=\"9\"><title>Nested</title></entry></other>"
+       + "<entry id=\"3\"><title><![CDATA[<Three>]]></title><tag>d</tag><tag>e &amp; f</tag></entry>"
+       + "</feed>"
+    XmlRole { name: "title"; query: "title/string()" }
+    XmlRole { name: "id"; query: "@id/number()" }
+    XmlRole { name: "secondTag"; query: "tag[2]/string()" }
+}
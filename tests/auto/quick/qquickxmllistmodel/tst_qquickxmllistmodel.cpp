@@ -100,6 +100,8 @@ private slots:
 
     void roleCrash();
     void proxyCrash();
+    void streaming_data();
+    void streaming();
 
 private:
     QString errorString(QAbstractItemModel *model) {
@@ -982,6 +984,57 @@ void tst_qquickxmllistmodel::roleCrash()
     delete model;
 }
 
+void tst_qquickxmllistmodel::streaming_data()
+{
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<QStringList>("titles");
+    QTest::addColumn<QVariantList>("ids");
+    QTest::addColumn<QStringList>("secondTags");
+
+    QTest::newRow("path")
+            << "/feed/entry"
+            << (QStringList() << "One" << "Two bold" << "<Three>")
+            << (QVariantList() << 1.0 << QString() << 3.0)
+            << (QStringList() << "b" << "" << "e & f");
+    QTest::newRow("position")
+            << "/feed/entry[2]"
+            << (QStringList() << "Two bold")
+            << (QVariantList() << QString())
+            << (QStringList() << "");
+    QTest::newRow("nested")
+            << "/feed/other/entry"
+            << (QStringList() << "Nested")
+            << (QVariantList() << 9.0)
+            << (QStringList() << "");
+    // Not supported by the streaming parser, evaluated with QXmlQuery instead.
+    QTest::newRow("predicate")
+            << "/feed/entry[@id = 3]"
+            << (QStringList() << "<Three>")
+            << (QVariantList() << 3.0)
+            << (QStringList() << "e & f");
+}
+
+void tst_qquickxmllistmodel::streaming()
+{
+    QFETCH(QString, query);
+    QFETCH(QStringList, titles);
+    QFETCH(QVariantList, ids);
+    QFETCH(QStringList, secondTags);
+
+    QQmlComponent component(&engine, testFileUrl("streaming.qml"));
+    QScopedPointer<QAbstractItemModel> model(qobject_cast<QAbstractItemModel *>(component.create()));
+    QVERIFY(model != 0);
+    model->setProperty("query", query);
+    QTRY_COMPARE(model->rowCount(), titles.count());
+
+    for (int i = 0; i < titles.count(); ++i) {
+        const QModelIndex index = model->index(i, 0);
+        QCOMPARE(model->data(index, Qt::UserRole).toString(), titles.at(i));
+        QCOMPARE(model->data(index, Qt::UserRole + 1), ids.at(i));
+        QCOMPARE(model->data(index, Qt::UserRole + 2).toString(), secondTags.at(i));
+    }
+}
+
 class SortFilterProxyModel : public QSortFilterProxyModel
 {
     Q_OBJECT
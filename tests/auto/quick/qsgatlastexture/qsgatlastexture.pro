@@ -0,0 +1,9 @@
+CONFIG += testcase
+TARGET = tst_qsgatlastexture
+macx:CONFIG   -= app_bundle
+
+SOURCES += tst_qsgatlastexture.cpp
+
+CONFIG+=parallel_test
+
+QT += core-private gui-private quick-private testlib
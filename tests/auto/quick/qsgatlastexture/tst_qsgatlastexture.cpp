@@ -0,0 +1,192 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLContext>
+
+#include <QtQuick/private/qsgatlastexture_p.h>
+
+// Images of this size take a quarter of a 64x64 page, including padding.
+static const int imageSize = 30;
+
+class tst_qsgatlastexture : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void pageOverflow();
+    void tooLarge();
+    void releaseEmptyPages();
+    void keepFirstPage();
+
+private:
+    QSGTexture *create(int size = imageSize);
+
+    QOffscreenSurface m_surface;
+    QOpenGLContext m_context;
+    QSGAtlasTexture::Manager *m_manager;
+    QList<QSGTexture *> m_textures;
+};
+
+void tst_qsgatlastexture::initTestCase()
+{
+    qputenv("QSG_ATLAS_WIDTH", "64");
+    qputenv("QSG_ATLAS_HEIGHT", "64");
+    qputenv("QSG_ATLAS_MAX_PAGES", "2");
+
+    m_surface.create();
+    if (!m_context.create() || !m_context.makeCurrent(&m_surface))
+        QSKIP("OpenGL context creation failed");
+}
+
+void tst_qsgatlastexture::init()
+{
+    m_manager = new QSGAtlasTexture::Manager;
+}
+
+void tst_qsgatlastexture::cleanup()
+{
+    qDeleteAll(m_textures);
+    m_textures.clear();
+    m_manager->invalidate();
+    delete m_manager;
+    m_manager = 0;
+}
+
+QSGTexture *tst_qsgatlastexture::create(int size)
+{
+    QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::red);
+    QSGTexture *t = m_manager->create(image, true);
+    if (t)
+        m_textures << t;
+    return t;
+}
+
+void tst_qsgatlastexture::pageOverflow()
+{
+    for (int i = 0; i < 4; ++i)
+        QVERIFY(create());
+
+    QSGAtlasTexture::Manager::Stats stats = m_manager->stats();
+    QCOMPARE(stats.pages, 1);
+    QCOMPARE(stats.textures, 4);
+    QCOMPARE(stats.usedArea, qint64(64 * 64));
+    QCOMPARE(stats.totalArea, qint64(64 * 64));
+
+    // The first page is full, the next texture goes to a new page
+    QSGTexture *t = create();
+    QVERIFY(t);
+    QVERIFY(t->isAtlasTexture());
+    QVERIFY(t->textureId() != m_textures.first()->textureId());
+
+    stats = m_manager->stats();
+    QCOMPARE(stats.pages, 2);
+    QCOMPARE(stats.textures, 5);
+    QCOMPARE(stats.totalArea, qint64(2 * 64 * 64));
+
+    for (int i = 0; i < 3; ++i)
+        QVERIFY(create());
+
+    // All pages are full and no more may be added
+    QVERIFY(!create());
+
+    stats = m_manager->stats();
+    QCOMPARE(stats.pages, 2);
+    QCOMPARE(stats.textures, 8);
+    QCOMPARE(stats.usedArea, stats.totalArea);
+    QCOMPARE(stats.atlasFullFallbacks, 1);
+    QCOMPARE(stats.tooLargeFallbacks, 0);
+}
+
+void tst_qsgatlastexture::tooLarge()
+{
+    // The default size limit is half of the atlas size
+    QVERIFY(!create(32));
+
+    QSGAtlasTexture::Manager::Stats stats = m_manager->stats();
+    QCOMPARE(stats.pages, 0);
+    QCOMPARE(stats.textures, 0);
+    QCOMPARE(stats.tooLargeFallbacks, 1);
+    QCOMPARE(stats.atlasFullFallbacks, 0);
+}
+
+void tst_qsgatlastexture::releaseEmptyPages()
+{
+    for (int i = 0; i < 5; ++i)
+        QVERIFY(create());
+    QCOMPARE(m_manager->stats().pages, 2);
+
+    // Make room on the first page and empty the second one
+    delete m_textures.takeLast();
+    delete m_textures.takeFirst();
+
+    QSGAtlasTexture::Manager::Stats stats = m_manager->stats();
+    QCOMPARE(stats.pages, 2);
+    QCOMPARE(stats.textures, 3);
+
+    // Empty pages are released when the next texture is created
+    QVERIFY(create());
+
+    stats = m_manager->stats();
+    QCOMPARE(stats.pages, 1);
+    QCOMPARE(stats.textures, 4);
+    QCOMPARE(stats.releasedPages, 1);
+    QCOMPARE(stats.atlasFullFallbacks, 0);
+}
+
+void tst_qsgatlastexture::keepFirstPage()
+{
+    QVERIFY(create());
+    qDeleteAll(m_textures);
+    m_textures.clear();
+
+    QCOMPARE(m_manager->stats().textures, 0);
+
+    QVERIFY(create());
+
+    QSGAtlasTexture::Manager::Stats stats = m_manager->stats();
+    QCOMPARE(stats.pages, 1);
+    QCOMPARE(stats.textures, 1);
+    QCOMPARE(stats.releasedPages, 0);
+}
+
+QTEST_MAIN(tst_qsgatlastexture)
+
+#include "tst_qsgatlastexture.moc"
@@ -13,6 +13,7 @@ qtHaveModule(widgets): PUBLICTESTS += nodes
 !qtHaveModule(concurrent): PUBLICTESTS -= qquickpixmapcache
 
 PRIVATETESTS += \
+    distancefielddiskcache \
     nokeywords \
     qquickanimations \
     qquickapplication \
@@ -29,7 +30,8 @@ PRIVATETESTS += \
     qquickstates \
     qquicksystempalette \
     qquicktimeline \
-    qquickxmllistmodel
+    qquickxmllistmodel \
+    qsgatlastexture
 
 # This test requires the xmlpatterns module
 !qtHaveModule(xmlpatterns): PRIVATETESTS -= qquickxmllistmodel
@@ -0,0 +1,76 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+import QtQuick 2.2
+
+/*
+    This test verifies that when one element of a merged opaque batch
+    is moved and another one is resized, only those elements are
+    updated in the batch's buffer and the others are left intact.
+
+    #samples: 12
+                 PixelPos     R    G    B    Error-tolerance
+    #base:        30  30     1.0  0.0  0.0       0.0
+    #base:        80  30     0.0  1.0  0.0       0.0
+    #base:        80 130     0.0  0.0  0.0       0.0
+    #base:       120  30     0.0  0.0  1.0       0.0
+    #base:       140  30     0.0  0.0  1.0       0.0
+    #base:       170  30     1.0  1.0  0.0       0.0
+    #final:       30  30     1.0  0.0  0.0       0.0
+    #final:       80  30     0.0  0.0  0.0       0.0
+    #final:       80 130     0.0  1.0  0.0       0.0
+    #final:      120  30     0.0  0.0  1.0       0.0
+    #final:      140  30     0.0  0.0  0.0       0.0
+    #final:      170  30     1.0  1.0  0.0       0.0
+*/
+
+RenderTestBase {
+    id: root
+
+    Rectangle {
+        anchors.fill: parent
+        color: "black"
+
+        Rectangle { x: 10; y: 10; width: 40; height: 40; color: "#ff0000" }
+        Rectangle { id: moved; x: 60; y: 10; width: 40; height: 40; color: "#00ff00" }
+        Rectangle { id: resized; x: 110; y: 10; width: 40; height: 40; color: "#0000ff" }
+        Rectangle { x: 160; y: 10; width: 30; height: 40; color: "#ffff00" }
+    }
+
+    onEnterFinalStage: {
+        moved.y = 110;
+        resized.width = 20;
+        root.finalStageComplete = true;
+    }
+}
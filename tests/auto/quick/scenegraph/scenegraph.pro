@@ -11,6 +11,8 @@ QT += core-private gui-private qml-private quick-private  testlib
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
 
 OTHER_FILES += \
+    data/damage_NestedRoot.qml \
+    data/damage_ShaderEffectSource.qml \
     data/render_OutOfFloatRange.qml \
     data/simple.qml \
     data/render_ImageFiltering.qml
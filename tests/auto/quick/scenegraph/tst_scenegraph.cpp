@@ -32,6 +32,7 @@
 ****************************************************************************/
 
 #include <qtest.h>
+#include <QSignalSpy>
 
 #include <QOffscreenSurface>
 #include <QOpenGLContext>
@@ -41,7 +42,9 @@
 #include <QtQml>
 
 #include <private/qopenglcontext_p.h>
+#include <private/qquickwindow_p.h>
 #include <private/qsgcontext_p.h>
+#include <private/qsgrenderer_p.h>
 #include <private/qsgrenderloop_p.h>
 
 #include "../../shared/util.h"
@@ -90,6 +93,42 @@ private:
     QColor m_color;
 };
 
+// Records the damage the renderer computed for each frame of a window.
+class DamageRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    DamageRecorder(QQuickWindow *window) : m_window(window) {
+        connect(window, SIGNAL(afterRendering()), this, SLOT(afterRendering()), Qt::DirectConnection);
+    }
+
+    int frameCount() const {
+        QMutexLocker locker(&m_mutex);
+        return m_damage.size();
+    }
+
+    // The union of the damage of all frames from \a frame on, in device pixels.
+    QRect damageSince(int frame) const {
+        QMutexLocker locker(&m_mutex);
+        QRect damage;
+        for (int i = frame; i < m_damage.size(); ++i)
+            damage |= m_damage.at(i);
+        return damage;
+    }
+
+public slots:
+    void afterRendering() {
+        QSGRenderer *renderer = QQuickWindowPrivate::get(m_window)->renderer;
+        QMutexLocker locker(&m_mutex);
+        m_damage << (renderer ? renderer->damageRect() : QRect());
+    }
+
+private:
+    QQuickWindow *m_window;
+    mutable QMutex m_mutex;
+    QList<QRect> m_damage;
+};
+
 class tst_SceneGraph : public QQmlDataTest
 {
     Q_OBJECT
@@ -108,6 +147,16 @@ private slots:
     void createTextureFromImage_data();
     void createTextureFromImage();
 
+    void softwareContextGrabRectangles();
+    void softwareContextGrabImage();
+    void softwareContextGrabText();
+    void softwareContextGrabOpacity();
+    void softwareContextGrabThenUpdate();
+
+    void damageMovedNestedRoot();
+    void damageUpdatedShaderEffectSource();
+    void damageUnchangedFrame();
+
 private:
     bool m_brokenMipmapSupport;
     QQuickView *createView(const QString &file, QWindow *parent = 0, int x = -1, int y = -1, int w = -1, int h = -1);
@@ -124,6 +173,10 @@ void tst_SceneGraph::initTestCase()
 
     QQmlDataTest::initTestCase();
 
+    // Child processes run a single test that does not need the OpenGL details.
+    if (QQmlTestChildProcess::isChildProcess())
+        return;
+
     QSGRenderLoop *loop = QSGRenderLoop::instance();
     qDebug() << "RenderLoop:        " << loop;
 
@@ -412,7 +465,8 @@ void tst_SceneGraph::render_data()
           << "render_StackingOrder.qml"
           << "render_ImageFiltering.qml"
           << "render_bug37422.qml"
-          << "render_OpacityThroughBatchRoot.qml";
+          << "render_OpacityThroughBatchRoot.qml"
+          << "render_PartialBatchUpdate.qml";
     if (!m_brokenMipmapSupport)
           files << "render_Mipmap.qml";
 
@@ -559,6 +613,221 @@ void tst_SceneGraph::createTextureFromImage()
     QCOMPARE(texture->hasAlphaChannel(), expectedAlpha);
 }
 
+// The scene graph adaptation is chosen when the first window is created, so
+// the software context is tested in child processes with QMLSCENE_DEVICE set.
+#define SOFTWARE_CONTEXT_TEST() \
+    do { \
+        QQML_TEST_IN_CHILD_PROCESS(QStringList() << QStringLiteral("QMLSCENE_DEVICE=softwarecontext")); \
+        if (!QSGRenderLoop::instance()->inherits("QSGSoftwareRenderLoop")) \
+            QSKIP("The softwarecontext scene graph adaptation is not available"); \
+    } while (false)
+
+static bool isGray(QRgb pixel, int value, int tolerance = 2)
+{
+    return qAbs(qRed(pixel) - value) <= tolerance
+            && qAbs(qGreen(pixel) - value) <= tolerance
+            && qAbs(qBlue(pixel) - value) <= tolerance;
+}
+
+void tst_SceneGraph::softwareContextGrabRectangles()
+{
+    SOFTWARE_CONTEXT_TEST();
+
+    QScopedPointer<QQuickView> view(createView("grab_Rectangles.qml"));
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+
+    QImage content = view->grabWindow();
+    QVERIFY(!content.isNull());
+    const qreal dpr = content.devicePixelRatio();
+    QCOMPARE(content.size(), QSize(100, 100) * dpr);
+    QCOMPARE(content.pixel(25 * dpr, 25 * dpr), qRgb(255, 0, 0));
+    QCOMPARE(content.pixel(75 * dpr, 75 * dpr), qRgb(0, 0, 255));
+    QCOMPARE(content.pixel(75 * dpr, 25 * dpr), qRgb(255, 255, 255));
+}
+
+void tst_SceneGraph::softwareContextGrabImage()
+{
+    SOFTWARE_CONTEXT_TEST();
+
+    QScopedPointer<QQuickView> view(createView("grab_Image.qml"));
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+
+    QImage content = view->grabWindow();
+    QVERIFY(!content.isNull());
+    const qreal dpr = content.devicePixelRatio();
+    QCOMPARE(content.pixel(25 * dpr, 25 * dpr), qRgb(0, 0, 0));
+    QCOMPARE(content.pixel(75 * dpr, 25 * dpr), qRgb(255, 255, 255));
+    QCOMPARE(content.pixel(50 * dpr, 75 * dpr), qRgb(255, 0, 0));
+}
+
+void tst_SceneGraph::softwareContextGrabText()
+{
+    SOFTWARE_CONTEXT_TEST();
+
+    QScopedPointer<QQuickView> view(createView("grab_Text.qml"));
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+
+    QImage content = view->grabWindow();
+    QVERIFY(!content.isNull());
+    content = content.convertToFormat(QImage::Format_RGB32);
+
+    int dark = 0;
+    for (int y = 0; y < content.height(); ++y) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(content.constScanLine(y));
+        for (int x = 0; x < content.width(); ++x) {
+            if (qGray(line[x]) < 128)
+                ++dark;
+        }
+    }
+    QVERIFY(dark > 0);
+}
+
+void tst_SceneGraph::softwareContextGrabOpacity()
+{
+    SOFTWARE_CONTEXT_TEST();
+
+    QScopedPointer<QQuickView> view(createView("grab_Opacity.qml"));
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+
+    QImage content = view->grabWindow();
+    QVERIFY(!content.isNull());
+    const qreal dpr = content.devicePixelRatio();
+    // Black at 0.5 and at 0.25 (nested opacities multiply) over white.
+    QVERIFY(isGray(content.pixel(25 * dpr, 25 * dpr), 128));
+    QVERIFY(isGray(content.pixel(75 * dpr, 25 * dpr), 191));
+    QCOMPARE(content.pixel(50 * dpr, 75 * dpr), qRgb(255, 255, 255));
+}
+
+// A grab syncs the scene but only renders into the grabbed image, so the
+// window has to be repainted afterwards, and later changes must show up in
+// both the window and later grabs.
+void tst_SceneGraph::softwareContextGrabThenUpdate()
+{
+    SOFTWARE_CONTEXT_TEST();
+
+    QScopedPointer<QQuickView> view(createView("grab_Rectangles.qml"));
+    QVERIFY(QTest::qWaitForWindowExposed(view.data()));
+    QSignalSpy swapSpy(view.data(), SIGNAL(frameSwapped()));
+    QTRY_VERIFY(swapSpy.count() > 0);
+
+    QQuickItem *changing = view->rootObject()->findChild<QQuickItem *>("changing");
+    QVERIFY(changing);
+    changing->setProperty("color", QColor(Qt::green));
+
+    // Grabbing does not present anything itself...
+    swapSpy.clear();
+    QImage content = view->grabWindow();
+    const qreal dpr = content.devicePixelRatio();
+    QCOMPARE(content.pixel(75 * dpr, 75 * dpr), qRgb(0, 255, 0));
+    QCOMPARE(swapSpy.count(), 0);
+
+    // ...but the window is repainted with what was grabbed.
+    QTRY_VERIFY(swapSpy.count() > 0);
+
+    swapSpy.clear();
+    changing->setProperty("color", QColor(Qt::yellow));
+    QTRY_VERIFY(swapSpy.count() > 0);
+
+    content = view->grabWindow();
+    QCOMPARE(content.pixel(75 * dpr, 75 * dpr), qRgb(255, 255, 0));
+    QCOMPARE(content.pixel(25 * dpr, 25 * dpr), qRgb(255, 0, 0));
+}
+
+static QRect scaledRect(const QRect &r, qreal scale)
+{
+    return QRect(qRound(r.x() * scale), qRound(r.y() * scale),
+                 qRound(r.width() * scale), qRound(r.height() * scale));
+}
+
+// The damage of a frame must cover where an element was rendered in the
+// previous frame, even when it moved because an ancestor of its batch root
+// moved.
+void tst_SceneGraph::damageMovedNestedRoot()
+{
+    QQuickView view;
+    DamageRecorder recorder(&view);
+    view.setSource(testFileUrl("damage_NestedRoot.qml"));
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+    QTRY_VERIFY(recorder.frameCount() > 0);
+
+    QQuickItem *mover = view.rootObject()->findChild<QQuickItem *>("mover");
+    QVERIFY(mover);
+
+    const int frame = recorder.frameCount();
+    mover->setX(100);
+    QTRY_VERIFY(recorder.frameCount() > frame);
+
+    const qreal dpr = view.effectiveDevicePixelRatio();
+    const QRect damage = recorder.damageSince(frame);
+    QVERIFY(damage.contains(scaledRect(QRect(0, 0, 50, 50), dpr)));
+    QVERIFY(damage.contains(scaledRect(QRect(100, 0, 50, 50), dpr)));
+
+    QImage content = view.grabWindow();
+    QCOMPARE(content.pixel(25 * dpr, 25 * dpr), qRgb(255, 255, 255));
+    QCOMPARE(content.pixel(125 * dpr, 25 * dpr), qRgb(255, 0, 0));
+}
+
+// A shader effect using a texture that was updated without the effect itself
+// changing must still be damaged.
+void tst_SceneGraph::damageUpdatedShaderEffectSource()
+{
+    QQuickView view;
+    DamageRecorder recorder(&view);
+    view.setSource(testFileUrl("damage_ShaderEffectSource.qml"));
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+    QTRY_VERIFY(recorder.frameCount() > 0);
+
+    QQuickItem *content = view.rootObject()->findChild<QQuickItem *>("content");
+    QVERIFY(content);
+    QQuickItem *source = view.rootObject()->findChild<QQuickItem *>("source");
+    QVERIFY(source);
+
+    const int frame = recorder.frameCount();
+    content->setProperty("color", QColor(Qt::blue));
+    QVERIFY(QMetaObject::invokeMethod(source, "scheduleUpdate"));
+    QTRY_VERIFY(recorder.frameCount() > frame);
+
+    const qreal dpr = view.effectiveDevicePixelRatio();
+    const QRect damage = recorder.damageSince(frame);
+    QVERIFY(damage.contains(scaledRect(QRect(100, 0, 50, 50), dpr)));
+
+    QImage image = view.grabWindow();
+    QCOMPARE(image.pixel(125 * dpr, 25 * dpr), qRgb(0, 0, 255));
+}
+
+// Frames without changes have no damage and the swap is skipped, but the
+// window keeps rendering the following frames correctly.
+void tst_SceneGraph::damageUnchangedFrame()
+{
+    QQuickView view;
+    DamageRecorder recorder(&view);
+    QSignalSpy swapSpy(&view, SIGNAL(frameSwapped()));
+    view.setSource(testFileUrl("damage_NestedRoot.qml"));
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+    QTRY_VERIFY(recorder.frameCount() > 0);
+
+    int frame = recorder.frameCount();
+    int swaps = swapSpy.count();
+    view.update();
+    QTRY_VERIFY(recorder.frameCount() > frame);
+    QTRY_VERIFY(swapSpy.count() > swaps);
+    QVERIFY(recorder.damageSince(recorder.frameCount() - 1).isEmpty());
+
+    QQuickItem *mover = view.rootObject()->findChild<QQuickItem *>("mover");
+    QVERIFY(mover);
+    frame = recorder.frameCount();
+    mover->setY(100);
+    QTRY_VERIFY(recorder.frameCount() > frame);
+    QVERIFY(!recorder.damageSince(frame).isEmpty());
+
+    const qreal dpr = view.effectiveDevicePixelRatio();
+    QImage content = view.grabWindow();
+    QCOMPARE(content.pixel(25 * dpr, 25 * dpr), qRgb(255, 255, 255));
+    QCOMPARE(content.pixel(25 * dpr, 125 * dpr), qRgb(255, 0, 0));
+}
 
 #include "tst_scenegraph.moc"
 
@@ -40,6 +40,7 @@
 #include <QtCore/QTextStream>
 #include <QtCore/QDebug>
 #include <QtCore/QMutexLocker>
+#include <QtCore/QProcess>
 
 QQmlDataTest *QQmlDataTest::m_instance = 0;
 
@@ -128,3 +129,44 @@ QQmlTestMessageHandler::~QQmlTestMessageHandler()
     qInstallMessageHandler(m_oldHandler);
     QQmlTestMessageHandler::m_instance = 0;
 }
+
+bool QQmlTestChildProcess::isChildProcess()
+{
+    return qEnvironmentVariableIsSet("QQML_TEST_CHILD_PROCESS");
+}
+
+void QQmlTestChildProcess::run(const QStringList &environment)
+{
+#ifdef QT_NO_PROCESS
+    Q_UNUSED(environment);
+    QSKIP("This test needs to start a child process");
+#else
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert(QStringLiteral("QQML_TEST_CHILD_PROCESS"), QStringLiteral("1"));
+    foreach (const QString &variable, environment) {
+        const int equals = variable.indexOf(QLatin1Char('='));
+        env.insert(variable.left(equals), variable.mid(equals + 1));
+    }
+
+    QString function = QString::fromLatin1(QTest::currentTestFunction());
+    if (QTest::currentDataTag())
+        function += QLatin1Char(':') + QString::fromLatin1(QTest::currentDataTag());
+
+    QProcess process;
+    process.setProcessEnvironment(env);
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start(QCoreApplication::applicationFilePath(), QStringList() << function);
+    QVERIFY2(process.waitForStarted(), qPrintable(process.errorString()));
+    QVERIFY2(process.waitForFinished(5 * 60 * 1000), qPrintable(process.errorString()));
+
+    const QString output = QString::fromLocal8Bit(process.readAll());
+    QVERIFY2(process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0,
+             qPrintable(environment.join(QLatin1Char(' ')) + QLatin1Char('\n') + output));
+
+    // Pass on a skip of the child, so that it does not count as a pass.
+    foreach (const QString &line, output.split(QLatin1Char('\n'))) {
+        if (line.startsWith(QLatin1String("SKIP")))
+            QSKIP(qPrintable(line.trimmed()));
+    }
+#endif
+}
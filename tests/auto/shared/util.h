@@ -100,4 +100,25 @@ private:
     QtMessageHandler m_oldHandler;
 };
 
+/* Settings like the scene graph adaptation or the render loop are read from
+   the environment once per process. A test function of such a setting starts
+   with QQML_TEST_IN_CHILD_PROCESS, which runs the function and data tag again
+   in a child process of the test with the given variables set and reports the
+   result of the child. */
+
+class QQmlTestChildProcess
+{
+public:
+    static bool isChildProcess();
+    static void run(const QStringList &environment);
+};
+
+#define QQML_TEST_IN_CHILD_PROCESS(environment) \
+    do { \
+        if (!QQmlTestChildProcess::isChildProcess()) { \
+            QQmlTestChildProcess::run(environment); \
+            return; \
+        } \
+    } while (false)
+
 #endif // QQMLTESTUTILS_H
@@ -58,6 +58,8 @@ private slots:
     void basicproperty();
     void creation_data();
     void creation();
+    void fanout_data();
+    void fanout();
 
 private:
     QQmlEngine engine;
@@ -176,5 +178,38 @@ void tst_binding::creation()
     }
 }
 
+void tst_binding::fanout_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<int>("subscribers");
+
+    QTest::newRow("1") << SRCDIR "/data/fanout.txt" << 1;
+    QTest::newRow("10") << SRCDIR "/data/fanout.txt" << 10;
+    QTest::newRow("100") << SRCDIR "/data/fanout.txt" << 100;
+    QTest::newRow("1000") << SRCDIR "/data/fanout.txt" << 1000;
+    QTest::newRow("10000") << SRCDIR "/data/fanout.txt" << 10000;
+}
+
+// Measures the cost of a single change notification as a function of the number
+// of bindings depending on the changed property.
+void tst_binding::fanout()
+{
+    QFETCH(QString, file);
+    QFETCH(int, subscribers);
+
+    const QString binding = QString::fromLatin1("    MyQmlObject { result: root.value }\n").repeated(subscribers);
+    COMPONENT(file, binding);
+
+    MyQmlObject *object = qobject_cast<MyQmlObject *>(c.create());
+    QVERIFY(object != 0);
+    object->setValue(10);
+
+    QBENCHMARK {
+        object->setValue(1);
+    }
+
+    delete object;
+}
+
 QTEST_MAIN(tst_binding)
 #include "tst_binding.moc"
@@ -6,6 +6,7 @@ SUBDIRS += \
            javascript \
            holistic \
            qqmlchangeset \
+           qqmllistcompositor \
            qqmlcomponent \
            qqmlmetaproperty \
            librarymetrics_performance \
@@ -13,6 +14,6 @@ SUBDIRS += \
            js \
            creation
 
-qtHaveModule(opengl): SUBDIRS += painting qquickwindow
+qtHaveModule(opengl): SUBDIRS += painting qquickwindow qsgbatchrenderer
 
 include(../trusted-benchmarks.pri)
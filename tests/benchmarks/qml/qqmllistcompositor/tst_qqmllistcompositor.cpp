@@ -0,0 +1,160 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+
+#include <private/qqmllistcompositor_p.h>
+
+typedef QQmlListCompositor C;
+
+static const C::Group Visible = C::Group(2);
+static const int VisibleFlag = 1 << Visible;
+static const C::Group Selection = C::Group(3);
+static const int SelectionFlag = 1 << Selection;
+
+class tst_qqmllistcompositor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void findSequential_data() { populateCounts(); }
+    void findSequential();
+    void findRandom_data() { populateCounts(); }
+    void findRandom();
+    void filterAndFind_data() { populateCounts(); }
+    void filterAndFind();
+    void changeAndFind_data() { populateCounts(); }
+    void changeAndFind();
+
+private:
+    void populateCounts();
+    static void fragment(C *compositor, int count);
+};
+
+void tst_qqmllistcompositor::populateCounts()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+/*
+    Removes every other item from the visible group, leaving one range per item.
+*/
+
+void tst_qqmllistcompositor::fragment(C *compositor, int count)
+{
+    static int list;
+
+    compositor->setGroupCount(4);
+    compositor->setDefaultGroups(VisibleFlag | C::DefaultFlag);
+    compositor->append(&list, 0, count, C::AppendFlag | C::PrependFlag | VisibleFlag | C::DefaultFlag);
+    for (int i = 1; i <= count / 2; ++i)
+        compositor->clearFlags(Visible, i, 1, VisibleFlag);
+}
+
+void tst_qqmllistcompositor::findSequential()
+{
+    QFETCH(int, count);
+
+    C compositor;
+    fragment(&compositor, count);
+
+    const int visibleCount = compositor.count(Visible);
+    QBENCHMARK {
+        for (int i = 0; i < visibleCount; ++i)
+            compositor.find(Visible, i);
+    }
+}
+
+void tst_qqmllistcompositor::findRandom()
+{
+    QFETCH(int, count);
+
+    C compositor;
+    fragment(&compositor, count);
+
+    // A fixed stride coprime to the count visits every index in a scattered order.
+    const int visibleCount = compositor.count(Visible);
+    const int stride = 7919;
+    QBENCHMARK {
+        int index = 0;
+        for (int i = 0; i < visibleCount; ++i) {
+            index = (index + stride) % visibleCount;
+            compositor.find(Visible, index);
+            compositor.find(C::Default, count - 1 - index);
+        }
+    }
+}
+
+void tst_qqmllistcompositor::filterAndFind()
+{
+    QFETCH(int, count);
+
+    QBENCHMARK {
+        C compositor;
+        fragment(&compositor, count);
+
+        const int visibleCount = compositor.count(Visible);
+        for (int i = 0; i < visibleCount; i += 2) {
+            compositor.find(Visible, visibleCount - 1 - i);
+            compositor.find(Visible, i);
+        }
+    }
+}
+
+void tst_qqmllistcompositor::changeAndFind()
+{
+    QFETCH(int, count);
+
+    C compositor;
+    fragment(&compositor, count);
+
+    // Select and deselect scattered items, looking up items distant from each change.
+    const int stride = 7919;
+    QBENCHMARK {
+        int index = 0;
+        for (int i = 0; i < count / 4; ++i) {
+            index = (index + stride) % count;
+            compositor.setFlags(C::Default, index, 1, SelectionFlag);
+            compositor.find(Visible, (index / 2 + count / 4) % (count / 2));
+            compositor.clearFlags(C::Default, index, 1, SelectionFlag);
+            compositor.find(C::Default, (index + count / 2) % count);
+        }
+    }
+}
+
+QTEST_MAIN(tst_qqmllistcompositor)
+#include "tst_qqmllistcompositor.moc"
@@ -0,0 +1,9 @@
+CONFIG += benchmark
+TEMPLATE = app
+TARGET = tst_qsgbatchrenderer
+QT += quick-private testlib
+osx:CONFIG -= app_bundle
+
+SOURCES += tst_qsgbatchrenderer.cpp
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
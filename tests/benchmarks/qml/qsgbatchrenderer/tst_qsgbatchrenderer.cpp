@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/private/qquickrectangle_p.h>
+
+#include <qtest.h>
+#include <QtTest/QtTest>
+
+class tst_qsgbatchrenderer : public QObject
+{
+    Q_OBJECT
+private slots:
+    void rebuildBatches_data();
+    void rebuildBatches();
+};
+
+void tst_qsgbatchrenderer::rebuildBatches_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("translucent");
+
+    const int counts[] = { 1000, 5000, 20000 };
+    for (int i = 0; i < 3; ++i) {
+        QTest::newRow(qPrintable(QString::fromLatin1("opaque %1").arg(counts[i]))) << counts[i] << false;
+        QTest::newRow(qPrintable(QString::fromLatin1("translucent %1").arg(counts[i]))) << counts[i] << true;
+    }
+}
+
+void tst_qsgbatchrenderer::rebuildBatches()
+{
+    QFETCH(int, count);
+    QFETCH(bool, translucent);
+
+    QQuickWindow window;
+    window.resize(400, 400);
+
+    // Interleave rectangles with plain and antialiased materials, so that
+    // consecutive elements in the render lists are never compatible, and let
+    // neighbours partially overlap.
+    for (int i = 0; i < count; ++i) {
+        QQuickRectangle *rectangle = new QQuickRectangle(window.contentItem());
+        rectangle->setPosition(QPointF((i * 7) % 392, (i / 56 * 3) % 392));
+        rectangle->setSize(QSizeF(8, 8));
+        rectangle->setAntialiasing(i % 2);
+        rectangle->setRadius(i % 2 ? 2 : 0);
+        rectangle->setColor(translucent ? QColor(255, i % 256, 0, 128) : QColor(255, i % 256, 0));
+    }
+
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    // A new node makes the renderer rebuild its render lists and all batches
+    // in the next frame, while the rectangles keep their opacity so that
+    // every frame batches the same opaque and translucent elements. Moving
+    // an item would only re-upload the vertices of its batch.
+    QQuickRectangle *marker = 0;
+    QBENCHMARK {
+        delete marker;
+        marker = new QQuickRectangle(window.contentItem());
+        marker->setSize(QSizeF(1, 1));
+        window.grabWindow();
+    }
+    delete marker;
+}
+
+QTEST_MAIN(tst_qsgbatchrenderer)
+
+#include "tst_qsgbatchrenderer.moc"